@@ -0,0 +1,88 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+namespace {
+
+double seconds(const std::function<void(std::uint64_t)>& body, std::uint64_t iterations) {
+    const auto start = std::chrono::steady_clock::now();
+    body(iterations);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void write_string(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (const char symbol : text) {
+        if (symbol == '"' || symbol == '\\') {
+            out << '\\';
+        }
+        out << symbol;
+    }
+    out << '"';
+}
+
+}  // namespace
+
+BenchmarkRunner::BenchmarkRunner(double min_seconds, std::string filter)
+    : min_seconds(min_seconds), filter(std::move(filter)) {}
+
+void BenchmarkRunner::run(const std::string& name, const BenchmarkParams& params,
+                          const std::function<void(std::uint64_t iterations)>& body) {
+    if (name.find(filter) == std::string::npos) {
+        return;
+    }
+    std::uint64_t iterations = 1;
+    double elapsed           = seconds(body, iterations);
+    while (elapsed < min_seconds && iterations < (std::uint64_t{1} << 40)) {
+        // Aims slightly past the target, so the next batch usually is the last one.
+        const double scale = elapsed > 0 ? 1.2 * min_seconds / elapsed : 10;
+        iterations         = std::max(iterations + 1, static_cast<std::uint64_t>(iterations * std::min(scale, 10.0)));
+        elapsed            = seconds(body, iterations);
+    }
+    double best = elapsed;
+    for (int repetition = 1; repetition < REPETITIONS; ++repetition) {
+        best = std::min(best, seconds(body, iterations));
+    }
+
+    BenchmarkResult result = {name, params, iterations, best * 1e9 / static_cast<double>(iterations)};
+    std::cerr << std::left << std::setw(28) << name;
+    for (const auto& [key, value] : params) {
+        std::cerr << ' ' << key << '=' << value;
+    }
+    std::cerr << "  " << result.ns_per_op << " ns\n";
+    measured.push_back(std::move(result));
+}
+
+const std::vector<BenchmarkResult>& BenchmarkRunner::results() const {
+    return measured;
+}
+
+void BenchmarkRunner::write_json(std::ostream& out) const {
+    out << std::setprecision(std::numeric_limits<double>::max_digits10);
+    out << "{\n  \"context\": {\"compiler\": ";
+#if defined(__VERSION__)
+    write_string(out, __VERSION__);
+#else
+    write_string(out, "unknown");
+#endif
+    out << ", \"build_type\": ";
+    write_string(out, BENCHMARK_BUILD_TYPE);
+    out << "},\n  \"benchmarks\": [";
+    for (std::size_t i = 0; i < measured.size(); ++i) {
+        const BenchmarkResult& result = measured[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+        write_string(out, result.name);
+        out << ", \"params\": {";
+        for (std::size_t k = 0; k < result.params.size(); ++k) {
+            out << (k == 0 ? "" : ", ");
+            write_string(out, result.params[k].first);
+            out << ": " << result.params[k].second;
+        }
+        out << "}, \"iterations\": " << result.iterations << ", \"ns_per_op\": " << result.ns_per_op << '}';
+    }
+    out << "\n  ]\n}\n";
+}
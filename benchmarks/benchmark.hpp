@@ -0,0 +1,54 @@
+#ifndef BENCHMARKS_BENCHMARK_HPP
+#define BENCHMARKS_BENCHMARK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Keeps the compiler from optimizing away a value that is never used.
+template <typename T>
+inline void keep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+using BenchmarkParams = std::vector<std::pair<std::string, std::int64_t>>;
+
+struct BenchmarkResult {
+    std::string name;
+    BenchmarkParams params;
+    std::uint64_t iterations;
+    double ns_per_op;
+};
+
+// Runs every benchmark in batches that grow until a batch takes min_seconds and reports
+// the fastest of several such batches, which is the least disturbed by other load.
+class BenchmarkRunner {
+public:
+    BenchmarkRunner(double min_seconds, std::string filter);
+
+    // body(iterations) has to run the measured operation iterations times.
+    void run(const std::string& name, const BenchmarkParams& params,
+             const std::function<void(std::uint64_t iterations)>& body);
+
+    const std::vector<BenchmarkResult>& results() const;
+
+    void write_json(std::ostream& out) const;
+
+private:
+    static constexpr int REPETITIONS = 5;
+
+    double min_seconds;
+    std::string filter;
+    std::vector<BenchmarkResult> measured;
+};
+
+#endif  // BENCHMARKS_BENCHMARK_HPP
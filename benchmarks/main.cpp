@@ -0,0 +1,443 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "complex/complex.hpp"
+#include "complex/complex_array.hpp"
+#include "complex/complex_matrix.hpp"
+#include "complex/fft.hpp"
+#include "complex/polynomial.hpp"
+#include "complex/thread_pool.hpp"
+#include "expressions/compiled_expression.hpp"
+#include "expressions/expressions.hpp"
+
+namespace {
+
+const int DEPTHS[]    = {2, 6, 10, 14};
+const int VARIABLES[] = {1, 8, 64};
+const int EXPONENTS[] = {8, 64};
+// Powers of two from 2^4 to 2^22, the naive DFT only runs up to NAIVE_DFT_MAX_SIZE.
+const int FFT_LOG_SIZES[]                = {4, 6, 8, 10, 12, 14, 16, 18, 20, 22};
+const int FFT_OTHER_SIZES[]              = {1000, 1009, 65537};
+constexpr std::size_t NAIVE_DFT_MAX_SIZE = 1 << 12;
+constexpr std::size_t FFT_BATCH_SIZE     = 1024;
+constexpr std::size_t FFT_BATCH_COUNT    = 256;
+const int POLYNOMIAL_DEGREES[]           = {4, 16, 64};
+const int ROOT_DEGREES[]                 = {100, 1000, 10000};
+constexpr std::size_t POLYNOMIAL_POINTS  = 1 << 20;
+// The naive matrix loops only run up to NAIVE_MATRIX_MAX_SIZE.
+const int MATRIX_SIZES[]                    = {64, 256, 512, 1024};
+const int MATRIX_VECTOR_SIZES[]             = {256, 1024, 4096};
+constexpr std::size_t NAIVE_MATRIX_MAX_SIZE = 512;
+
+std::string variable_name(int index) {
+    return "x" + std::to_string(index);
+}
+
+// Balanced tree of the given depth cycling through the binary operations, the leaves
+// alternate between constants and the variables.
+std::shared_ptr<Expression> make_tree(int depth, int variables, int& leaf) {
+    if (depth == 0) {
+        const int index = leaf++;
+        return index % 2 == 0 ? make_variable(variable_name(index / 2 % variables))
+                              : make_const(Complex(1 + index % 7, 0.5 - index % 3));
+    }
+    std::shared_ptr<Expression> left  = make_tree(depth - 1, variables, leaf);
+    std::shared_ptr<Expression> right = make_tree(depth - 1, variables, leaf);
+    switch (depth % 4) {
+    case 0:
+        return make_add(std::move(left), std::move(right));
+    case 1:
+        return make_multiply(std::move(left), std::move(right));
+    case 2:
+        return make_subtract(std::move(left), std::move(right));
+    default:
+        return make_divide(std::move(left), make_add(std::move(right), make_const(Complex(3, 1))));
+    }
+}
+
+std::shared_ptr<Expression> make_tree(int depth, int variables) {
+    int leaf = 0;
+    return make_tree(depth, variables, leaf);
+}
+
+std::unordered_map<std::string, Complex> make_values(int variables) {
+    std::unordered_map<std::string, Complex> values;
+    for (int i = 0; i < variables; ++i) {
+        values[variable_name(i)] = Complex(0.25 * i + 1, 1 - 0.125 * i);
+    }
+    return values;
+}
+
+void complex_benchmarks(BenchmarkRunner& runner) {
+    // Operands go through keep, so the operations are not folded at compile time.
+    Complex left(1.5, -2.25);
+    Complex right(0.75, 3.5);
+    const auto binary = [&](const std::string& name, auto operation) {
+        runner.run(name, {}, [&](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                keep(left);
+                keep(right);
+                keep(operation(left, right));
+            }
+        });
+    };
+    binary("complex/add", [](const Complex& a, const Complex& b) { return a + b; });
+    binary("complex/subtract", [](const Complex& a, const Complex& b) { return a - b; });
+    binary("complex/multiply", [](const Complex& a, const Complex& b) { return a * b; });
+    binary("complex/divide", [](const Complex& a, const Complex& b) { return a / b; });
+    binary("complex/abs", [](const Complex& a, const Complex&) { return a.abs(); });
+    binary("complex/str", [](const Complex& a, const Complex&) { return a.str(); });
+}
+
+void expression_benchmarks(BenchmarkRunner& runner) {
+    for (const int depth : DEPTHS) {
+        for (const int variables : VARIABLES) {
+            const BenchmarkParams params           = {{"depth", depth}, {"variables", variables}};
+            const std::shared_ptr<Expression> tree = make_tree(depth, variables);
+            const auto values                      = make_values(variables);
+
+            runner.run("expression/construct", params, [&](std::uint64_t iterations) {
+                for (std::uint64_t i = 0; i < iterations; ++i) {
+                    keep(make_tree(depth, variables));
+                }
+            });
+            runner.run("expression/clone", params, [&](std::uint64_t iterations) {
+                for (std::uint64_t i = 0; i < iterations; ++i) {
+                    const std::unique_ptr<Expression> copy(tree->clone());
+                    keep(copy);
+                }
+            });
+            runner.run("expression/str", params, [&](std::uint64_t iterations) {
+                for (std::uint64_t i = 0; i < iterations; ++i) {
+                    keep(tree->str());
+                }
+            });
+            runner.run("expression/eval", params, [&](std::uint64_t iterations) {
+                for (std::uint64_t i = 0; i < iterations; ++i) {
+                    keep(tree->eval(values));
+                }
+            });
+
+            VariableSlots slots;
+            std::vector<Complex> slot_values;
+            for (const auto& [name, value] : values) {
+                slots[name] = slot_values.size();
+                slot_values.push_back(value);
+            }
+            const CompiledExpression compiled(*tree, slots);
+            runner.run("expression/compiled_eval", params, [&](std::uint64_t iterations) {
+                for (std::uint64_t i = 0; i < iterations; ++i) {
+                    keep(compiled.eval(slot_values));
+                }
+            });
+        }
+    }
+}
+
+// x * x * ... * x as written with the operators against the equivalent Power node.
+void power_benchmarks(BenchmarkRunner& runner) {
+    const std::unordered_map<std::string, Complex> values = {{"x", Complex(0.999, 0.01)}};
+    for (const int exponent : EXPONENTS) {
+        const BenchmarkParams params = {{"exponent", exponent}};
+        std::vector<std::shared_ptr<Expression>> factors(exponent, make_variable("x"));
+        const std::shared_ptr<Expression> chain = make_product(factors);
+        const std::shared_ptr<Expression> power = make_power(make_variable("x"), exponent);
+
+        runner.run("expression/product_chain_eval", params, [&](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                keep(chain->eval(values));
+            }
+        });
+        runner.run("expression/power_eval", params, [&](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                keep(power->eval(values));
+            }
+        });
+    }
+}
+
+ComplexArray make_signal(std::size_t size) {
+    ComplexArray signal(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        signal.set(i, Complex(std::cos(0.001 * static_cast<double>(i)), std::sin(0.37 * static_cast<double>(i))));
+    }
+    return signal;
+}
+
+// X[k] = sum x[j] w^(j k) with a precomputed table of the roots w^t.
+void naive_dft(const ComplexArray& in, const std::vector<Complex>& roots, ComplexArray& out) {
+    const std::size_t n = in.size();
+    for (std::size_t k = 0; k < n; ++k) {
+        double sum_real   = 0;
+        double sum_imag   = 0;
+        std::size_t index = 0;
+        for (std::size_t j = 0; j < n; ++j) {
+            sum_real += in.real_data()[j] * roots[index].real() - in.imag_data()[j] * roots[index].imag();
+            sum_imag += in.imag_data()[j] * roots[index].real() + in.real_data()[j] * roots[index].imag();
+            index = index + k < n ? index + k : index + k - n;
+        }
+        out.set(k, Complex(sum_real, sum_imag));
+    }
+}
+
+void fft_benchmarks(BenchmarkRunner& runner) {
+    const auto transform = [&](std::size_t size) {
+        const BenchmarkParams params = {{"size", static_cast<std::int64_t>(size)}};
+        const ComplexArray signal    = make_signal(size);
+        ComplexArray spectrum(size);
+        std::vector<double> scratch;
+        runner.run("fft/forward", params, [&](std::uint64_t iterations) {
+            // Plans are built on first use, so that filtered out sizes cost nothing.
+            const std::shared_ptr<const FftPlan> plan = fft_plans().plan(size);
+            scratch.resize(plan->scratch_size());
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                plan->execute(signal.real_data(), signal.imag_data(), spectrum.real_data(), spectrum.imag_data(),
+                              FftDirection::Forward, scratch);
+                keep(spectrum.real_data()[0]);
+            }
+        });
+        if (size > NAIVE_DFT_MAX_SIZE) {
+            return;
+        }
+        std::vector<Complex> roots;
+        for (std::size_t t = 0; t < size; ++t) {
+            const double angle = -2 * std::acos(-1.0) * static_cast<double>(t) / static_cast<double>(size);
+            roots.emplace_back(std::cos(angle), std::sin(angle));
+        }
+        runner.run("fft/naive_dft", params, [&](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                naive_dft(signal, roots, spectrum);
+                keep(spectrum.real_data()[0]);
+            }
+        });
+    };
+    for (const int log_size : FFT_LOG_SIZES) {
+        transform(std::size_t(1) << log_size);
+    }
+    for (const int size : FFT_OTHER_SIZES) {
+        transform(static_cast<std::size_t>(size));
+    }
+
+    // Many transforms of one size, one after the other against spread over all cores.
+    const BenchmarkParams params = {{"size", FFT_BATCH_SIZE}, {"count", FFT_BATCH_COUNT}};
+    const ComplexArray signals   = make_signal(FFT_BATCH_SIZE * FFT_BATCH_COUNT);
+    ComplexArray spectra(FFT_BATCH_SIZE * FFT_BATCH_COUNT);
+    const FftPlan plan(FFT_BATCH_SIZE);
+    ThreadPool pool;
+    runner.run("fft/batch_serial", params, [&](std::uint64_t iterations) {
+        std::vector<double> scratch(plan.scratch_size());
+        for (std::uint64_t i = 0; i < iterations; ++i) {
+            for (std::size_t transform = 0; transform < FFT_BATCH_COUNT; ++transform) {
+                const std::size_t offset = transform * FFT_BATCH_SIZE;
+                plan.execute(signals.real_data() + offset, signals.imag_data() + offset, spectra.real_data() + offset,
+                             spectra.imag_data() + offset, FftDirection::Forward, scratch);
+            }
+            keep(spectra.real_data()[0]);
+        }
+    });
+    runner.run("fft/batch_parallel", params, [&](std::uint64_t iterations) {
+        for (std::uint64_t i = 0; i < iterations; ++i) {
+            plan.execute_batch(pool, signals, spectra);
+            keep(spectra.real_data()[0]);
+        }
+    });
+}
+
+// Coefficients of modulus at most 1 at pseudo-random angles.
+Polynomial make_polynomial(int degree) {
+    std::vector<Complex> coefficients;
+    for (int k = 0; k <= degree; ++k) {
+        coefficients.emplace_back(std::cos(1.7 * k), std::sin(0.3 * k * k));
+    }
+    return Polynomial(std::move(coefficients));
+}
+
+void polynomial_benchmarks(BenchmarkRunner& runner) {
+    // Points inside the unit disk, where high degrees neither overflow nor underflow quickly.
+    ComplexArray points(POLYNOMIAL_POINTS);
+    for (std::size_t i = 0; i < POLYNOMIAL_POINTS; ++i) {
+        const double radius = 0.999 * static_cast<double>(i) / static_cast<double>(POLYNOMIAL_POINTS);
+        const double angle  = static_cast<double>(i);
+        points.set(i, Complex(radius * std::cos(angle), radius * std::sin(angle)));
+    }
+    ComplexArray values(POLYNOMIAL_POINTS);
+    for (const int degree : POLYNOMIAL_DEGREES) {
+        const BenchmarkParams params = {{"degree", degree}, {"points", POLYNOMIAL_POINTS}};
+        const Polynomial polynomial  = make_polynomial(degree);
+        for (const PolynomialScheme scheme : {PolynomialScheme::Horner, PolynomialScheme::Estrin}) {
+            const std::string name = scheme == PolynomialScheme::Horner ? "polynomial/horner" : "polynomial/estrin";
+            runner.run(name, params, [&](std::uint64_t iterations) {
+                for (std::uint64_t i = 0; i < iterations; ++i) {
+                    polynomial.eval_planes(POLYNOMIAL_POINTS, points.real_data(), points.imag_data(),
+                                           values.real_data(), values.imag_data(), scheme);
+                    keep(values.real_data()[0]);
+                }
+            });
+        }
+    }
+
+    ThreadPool pool;
+    for (const int degree : ROOT_DEGREES) {
+        const Polynomial polynomial = make_polynomial(degree);
+        runner.run("polynomial/roots", {{"degree", degree}}, [&](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                keep(polynomial.roots(pool));
+            }
+        });
+    }
+}
+
+ComplexMatrix make_matrix(std::size_t rows, std::size_t columns) {
+    ComplexMatrix matrix(rows, columns);
+    for (std::size_t i = 0; i < rows; ++i) {
+        for (std::size_t j = 0; j < columns; ++j) {
+            const double index = static_cast<double>(i * columns + j);
+            matrix.set(i, j, Complex(std::sin(index), std::cos(0.5 * index)));
+        }
+    }
+    return matrix;
+}
+
+// The textbook loops over the complex elements.
+void naive_multiply(const ComplexMatrix& left, const ComplexMatrix& right, ComplexMatrix& result) {
+    for (std::size_t i = 0; i < left.rows(); ++i) {
+        for (std::size_t j = 0; j < right.columns(); ++j) {
+            Complex sum(0);
+            for (std::size_t p = 0; p < left.columns(); ++p) {
+                sum += left(i, p) * right(p, j);
+            }
+            result.set(i, j, sum);
+        }
+    }
+}
+
+void naive_multiply(const ComplexMatrix& matrix, const ComplexArray& vector, ComplexArray& result) {
+    for (std::size_t i = 0; i < matrix.rows(); ++i) {
+        Complex sum(0);
+        for (std::size_t j = 0; j < matrix.columns(); ++j) {
+            sum += matrix(i, j) * vector[j];
+        }
+        result.set(i, sum);
+    }
+}
+
+// The flops parameter is the number of real operations of one run, flops / ns_per_op is
+// the rate in GFLOP/s. Products count 8 per complex multiply-add, also for the 3M method.
+void matrix_benchmarks(BenchmarkRunner& runner) {
+    ThreadPool pool;
+    for (const int size : MATRIX_SIZES) {
+        const std::size_t n          = static_cast<std::size_t>(size);
+        const ComplexMatrix left     = make_matrix(n, n);
+        const ComplexMatrix right    = make_matrix(n, n);
+        const std::int64_t flops     = 8 * static_cast<std::int64_t>(n * n * n);
+        const BenchmarkParams params = {{"size", size}, {"flops", flops}};
+        runner.run("matrix/multiply", params, [&](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                keep(multiply(left, right).real_data()[0]);
+            }
+        });
+        runner.run("matrix/multiply_3m", params, [&](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                keep(multiply(left, right, MathAccuracy::Fast).real_data()[0]);
+            }
+        });
+        runner.run("matrix/multiply_parallel", params, [&](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                keep(multiply(pool, left, right).real_data()[0]);
+            }
+        });
+        if (n <= NAIVE_MATRIX_MAX_SIZE) {
+            ComplexMatrix result(n, n);
+            runner.run("matrix/naive_multiply", params, [&](std::uint64_t iterations) {
+                for (std::uint64_t i = 0; i < iterations; ++i) {
+                    naive_multiply(left, right, result);
+                    keep(result.real_data()[0]);
+                }
+            });
+        }
+
+        // Diagonally dominant, so that the pivots do not depend on rounding.
+        ComplexMatrix matrix = make_matrix(n, n);
+        for (std::size_t i = 0; i < n; ++i) {
+            matrix.set(i, i, Complex(static_cast<double>(2 * n)));
+        }
+        runner.run("matrix/lu", {{"size", size}, {"flops", flops / 3}}, [&](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                keep(LuDecomposition(matrix).determinant());
+            }
+        });
+    }
+
+    for (const int size : MATRIX_VECTOR_SIZES) {
+        const std::size_t n          = static_cast<std::size_t>(size);
+        const ComplexMatrix matrix   = make_matrix(n, n);
+        const ComplexArray vector    = ComplexArray(make_matrix(1, n).to_vector());
+        const BenchmarkParams params = {{"size", size}, {"flops", 8 * static_cast<std::int64_t>(n * n)}};
+        runner.run("matrix/multiply_vector", params, [&](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                keep(multiply(matrix, vector).real_data()[0]);
+            }
+        });
+        ComplexArray result(n);
+        runner.run("matrix/naive_multiply_vector", params, [&](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                naive_multiply(matrix, vector, result);
+                keep(result.real_data()[0]);
+            }
+        });
+    }
+}
+
+}  // namespace
+
+// Usage: benchmarks [--out results.json] [--filter name] [--min-time seconds]
+// Progress goes to stderr, the JSON results to stdout unless --out is given.
+int main(int argc, char** argv) {
+    std::string out_path;
+    std::string filter;
+    double min_seconds = 0.05;
+    for (int i = 1; i < argc; i += 2) {
+        const std::string_view option = argv[i];
+        if (option != "--out" && option != "--filter" && option != "--min-time") {
+            std::cerr << "unknown option " << option << '\n';
+            return 2;
+        }
+        if (i + 1 == argc) {
+            std::cerr << "missing value for option " << option << '\n';
+            return 2;
+        }
+        if (option == "--out") {
+            out_path = argv[i + 1];
+        } else if (option == "--filter") {
+            filter = argv[i + 1];
+        } else {
+            min_seconds = std::strtod(argv[i + 1], nullptr);
+        }
+    }
+
+    BenchmarkRunner runner(min_seconds, filter);
+    complex_benchmarks(runner);
+    expression_benchmarks(runner);
+    power_benchmarks(runner);
+    fft_benchmarks(runner);
+    polynomial_benchmarks(runner);
+    matrix_benchmarks(runner);
+
+    if (out_path.empty()) {
+        runner.write_json(std::cout);
+        return 0;
+    }
+    std::ofstream out(out_path);
+    runner.write_json(out);
+    return out ? 0 : 1;
+}
@@ -0,0 +1,334 @@
+#include "complex/complex_array.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "simd_kernel.hpp"
+
+namespace {
+
+template <typename T>
+void add_planes_impl(std::size_t n, const T* left_real, const T* left_imag, const T* right_real, const T* right_imag,
+                     T* real, T* imag) {
+    for (std::size_t i = 0; i < n; ++i) {
+        real[i] = left_real[i] + right_real[i];
+        imag[i] = left_imag[i] + right_imag[i];
+    }
+}
+
+template <typename T>
+void subtract_planes_impl(std::size_t n, const T* left_real, const T* left_imag, const T* right_real,
+                          const T* right_imag, T* real, T* imag) {
+    for (std::size_t i = 0; i < n; ++i) {
+        real[i] = left_real[i] + -right_real[i];
+        imag[i] = left_imag[i] + -right_imag[i];
+    }
+}
+
+template <typename T>
+void multiply_planes_impl(std::size_t n, const T* left_real, const T* left_imag, const T* right_real,
+                          const T* right_imag, T* real, T* imag) {
+    for (std::size_t i = 0; i < n; ++i) {
+        const T result_real = left_real[i] * right_real[i] - left_imag[i] * right_imag[i];
+        const T result_imag = left_imag[i] * right_real[i] + left_real[i] * right_imag[i];
+        real[i]             = result_real;
+        imag[i]             = result_imag;
+    }
+}
+
+// Both branches of BasicComplex::operator/= are written as selects so that the loop vectorizes.
+template <typename T>
+void divide_planes_impl(std::size_t n, const T* left_real, const T* left_imag, const T* right_real, const T* right_imag,
+                        T* real, T* imag) {
+    for (std::size_t i = 0; i < n; ++i) {
+        const bool real_major = std::abs(right_imag[i]) < std::abs(right_real[i]);
+        const T major         = real_major ? right_real[i] : right_imag[i];
+        const T minor         = real_major ? right_imag[i] : right_real[i];
+        const T ratio         = minor / major;
+        const T divisor       = major + minor * ratio;
+        const T result_real   = real_major ? (left_real[i] + left_imag[i] * ratio) / divisor
+                                           : (left_real[i] * ratio + left_imag[i]) / divisor;
+        const T result_imag   = real_major ? (left_imag[i] - left_real[i] * ratio) / divisor
+                                           : (left_imag[i] * ratio - left_real[i]) / divisor;
+        real[i]               = result_real;
+        imag[i]               = result_imag;
+    }
+}
+
+template <typename T>
+void negate_planes_impl(std::size_t n, const T* operand_real, const T* operand_imag, T* real, T* imag) {
+    for (std::size_t i = 0; i < n; ++i) {
+        real[i] = -operand_real[i];
+        imag[i] = -operand_imag[i];
+    }
+}
+
+template <typename T>
+void conjugate_planes_impl(std::size_t n, const T* operand_real, const T* operand_imag, T* real, T* imag) {
+    for (std::size_t i = 0; i < n; ++i) {
+        real[i] = operand_real[i];
+        imag[i] = -operand_imag[i];
+    }
+}
+
+template <typename T>
+void abs_planes_impl(std::size_t n, const T* operand_real, const T* operand_imag, T* abs) {
+    for (std::size_t i = 0; i < n; ++i) {
+        abs[i] = std::hypot(operand_real[i], operand_imag[i]);
+    }
+}
+
+}  // namespace
+
+COMPLEX_SIMD_KERNEL
+void add_planes(std::size_t n, const float* left_real, const float* left_imag, const float* right_real,
+                const float* right_imag, float* real, float* imag) {
+    add_planes_impl(n, left_real, left_imag, right_real, right_imag, real, imag);
+}
+
+COMPLEX_SIMD_KERNEL
+void add_planes(std::size_t n, const double* left_real, const double* left_imag, const double* right_real,
+                const double* right_imag, double* real, double* imag) {
+    add_planes_impl(n, left_real, left_imag, right_real, right_imag, real, imag);
+}
+
+void add_planes(std::size_t n, const long double* left_real, const long double* left_imag,
+                const long double* right_real, const long double* right_imag, long double* real, long double* imag) {
+    add_planes_impl(n, left_real, left_imag, right_real, right_imag, real, imag);
+}
+
+COMPLEX_SIMD_KERNEL
+void subtract_planes(std::size_t n, const float* left_real, const float* left_imag, const float* right_real,
+                     const float* right_imag, float* real, float* imag) {
+    subtract_planes_impl(n, left_real, left_imag, right_real, right_imag, real, imag);
+}
+
+COMPLEX_SIMD_KERNEL
+void subtract_planes(std::size_t n, const double* left_real, const double* left_imag, const double* right_real,
+                     const double* right_imag, double* real, double* imag) {
+    subtract_planes_impl(n, left_real, left_imag, right_real, right_imag, real, imag);
+}
+
+void subtract_planes(std::size_t n, const long double* left_real, const long double* left_imag,
+                     const long double* right_real, const long double* right_imag, long double* real,
+                     long double* imag) {
+    subtract_planes_impl(n, left_real, left_imag, right_real, right_imag, real, imag);
+}
+
+COMPLEX_SIMD_KERNEL
+void multiply_planes(std::size_t n, const float* left_real, const float* left_imag, const float* right_real,
+                     const float* right_imag, float* real, float* imag) {
+    multiply_planes_impl(n, left_real, left_imag, right_real, right_imag, real, imag);
+}
+
+COMPLEX_SIMD_KERNEL
+void multiply_planes(std::size_t n, const double* left_real, const double* left_imag, const double* right_real,
+                     const double* right_imag, double* real, double* imag) {
+    multiply_planes_impl(n, left_real, left_imag, right_real, right_imag, real, imag);
+}
+
+void multiply_planes(std::size_t n, const long double* left_real, const long double* left_imag,
+                     const long double* right_real, const long double* right_imag, long double* real,
+                     long double* imag) {
+    multiply_planes_impl(n, left_real, left_imag, right_real, right_imag, real, imag);
+}
+
+COMPLEX_SIMD_KERNEL
+void divide_planes(std::size_t n, const float* left_real, const float* left_imag, const float* right_real,
+                   const float* right_imag, float* real, float* imag) {
+    divide_planes_impl(n, left_real, left_imag, right_real, right_imag, real, imag);
+}
+
+COMPLEX_SIMD_KERNEL
+void divide_planes(std::size_t n, const double* left_real, const double* left_imag, const double* right_real,
+                   const double* right_imag, double* real, double* imag) {
+    divide_planes_impl(n, left_real, left_imag, right_real, right_imag, real, imag);
+}
+
+void divide_planes(std::size_t n, const long double* left_real, const long double* left_imag,
+                   const long double* right_real, const long double* right_imag, long double* real, long double* imag) {
+    divide_planes_impl(n, left_real, left_imag, right_real, right_imag, real, imag);
+}
+
+COMPLEX_SIMD_KERNEL
+void negate_planes(std::size_t n, const float* operand_real, const float* operand_imag, float* real, float* imag) {
+    negate_planes_impl(n, operand_real, operand_imag, real, imag);
+}
+
+COMPLEX_SIMD_KERNEL
+void negate_planes(std::size_t n, const double* operand_real, const double* operand_imag, double* real, double* imag) {
+    negate_planes_impl(n, operand_real, operand_imag, real, imag);
+}
+
+void negate_planes(std::size_t n, const long double* operand_real, const long double* operand_imag, long double* real,
+                   long double* imag) {
+    negate_planes_impl(n, operand_real, operand_imag, real, imag);
+}
+
+COMPLEX_SIMD_KERNEL
+void conjugate_planes(std::size_t n, const float* operand_real, const float* operand_imag, float* real, float* imag) {
+    conjugate_planes_impl(n, operand_real, operand_imag, real, imag);
+}
+
+COMPLEX_SIMD_KERNEL
+void conjugate_planes(std::size_t n, const double* operand_real, const double* operand_imag, double* real,
+                      double* imag) {
+    conjugate_planes_impl(n, operand_real, operand_imag, real, imag);
+}
+
+void conjugate_planes(std::size_t n, const long double* operand_real, const long double* operand_imag,
+                      long double* real, long double* imag) {
+    conjugate_planes_impl(n, operand_real, operand_imag, real, imag);
+}
+
+void abs_planes(std::size_t n, const float* operand_real, const float* operand_imag, float* abs) {
+    abs_planes_impl(n, operand_real, operand_imag, abs);
+}
+
+void abs_planes(std::size_t n, const double* operand_real, const double* operand_imag, double* abs) {
+    abs_planes_impl(n, operand_real, operand_imag, abs);
+}
+
+void abs_planes(std::size_t n, const long double* operand_real, const long double* operand_imag, long double* abs) {
+    abs_planes_impl(n, operand_real, operand_imag, abs);
+}
+
+void ComplexArray::AlignedDelete::operator()(double* data) const {
+    ::operator delete[](data, std::align_val_t(ALIGNMENT));
+}
+
+ComplexArray::Plane ComplexArray::allocate(std::size_t size) {
+    if (size == 0) {
+        return nullptr;
+    }
+    return Plane(static_cast<double*>(::operator new[](size * sizeof(double), std::align_val_t(ALIGNMENT))));
+}
+
+ComplexArray::ComplexArray(std::size_t size) : length(size), real_plane(allocate(size)), imag_plane(allocate(size)) {
+    std::fill_n(real_plane.get(), length, 0.0);
+    std::fill_n(imag_plane.get(), length, 0.0);
+}
+
+ComplexArray::ComplexArray(std::span<const Complex> values)
+    : length(values.size()), real_plane(allocate(values.size())), imag_plane(allocate(values.size())) {
+    for (std::size_t i = 0; i < length; ++i) {
+        real_plane[i] = values[i].real();
+        imag_plane[i] = values[i].imag();
+    }
+}
+
+ComplexArray::ComplexArray(const ComplexArray& array)
+    : length(array.length), real_plane(allocate(array.length)), imag_plane(allocate(array.length)) {
+    std::copy_n(array.real_plane.get(), length, real_plane.get());
+    std::copy_n(array.imag_plane.get(), length, imag_plane.get());
+}
+
+ComplexArray& ComplexArray::operator=(const ComplexArray& array) {
+    if (this != &array) {
+        *this = ComplexArray(array);
+    }
+    return *this;
+}
+
+std::size_t ComplexArray::size() const {
+    return length;
+}
+
+Complex ComplexArray::operator[](std::size_t index) const {
+    return Complex(real_plane[index], imag_plane[index]);
+}
+
+void ComplexArray::set(std::size_t index, const Complex& value) {
+    real_plane[index] = value.real();
+    imag_plane[index] = value.imag();
+}
+
+double* ComplexArray::real_data() {
+    return real_plane.get();
+}
+
+const double* ComplexArray::real_data() const {
+    return real_plane.get();
+}
+
+double* ComplexArray::imag_data() {
+    return imag_plane.get();
+}
+
+const double* ComplexArray::imag_data() const {
+    return imag_plane.get();
+}
+
+std::vector<Complex> ComplexArray::to_vector() const {
+    std::vector<Complex> values;
+    values.reserve(length);
+    for (std::size_t i = 0; i < length; ++i) {
+        values.emplace_back(real_plane[i], imag_plane[i]);
+    }
+    return values;
+}
+
+std::vector<double> ComplexArray::abs() const {
+    std::vector<double> result(length);
+    abs_planes(length, real_data(), imag_data(), result.data());
+    return result;
+}
+
+ComplexArray ComplexArray::operator-() const {
+    ComplexArray result(length);
+    negate_planes(length, real_data(), imag_data(), result.real_data(), result.imag_data());
+    return result;
+}
+
+ComplexArray ComplexArray::operator~() const {
+    ComplexArray result(length);
+    conjugate_planes(length, real_data(), imag_data(), result.real_data(), result.imag_data());
+    return result;
+}
+
+static void check_sizes(const ComplexArray& left, const ComplexArray& right) {
+    if (left.size() != right.size()) {
+        throw std::invalid_argument("complex arrays have different sizes");
+    }
+}
+
+ComplexArray& ComplexArray::operator+=(const ComplexArray& array) {
+    check_sizes(*this, array);
+    add_planes(length, real_data(), imag_data(), array.real_data(), array.imag_data(), real_data(), imag_data());
+    return *this;
+}
+
+ComplexArray& ComplexArray::operator-=(const ComplexArray& array) {
+    check_sizes(*this, array);
+    subtract_planes(length, real_data(), imag_data(), array.real_data(), array.imag_data(), real_data(), imag_data());
+    return *this;
+}
+
+ComplexArray& ComplexArray::operator*=(const ComplexArray& array) {
+    check_sizes(*this, array);
+    multiply_planes(length, real_data(), imag_data(), array.real_data(), array.imag_data(), real_data(), imag_data());
+    return *this;
+}
+
+ComplexArray& ComplexArray::operator/=(const ComplexArray& array) {
+    check_sizes(*this, array);
+    divide_planes(length, real_data(), imag_data(), array.real_data(), array.imag_data(), real_data(), imag_data());
+    return *this;
+}
+
+ComplexArray operator+(const ComplexArray& left, const ComplexArray& right) {
+    return ComplexArray(left) += right;
+}
+
+ComplexArray operator-(const ComplexArray& left, const ComplexArray& right) {
+    return ComplexArray(left) -= right;
+}
+
+ComplexArray operator*(const ComplexArray& left, const ComplexArray& right) {
+    return ComplexArray(left) *= right;
+}
+
+ComplexArray operator/(const ComplexArray& left, const ComplexArray& right) {
+    return ComplexArray(left) /= right;
+}
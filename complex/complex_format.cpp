@@ -0,0 +1,59 @@
+#include "complex/complex_format.hpp"
+
+#include <stdexcept>
+
+namespace {
+
+template <typename Values>
+void format_values(const Values& values, std::size_t size, std::string& out) {
+    // Every value gets the worst case space up front, the unused tail is cut off at the end.
+    std::size_t length = out.size();
+    out.resize(length + size * (COMPLEX_CHARS_MAX<double> + 1));
+    char* const last = out.data() + out.size();
+    for (std::size_t i = 0; i < size; ++i) {
+        char* end = to_chars(out.data() + length, last, values[i]).ptr;
+        *end++    = '\n';
+        length    = end - out.data();
+    }
+    out.resize(length);
+}
+
+bool is_space(char symbol) {
+    return symbol == ' ' || symbol == '\n' || symbol == '\t' || symbol == '\r';
+}
+
+}  // namespace
+
+void format_complex(std::span<const Complex> values, std::string& out) {
+    format_values(values, values.size(), out);
+}
+
+void format_complex(const ComplexArray& values, std::string& out) {
+    format_values(values, values.size(), out);
+}
+
+std::vector<Complex> parse_complex(std::string_view text) {
+    std::vector<Complex> values;
+    const char* position = text.data();
+    const char* last     = text.data() + text.size();
+    while (true) {
+        while (position != last && is_space(*position)) {
+            ++position;
+        }
+        if (position == last) {
+            return values;
+        }
+        Complex value;
+        const std::from_chars_result result = from_chars(position, last, value);
+        if (result.ec != std::errc()) {
+            throw std::invalid_argument("malformed complex number at position " +
+                                        std::to_string(position - text.data()));
+        }
+        values.push_back(value);
+        position = result.ptr;
+    }
+}
+
+ComplexArray parse_complex_array(std::string_view text) {
+    return ComplexArray(parse_complex(text));
+}
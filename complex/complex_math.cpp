@@ -0,0 +1,610 @@
+#include "complex/complex_math.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+#include "simd_kernel.hpp"
+
+namespace {
+
+// Elements are handled in blocks, so that the scratch space of the fallback and of the
+// float conversions stays on the stack.
+constexpr std::size_t BLOCK = 256;
+
+constexpr double SHIFTER     = 0x1.8p52;
+constexpr double INV_LN2     = 1.44269504088896338700e+00;
+constexpr double LN2_HI      = 6.93147180369123816490e-01;
+constexpr double LN2_LO      = 1.90821492927058770002e-10;
+constexpr double TWO_OVER_PI = 6.36619772367581382433e-01;
+constexpr double SQRT2       = 1.41421356237309514547e+00;
+constexpr double SQRT3       = 1.73205080756887719318e+00;
+constexpr double PI          = 3.14159265358979311600e+00;
+constexpr double PI_2        = 1.57079632679489655800e+00;
+constexpr double PI_6        = 5.23598775598298815658e-01;
+constexpr double TAN_PI_12   = 2.67949192431122695700e-01;
+
+// Cody-Waite splitting of pi / 2 from fdlibm, the leading parts have 33 significant
+// bits so that their products with a quadrant below 2^20 are exact.
+constexpr double PIO2_1  = 1.57079632673412561417e+00;
+constexpr double PIO2_2  = 6.07710050630396597660e-11;
+constexpr double PIO2_2T = 2.02226624879595063154e-21;
+constexpr double PIO2_3  = 2.02226624871116645580e-21;
+constexpr double PIO2_3T = 8.47842766036889956997e-32;
+
+// Bounds of the fast tier, see complex_math.hpp.
+constexpr double EXP_MAX  = 708;
+constexpr double TRIG_MAX = 1e6;
+constexpr double NORM_MIN = 1e-150;
+constexpr double NORM_MAX = 1e150;
+
+// Horner scheme for coefficients in increasing order, unrolled at compile time so that
+// the kernels have no inner loops.
+template <std::size_t I = 0, std::size_t N>
+inline double polynomial(double x, const std::array<double, N>& coefficients) {
+    if constexpr (I + 1 == N) {
+        return coefficients[I];
+    } else {
+        return coefficients[I] + x * polynomial<I + 1>(x, coefficients);
+    }
+}
+
+constexpr double factorial(int n) {
+    return n <= 1 ? 1.0 : n * factorial(n - 1);
+}
+
+// Taylor coefficients 1 / 2!, ..., 1 / 13!: the reduced argument stays within ln 2 / 2.
+constexpr std::array<double, 12> EXP_COEFFICIENTS = {
+    1 / factorial(2), 1 / factorial(3), 1 / factorial(4),  1 / factorial(5),  1 / factorial(6),  1 / factorial(7),
+    1 / factorial(8), 1 / factorial(9), 1 / factorial(10), 1 / factorial(11), 1 / factorial(12), 1 / factorial(13)};
+
+// sin(r) = r + r^3 * S(r^2) and cos(r) = 1 - r^2 / 2 + r^4 * C(r^2) for |r| <= pi / 4.
+constexpr std::array<double, 8> SIN_COEFFICIENTS = {-1 / factorial(3),  1 / factorial(5),  -1 / factorial(7),
+                                                    1 / factorial(9),   -1 / factorial(11), 1 / factorial(13),
+                                                    -1 / factorial(15), 1 / factorial(17)};
+constexpr std::array<double, 7> COS_COEFFICIENTS = {1 / factorial(4),  -1 / factorial(6),  1 / factorial(8),
+                                                    -1 / factorial(10), 1 / factorial(12), -1 / factorial(14),
+                                                    1 / factorial(16)};
+
+// sinh(y) = y + y^3 * P(y^2) for |y| < 1.
+constexpr std::array<double, 9> SINH_COEFFICIENTS = {1 / factorial(3),  1 / factorial(5),  1 / factorial(7),
+                                                     1 / factorial(9),  1 / factorial(11), 1 / factorial(13),
+                                                     1 / factorial(15), 1 / factorial(17), 1 / factorial(19)};
+
+// log(m) = 2 * atanh(f) = 2f + 2f^3 * L(f^2) with |f| <= 3 - 2 sqrt(2).
+constexpr std::array<double, 11> LOG_COEFFICIENTS = {2.0 / 3,  2.0 / 5,  2.0 / 7,  2.0 / 9,  2.0 / 11, 2.0 / 13,
+                                                     2.0 / 15, 2.0 / 17, 2.0 / 19, 2.0 / 21, 2.0 / 23};
+
+// atan(u) = u + u^3 * A(u^2) with |u| <= tan(pi / 12).
+constexpr std::array<double, 13> ATAN_COEFFICIENTS = {-1.0 / 3,  1.0 / 5,   -1.0 / 7,  1.0 / 9,  -1.0 / 11,
+                                                      1.0 / 13,  -1.0 / 15, 1.0 / 17,  -1.0 / 19, 1.0 / 21,
+                                                      -1.0 / 23, 1.0 / 25,  -1.0 / 27};
+
+// e^x for |x| <= 708: x = k ln 2 + r, e^x = 2^k e^r with 2^k built from its bit pattern.
+inline double fast_exp(double x) {
+    const double shifted = x * INV_LN2 + SHIFTER;
+    const double k       = shifted - SHIFTER;
+    const double r       = (x - k * LN2_HI) - k * LN2_LO;
+    const double value   = 1 + r + r * r * polynomial(r, EXP_COEFFICIENTS);
+    // The low mantissa bits of the shifted value hold k in two's complement.
+    const std::uint64_t exponent = (std::bit_cast<std::uint64_t>(shifted) + 1023) << 52;
+    return value * std::bit_cast<double>(exponent);
+}
+
+// sin(x) and cos(x) for |x| <= 1e6, reduced to |r| <= pi / 4 around the nearest multiple
+// of pi / 2 with the three step reduction of fdlibm.
+inline void fast_sincos(double x, double& sin, double& cos) {
+    const double shifted = x * TWO_OVER_PI + SHIFTER;
+    const double n       = shifted - SHIFTER;
+
+    double r = x - n * PIO2_1;
+    double t = r;
+    double w = n * PIO2_2;
+    r        = t - w;
+    w        = n * PIO2_2T - ((t - r) - w);
+    t        = r;
+    w        = n * PIO2_3;
+    r        = t - w;
+    w        = n * PIO2_3T - ((t - r) - w);
+
+    const double head = r - w;
+    const double tail = (r - head) - w;
+    const double r2   = head * head;
+    // sin(head + tail) ~ sin(head) + tail and cos(head + tail) ~ cos(head) - head * tail.
+    const double s = head + (head * r2 * polynomial(r2, SIN_COEFFICIENTS) + tail);
+    const double c = 1 - 0.5 * r2 + (r2 * r2 * polynomial(r2, COS_COEFFICIENTS) - head * tail);
+
+    const std::uint64_t quadrant = std::bit_cast<std::uint64_t>(shifted) & 3;
+    const double sin_base        = (quadrant & 1) != 0 ? c : s;
+    const double cos_base        = (quadrant & 1) != 0 ? s : c;
+    const double negated_sin     = -sin_base;
+    const double negated_cos     = -cos_base;
+    sin                          = (quadrant & 2) != 0 ? negated_sin : sin_base;
+    cos                          = ((quadrant + 1) & 2) != 0 ? negated_cos : cos_base;
+}
+
+// sinh(y) and cosh(y) for |y| <= 708, the series avoids the cancellation of the exponentials near 0.
+inline void fast_sinhcosh(double y, double& sinh, double& cosh) {
+    const double exponential = fast_exp(std::abs(y));
+    const double inverse     = 1 / exponential;
+    const double y2          = y * y;
+    const double series      = y + y * y2 * polynomial(y2, SINH_COEFFICIENTS);
+    const double difference  = std::copysign(0.5 * (exponential - inverse), y);
+    sinh                     = std::abs(y) < 1 ? series : difference;
+    cosh                     = 0.5 * (exponential + inverse);
+}
+
+// log(x) for a positive normal x = 2^e * m with m in [sqrt(2) / 2, sqrt(2)).
+inline double fast_log(double x) {
+    const std::uint64_t bits = std::bit_cast<std::uint64_t>(x);
+    // Exponent field converted to double through the bit pattern of 2^52 + field.
+    const double field    = std::bit_cast<double>((bits >> 52) | 0x4330000000000000) - 0x1p52;
+    const double mantissa = std::bit_cast<double>((bits & 0x000fffffffffffff) | 0x3ff0000000000000);
+    const double half     = 0.5 * mantissa;
+    const double exponent = field - 1023;
+    const double next     = field - 1022;
+    const bool large      = mantissa > SQRT2;
+    const double m        = large ? half : mantissa;
+    const double e        = large ? next : exponent;
+    const double f        = (m - 1) / (m + 1);
+    const double f2       = f * f;
+    const double log_m    = 2 * f + f * f2 * polynomial(f2, LOG_COEFFICIENTS);
+    return e * LN2_HI + (e * LN2_LO + log_m);
+}
+
+// atan2(y, x) for (x, y) != 0, reduced to [0, pi / 4] by octant and then to |u| <= tan(pi / 12)
+// with atan(t) = pi / 6 + atan((sqrt(3) t - 1) / (sqrt(3) + t)).
+inline double fast_atan2(double y, double x) {
+    const double ax         = std::abs(x);
+    const double ay         = std::abs(y);
+    const bool swapped      = ay > ax;
+    const double t          = (swapped ? ax : ay) / (swapped ? ay : ax);
+    const double reduced    = (SQRT3 * t - 1) / (SQRT3 + t);
+    const bool shifted      = t > TAN_PI_12;
+    const double u          = shifted ? reduced : t;
+    const double u2         = u * u;
+    const double atan_u     = u + u * u2 * polynomial(u2, ATAN_COEFFICIENTS);
+    const double atan_t     = shifted ? PI_6 + atan_u : atan_u;
+    const double complement = PI_2 - atan_t;
+    const double quarter    = swapped ? complement : atan_t;
+    const double mirrored   = PI - quarter;
+    return std::copysign(x < 0 ? mirrored : quarter, y);
+}
+
+bool in_exp_domain(double real, double imag) {
+    return std::abs(real) <= EXP_MAX && std::abs(imag) <= TRIG_MAX;
+}
+
+bool in_trig_domain(double real, double imag) {
+    return std::abs(real) <= TRIG_MAX && std::abs(imag) <= EXP_MAX;
+}
+
+bool in_norm_domain(double real, double imag) {
+    const double norm = std::max(std::abs(real), std::abs(imag));
+    return norm >= NORM_MIN && norm <= NORM_MAX;
+}
+
+COMPLEX_SIMD_KERNEL
+void fast_exp_kernel(std::size_t n, const double* operand_real, const double* operand_imag, double* real,
+                     double* imag) {
+    for (std::size_t i = 0; i < n; ++i) {
+        double sin = 0;
+        double cos = 0;
+        fast_sincos(operand_imag[i], sin, cos);
+        const double magnitude = fast_exp(operand_real[i]);
+        real[i]                = magnitude * cos;
+        imag[i]                = magnitude * sin;
+    }
+}
+
+COMPLEX_SIMD_KERNEL
+void fast_log_kernel(std::size_t n, const double* operand_real, const double* operand_imag, double* real,
+                     double* imag) {
+    for (std::size_t i = 0; i < n; ++i) {
+        const double x     = operand_real[i];
+        const double y     = operand_imag[i];
+        const double angle = fast_atan2(y, x);
+        real[i]            = 0.5 * fast_log(x * x + y * y);
+        imag[i]            = angle;
+    }
+}
+
+// Kahan's formula like the scalar sqrt, with both branches written as selects.
+COMPLEX_SIMD_KERNEL
+void fast_sqrt_kernel(std::size_t n, const double* operand_real, const double* operand_imag, double* real,
+                      double* imag) {
+    for (std::size_t i = 0; i < n; ++i) {
+        const double x      = operand_real[i];
+        const double y      = operand_imag[i];
+        const double root   = std::sqrt((std::abs(x) + std::sqrt(x * x + y * y)) / 2);
+        const double other  = y / (2 * root);
+        const bool positive = x >= 0;
+        real[i]             = positive ? root : std::abs(other);
+        imag[i]             = positive ? other : std::copysign(root, y);
+    }
+}
+
+COMPLEX_SIMD_KERNEL
+void fast_sin_kernel(std::size_t n, const double* operand_real, const double* operand_imag, double* real,
+                     double* imag) {
+    for (std::size_t i = 0; i < n; ++i) {
+        double sin  = 0;
+        double cos  = 0;
+        double sinh = 0;
+        double cosh = 0;
+        fast_sincos(operand_real[i], sin, cos);
+        fast_sinhcosh(operand_imag[i], sinh, cosh);
+        real[i] = sin * cosh;
+        imag[i] = cos * sinh;
+    }
+}
+
+COMPLEX_SIMD_KERNEL
+void fast_cos_kernel(std::size_t n, const double* operand_real, const double* operand_imag, double* real,
+                     double* imag) {
+    for (std::size_t i = 0; i < n; ++i) {
+        double sin  = 0;
+        double cos  = 0;
+        double sinh = 0;
+        double cosh = 0;
+        fast_sincos(operand_real[i], sin, cos);
+        fast_sinhcosh(operand_imag[i], sinh, cosh);
+        real[i] = cos * cosh;
+        imag[i] = -(sin * sinh);
+    }
+}
+
+using Kernel = void (*)(std::size_t, const double*, const double*, double*, double*);
+
+// Runs the kernel on a block and recomputes the elements outside of its domain with the
+// accurate scalar function. Those are saved first because the output may alias the operand.
+template <typename InDomain, typename Function>
+void fast_planes(std::size_t n, const double* operand_real, const double* operand_imag, double* real, double* imag,
+                 InDomain in_domain, Kernel kernel, Function function) {
+    std::array<std::size_t, BLOCK> outside;
+    std::array<Complex, BLOCK> saved;
+    for (std::size_t start = 0; start < n; start += BLOCK) {
+        const std::size_t count   = std::min(BLOCK, n - start);
+        std::size_t outside_count = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            if (!in_domain(operand_real[start + i], operand_imag[start + i])) {
+                outside[outside_count] = start + i;
+                saved[outside_count]   = Complex(operand_real[start + i], operand_imag[start + i]);
+                ++outside_count;
+            }
+        }
+        kernel(count, operand_real + start, operand_imag + start, real + start, imag + start);
+        for (std::size_t i = 0; i < outside_count; ++i) {
+            const Complex value = function(saved[i]);
+            real[outside[i]]    = value.real();
+            imag[outside[i]]    = value.imag();
+        }
+    }
+}
+
+template <typename T, typename Function>
+void accurate_planes(std::size_t n, const T* operand_real, const T* operand_imag, T* real, T* imag,
+                     Function function) {
+    for (std::size_t i = 0; i < n; ++i) {
+        const BasicComplex<T> value = function(BasicComplex<T>(operand_real[i], operand_imag[i]));
+        real[i]                     = value.real();
+        imag[i]                     = value.imag();
+    }
+}
+
+// The fast tier of float runs the double kernels on converted blocks.
+template <typename DoublePlanes>
+void float_fast_planes(std::size_t n, const float* operand_real, const float* operand_imag, float* real, float* imag,
+                       DoublePlanes double_planes) {
+    std::array<double, BLOCK> block_real;
+    std::array<double, BLOCK> block_imag;
+    for (std::size_t start = 0; start < n; start += BLOCK) {
+        const std::size_t count = std::min(BLOCK, n - start);
+        std::copy_n(operand_real + start, count, block_real.begin());
+        std::copy_n(operand_imag + start, count, block_imag.begin());
+        double_planes(count, block_real.data(), block_imag.data(), block_real.data(), block_imag.data(),
+                      MathAccuracy::Fast);
+        std::transform(block_real.begin(), block_real.begin() + count, real + start,
+                       [](double value) { return static_cast<float>(value); });
+        std::transform(block_imag.begin(), block_imag.begin() + count, imag + start,
+                       [](double value) { return static_cast<float>(value); });
+    }
+}
+
+// Selects the tier of a unary function for every precision.
+template <typename InDomain, typename Function>
+struct UnaryFunction {
+    InDomain in_domain;
+    Kernel kernel;
+    Function function;
+
+    void operator()(std::size_t n, const double* operand_real, const double* operand_imag, double* real,
+                    double* imag, MathAccuracy accuracy) const {
+        if (accuracy == MathAccuracy::Fast) {
+            fast_planes(n, operand_real, operand_imag, real, imag, in_domain, kernel, function);
+        } else {
+            accurate_planes(n, operand_real, operand_imag, real, imag, function);
+        }
+    }
+
+    void operator()(std::size_t n, const float* operand_real, const float* operand_imag, float* real, float* imag,
+                    MathAccuracy accuracy) const {
+        if (accuracy == MathAccuracy::Fast) {
+            float_fast_planes(n, operand_real, operand_imag, real, imag, *this);
+        } else {
+            accurate_planes(n, operand_real, operand_imag, real, imag, function);
+        }
+    }
+
+    void operator()(std::size_t n, const long double* operand_real, const long double* operand_imag,
+                    long double* real, long double* imag, MathAccuracy) const {
+        accurate_planes(n, operand_real, operand_imag, real, imag, function);
+    }
+};
+
+template <typename InDomain, typename Function>
+UnaryFunction(InDomain, Kernel, Function) -> UnaryFunction<InDomain, Function>;
+
+const auto EXP  = UnaryFunction{in_exp_domain, fast_exp_kernel, [](const auto& number) { return exp(number); }};
+const auto LOG  = UnaryFunction{in_norm_domain, fast_log_kernel, [](const auto& number) { return log(number); }};
+const auto SQRT = UnaryFunction{in_norm_domain, fast_sqrt_kernel, [](const auto& number) { return sqrt(number); }};
+const auto SIN  = UnaryFunction{in_trig_domain, fast_sin_kernel, [](const auto& number) { return sin(number); }};
+const auto COS  = UnaryFunction{in_trig_domain, fast_cos_kernel, [](const auto& number) { return cos(number); }};
+
+template <typename T>
+void accurate_pow_planes(std::size_t n, const T* base_real, const T* base_imag, const T* exponent_real,
+                         const T* exponent_imag, T* real, T* imag) {
+    for (std::size_t i = 0; i < n; ++i) {
+        const BasicComplex<T> value = pow(BasicComplex<T>(base_real[i], base_imag[i]),
+                                          BasicComplex<T>(exponent_real[i], exponent_imag[i]));
+        real[i]                     = value.real();
+        imag[i]                     = value.imag();
+    }
+}
+
+// exp(w * log(z)) through the fast log and exp of a block, the special cases of a zero base are patched afterwards.
+void fast_pow_planes(std::size_t n, const double* base_real, const double* base_imag, const double* exponent_real,
+                     const double* exponent_imag, double* real, double* imag) {
+    std::array<double, BLOCK> block_real;
+    std::array<double, BLOCK> block_imag;
+    std::array<std::size_t, BLOCK> zeros;
+    std::array<Complex, BLOCK> saved;
+    for (std::size_t start = 0; start < n; start += BLOCK) {
+        const std::size_t count = std::min(BLOCK, n - start);
+        std::size_t zero_count  = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            if (base_real[start + i] == 0 && base_imag[start + i] == 0) {
+                zeros[zero_count] = start + i;
+                saved[zero_count] = Complex(exponent_real[start + i], exponent_imag[start + i]);
+                ++zero_count;
+            }
+        }
+        LOG(count, base_real + start, base_imag + start, block_real.data(), block_imag.data(), MathAccuracy::Fast);
+        multiply_planes(count, exponent_real + start, exponent_imag + start, block_real.data(), block_imag.data(),
+                        block_real.data(), block_imag.data());
+        EXP(count, block_real.data(), block_imag.data(), real + start, imag + start, MathAccuracy::Fast);
+        for (std::size_t i = 0; i < zero_count; ++i) {
+            const Complex value = pow(Complex(0), saved[i]);
+            real[zeros[i]]      = value.real();
+            imag[zeros[i]]      = value.imag();
+        }
+    }
+}
+
+// Squares whole blocks with the plane kernels in the order of the scalar pow.
+template <typename T>
+void integer_pow_planes(std::size_t n, const T* base_real, const T* base_imag, std::int32_t exponent, T* real,
+                        T* imag) {
+    if (exponent == 0) {
+        std::fill_n(real, n, T(1));
+        std::fill_n(imag, n, T(0));
+        return;
+    }
+    std::array<T, BLOCK> square_real;
+    std::array<T, BLOCK> square_imag;
+    for (std::size_t start = 0; start < n; start += BLOCK) {
+        const std::size_t count = std::min(BLOCK, n - start);
+        for (std::size_t i = 0; i < count; ++i) {
+            const BasicComplex<T> base(base_real[start + i], base_imag[start + i]);
+            const BasicComplex<T> square = exponent < 0 ? base.inverse() : base;
+            square_real[i]               = square.real();
+            square_imag[i]               = square.imag();
+        }
+        const auto square_block = [&] {
+            multiply_planes(count, square_real.data(), square_imag.data(), square_real.data(), square_imag.data(),
+                            square_real.data(), square_imag.data());
+        };
+        std::uint32_t bits = exponent < 0 ? 0U - static_cast<std::uint32_t>(exponent) : exponent;
+        while ((bits & 1) == 0) {
+            square_block();
+            bits >>= 1;
+        }
+        std::copy_n(square_real.data(), count, real + start);
+        std::copy_n(square_imag.data(), count, imag + start);
+        while ((bits >>= 1) != 0) {
+            square_block();
+            if ((bits & 1) != 0) {
+                multiply_planes(count, real + start, imag + start, square_real.data(), square_imag.data(),
+                                real + start, imag + start);
+            }
+        }
+    }
+}
+
+template <typename Function>
+ComplexArray apply(const ComplexArray& array, MathAccuracy accuracy, const Function& function) {
+    ComplexArray result(array.size());
+    function(array.size(), array.real_data(), array.imag_data(), result.real_data(), result.imag_data(), accuracy);
+    return result;
+}
+
+}  // namespace
+
+void exp_planes(std::size_t n, const float* operand_real, const float* operand_imag, float* real, float* imag,
+                MathAccuracy accuracy) {
+    EXP(n, operand_real, operand_imag, real, imag, accuracy);
+}
+
+void exp_planes(std::size_t n, const double* operand_real, const double* operand_imag, double* real, double* imag,
+                MathAccuracy accuracy) {
+    EXP(n, operand_real, operand_imag, real, imag, accuracy);
+}
+
+void exp_planes(std::size_t n, const long double* operand_real, const long double* operand_imag, long double* real,
+                long double* imag, MathAccuracy accuracy) {
+    EXP(n, operand_real, operand_imag, real, imag, accuracy);
+}
+
+void log_planes(std::size_t n, const float* operand_real, const float* operand_imag, float* real, float* imag,
+                MathAccuracy accuracy) {
+    LOG(n, operand_real, operand_imag, real, imag, accuracy);
+}
+
+void log_planes(std::size_t n, const double* operand_real, const double* operand_imag, double* real, double* imag,
+                MathAccuracy accuracy) {
+    LOG(n, operand_real, operand_imag, real, imag, accuracy);
+}
+
+void log_planes(std::size_t n, const long double* operand_real, const long double* operand_imag, long double* real,
+                long double* imag, MathAccuracy accuracy) {
+    LOG(n, operand_real, operand_imag, real, imag, accuracy);
+}
+
+void sqrt_planes(std::size_t n, const float* operand_real, const float* operand_imag, float* real, float* imag,
+                 MathAccuracy accuracy) {
+    SQRT(n, operand_real, operand_imag, real, imag, accuracy);
+}
+
+void sqrt_planes(std::size_t n, const double* operand_real, const double* operand_imag, double* real, double* imag,
+                 MathAccuracy accuracy) {
+    SQRT(n, operand_real, operand_imag, real, imag, accuracy);
+}
+
+void sqrt_planes(std::size_t n, const long double* operand_real, const long double* operand_imag, long double* real,
+                 long double* imag, MathAccuracy accuracy) {
+    SQRT(n, operand_real, operand_imag, real, imag, accuracy);
+}
+
+void sin_planes(std::size_t n, const float* operand_real, const float* operand_imag, float* real, float* imag,
+                MathAccuracy accuracy) {
+    SIN(n, operand_real, operand_imag, real, imag, accuracy);
+}
+
+void sin_planes(std::size_t n, const double* operand_real, const double* operand_imag, double* real, double* imag,
+                MathAccuracy accuracy) {
+    SIN(n, operand_real, operand_imag, real, imag, accuracy);
+}
+
+void sin_planes(std::size_t n, const long double* operand_real, const long double* operand_imag, long double* real,
+                long double* imag, MathAccuracy accuracy) {
+    SIN(n, operand_real, operand_imag, real, imag, accuracy);
+}
+
+void cos_planes(std::size_t n, const float* operand_real, const float* operand_imag, float* real, float* imag,
+                MathAccuracy accuracy) {
+    COS(n, operand_real, operand_imag, real, imag, accuracy);
+}
+
+void cos_planes(std::size_t n, const double* operand_real, const double* operand_imag, double* real, double* imag,
+                MathAccuracy accuracy) {
+    COS(n, operand_real, operand_imag, real, imag, accuracy);
+}
+
+void cos_planes(std::size_t n, const long double* operand_real, const long double* operand_imag, long double* real,
+                long double* imag, MathAccuracy accuracy) {
+    COS(n, operand_real, operand_imag, real, imag, accuracy);
+}
+
+void pow_planes(std::size_t n, const float* base_real, const float* base_imag, const float* exponent_real,
+                const float* exponent_imag, float* real, float* imag, MathAccuracy accuracy) {
+    if (accuracy == MathAccuracy::Accurate) {
+        accurate_pow_planes(n, base_real, base_imag, exponent_real, exponent_imag, real, imag);
+        return;
+    }
+    std::array<double, BLOCK> block_base_real;
+    std::array<double, BLOCK> block_base_imag;
+    std::array<double, BLOCK> block_exponent_real;
+    std::array<double, BLOCK> block_exponent_imag;
+    for (std::size_t start = 0; start < n; start += BLOCK) {
+        const std::size_t count = std::min(BLOCK, n - start);
+        std::copy_n(base_real + start, count, block_base_real.begin());
+        std::copy_n(base_imag + start, count, block_base_imag.begin());
+        std::copy_n(exponent_real + start, count, block_exponent_real.begin());
+        std::copy_n(exponent_imag + start, count, block_exponent_imag.begin());
+        fast_pow_planes(count, block_base_real.data(), block_base_imag.data(), block_exponent_real.data(),
+                        block_exponent_imag.data(), block_base_real.data(), block_base_imag.data());
+        std::transform(block_base_real.begin(), block_base_real.begin() + count, real + start,
+                       [](double value) { return static_cast<float>(value); });
+        std::transform(block_base_imag.begin(), block_base_imag.begin() + count, imag + start,
+                       [](double value) { return static_cast<float>(value); });
+    }
+}
+
+void pow_planes(std::size_t n, const double* base_real, const double* base_imag, const double* exponent_real,
+                const double* exponent_imag, double* real, double* imag, MathAccuracy accuracy) {
+    if (accuracy == MathAccuracy::Fast) {
+        fast_pow_planes(n, base_real, base_imag, exponent_real, exponent_imag, real, imag);
+    } else {
+        accurate_pow_planes(n, base_real, base_imag, exponent_real, exponent_imag, real, imag);
+    }
+}
+
+void pow_planes(std::size_t n, const long double* base_real, const long double* base_imag,
+                const long double* exponent_real, const long double* exponent_imag, long double* real,
+                long double* imag, MathAccuracy) {
+    accurate_pow_planes(n, base_real, base_imag, exponent_real, exponent_imag, real, imag);
+}
+
+void pow_planes(std::size_t n, const float* base_real, const float* base_imag, std::int32_t exponent, float* real,
+                float* imag) {
+    integer_pow_planes(n, base_real, base_imag, exponent, real, imag);
+}
+
+void pow_planes(std::size_t n, const double* base_real, const double* base_imag, std::int32_t exponent, double* real,
+                double* imag) {
+    integer_pow_planes(n, base_real, base_imag, exponent, real, imag);
+}
+
+void pow_planes(std::size_t n, const long double* base_real, const long double* base_imag, std::int32_t exponent,
+                long double* real, long double* imag) {
+    integer_pow_planes(n, base_real, base_imag, exponent, real, imag);
+}
+
+ComplexArray exp(const ComplexArray& array, MathAccuracy accuracy) {
+    return apply(array, accuracy, EXP);
+}
+
+ComplexArray log(const ComplexArray& array, MathAccuracy accuracy) {
+    return apply(array, accuracy, LOG);
+}
+
+ComplexArray sqrt(const ComplexArray& array, MathAccuracy accuracy) {
+    return apply(array, accuracy, SQRT);
+}
+
+ComplexArray sin(const ComplexArray& array, MathAccuracy accuracy) {
+    return apply(array, accuracy, SIN);
+}
+
+ComplexArray cos(const ComplexArray& array, MathAccuracy accuracy) {
+    return apply(array, accuracy, COS);
+}
+
+ComplexArray pow(const ComplexArray& base, const ComplexArray& exponent, MathAccuracy accuracy) {
+    if (base.size() != exponent.size()) {
+        throw std::invalid_argument("complex arrays have different sizes");
+    }
+    ComplexArray result(base.size());
+    pow_planes(base.size(), base.real_data(), base.imag_data(), exponent.real_data(), exponent.imag_data(),
+               result.real_data(), result.imag_data(), accuracy);
+    return result;
+}
+
+ComplexArray pow(const ComplexArray& base, std::int32_t exponent) {
+    ComplexArray result(base.size());
+    pow_planes(base.size(), base.real_data(), base.imag_data(), exponent, result.real_data(), result.imag_data());
+    return result;
+}
@@ -0,0 +1,553 @@
+#include "complex/complex_matrix.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+#include "simd_kernel.hpp"
+
+namespace {
+
+// Register tile of the product kernels, MR rows of the left operand times NR columns of
+// the right one. With NR = 8 GCC vectorizes the kernels over the depth and shuffles,
+// with 16 it keeps the columns in vectors.
+constexpr std::size_t MR = 4;
+constexpr std::size_t NR = 16;
+
+// Cache blocks: a KC x NR panel of the right operand stays in L1 while the kernels run
+// it against the panels of a packed MC x KC block of the left operand in L2, for the
+// three planes of the 3M method too. A tile of the output is MC x NC.
+constexpr std::size_t MC = 128;
+constexpr std::size_t KC = 96;
+constexpr std::size_t NC = 512;
+
+// Rows of the matrix vector product that one task takes.
+constexpr std::size_t ROWS_PER_TASK = 64;
+
+// Independent sums of the matrix vector product, so that its rows vectorize without
+// reassociation.
+constexpr std::size_t LANES = 8;
+
+bool is_zero(const Complex& number) {
+    return number.real() == 0 && number.imag() == 0;
+}
+
+struct Product {
+    std::size_t m;
+    std::size_t n;
+    std::size_t k;
+    double sign;
+    const double* left_real;
+    const double* left_imag;
+    std::size_t left_stride;
+    const double* right_real;
+    const double* right_imag;
+    std::size_t right_stride;
+    double* out_real;
+    double* out_imag;
+    std::size_t out_stride;
+    bool three_products;
+};
+
+// Copies rows x depth values of the left operand into panels of MR rows, each stored
+// column after column and padded with zeros. sum gets real + imag for the 3M kernel.
+void pack_left(const Product& product, std::size_t row_start, std::size_t rows, std::size_t depth_start,
+               std::size_t depth, double* real, double* imag, double* sum) {
+    for (std::size_t panel = 0; panel < rows; panel += MR) {
+        for (std::size_t p = 0; p < depth; ++p) {
+            for (std::size_t i = 0; i < MR; ++i) {
+                double value_real = 0;
+                double value_imag = 0;
+                if (panel + i < rows) {
+                    const std::size_t index = (row_start + panel + i) * product.left_stride + depth_start + p;
+                    value_real              = product.left_real[index];
+                    value_imag              = product.left_imag[index];
+                }
+                const std::size_t offset = panel * depth + p * MR + i;
+                real[offset]             = value_real;
+                imag[offset]             = value_imag;
+                if (sum != nullptr) {
+                    sum[offset] = value_real + value_imag;
+                }
+            }
+        }
+    }
+}
+
+// Copies depth x columns values of the right operand into panels of NR columns, each
+// stored row after row and padded with zeros.
+void pack_right(const Product& product, std::size_t depth_start, std::size_t depth, std::size_t column_start,
+                std::size_t columns, double* real, double* imag, double* sum) {
+    for (std::size_t panel = 0; panel < columns; panel += NR) {
+        const std::size_t width = std::min(NR, columns - panel);
+        for (std::size_t p = 0; p < depth; ++p) {
+            const std::size_t index  = (depth_start + p) * product.right_stride + column_start + panel;
+            const std::size_t offset = panel * depth + p * NR;
+            for (std::size_t j = 0; j < NR; ++j) {
+                const double value_real = j < width ? product.right_real[index + j] : 0;
+                const double value_imag = j < width ? product.right_imag[index + j] : 0;
+                real[offset + j]        = value_real;
+                imag[offset + j]        = value_imag;
+                if (sum != nullptr) {
+                    sum[offset + j] = value_real + value_imag;
+                }
+            }
+        }
+    }
+}
+
+// Adds sign times the product of an MR row and an NR column panel of depth values to the
+// rows x columns corner of out.
+COMPLEX_SIMD_KERNEL
+void product_kernel(std::size_t depth, const double* left_real, const double* left_imag, const double* right_real,
+                    const double* right_imag, std::size_t rows, std::size_t columns, double sign, double* out_real,
+                    double* out_imag, std::size_t out_stride) {
+    double acc_real[MR * NR] = {};
+    double acc_imag[MR * NR] = {};
+    for (std::size_t p = 0; p < depth; ++p) {
+        for (std::size_t i = 0; i < MR; ++i) {
+            const double a_real = left_real[p * MR + i];
+            const double a_imag = left_imag[p * MR + i];
+            for (std::size_t j = 0; j < NR; ++j) {
+                const double b_real = right_real[p * NR + j];
+                const double b_imag = right_imag[p * NR + j];
+                acc_real[i * NR + j] += a_real * b_real - a_imag * b_imag;
+                acc_imag[i * NR + j] += a_real * b_imag + a_imag * b_real;
+            }
+        }
+    }
+    for (std::size_t i = 0; i < rows; ++i) {
+        for (std::size_t j = 0; j < columns; ++j) {
+            out_real[i * out_stride + j] += sign * acc_real[i * NR + j];
+            out_imag[i * out_stride + j] += sign * acc_imag[i * NR + j];
+        }
+    }
+}
+
+// Same as above with the 3M method.
+COMPLEX_SIMD_KERNEL
+void product_kernel_3m(std::size_t depth, const double* left_real, const double* left_imag, const double* left_sum,
+                       const double* right_real, const double* right_imag, const double* right_sum, std::size_t rows,
+                       std::size_t columns, double sign, double* out_real, double* out_imag, std::size_t out_stride) {
+    double acc_real[MR * NR] = {};
+    double acc_imag[MR * NR] = {};
+    double acc_sum[MR * NR]  = {};
+    for (std::size_t p = 0; p < depth; ++p) {
+        for (std::size_t i = 0; i < MR; ++i) {
+            const double a_real = left_real[p * MR + i];
+            const double a_imag = left_imag[p * MR + i];
+            const double a_sum  = left_sum[p * MR + i];
+            for (std::size_t j = 0; j < NR; ++j) {
+                acc_real[i * NR + j] += a_real * right_real[p * NR + j];
+                acc_imag[i * NR + j] += a_imag * right_imag[p * NR + j];
+                acc_sum[i * NR + j] += a_sum * right_sum[p * NR + j];
+            }
+        }
+    }
+    for (std::size_t i = 0; i < rows; ++i) {
+        for (std::size_t j = 0; j < columns; ++j) {
+            const double real = acc_real[i * NR + j];
+            const double imag = acc_imag[i * NR + j];
+            out_real[i * out_stride + j] += sign * (real - imag);
+            out_imag[i * out_stride + j] += sign * (acc_sum[i * NR + j] - real - imag);
+        }
+    }
+}
+
+std::size_t round_up(std::size_t value, std::size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+// Doubles in one plane of a packed block, no more than the operands need.
+std::size_t left_block_size(const Product& product) {
+    return std::min(MC, round_up(product.m, MR)) * std::min(KC, product.k);
+}
+
+std::size_t right_block_size(const Product& product) {
+    return std::min(KC, product.k) * std::min(NC, round_up(product.n, NR));
+}
+
+// Doubles of packing space for one tile.
+std::size_t packing_size(const Product& product) {
+    return (product.three_products ? 3 : 2) * (left_block_size(product) + right_block_size(product));
+}
+
+void multiply_tile(const Product& product, std::size_t tile, double* packing) {
+    const std::size_t row_tiles    = (product.m + MC - 1) / MC;
+    const std::size_t row_start    = tile % row_tiles * MC;
+    const std::size_t column_start = tile / row_tiles * NC;
+    const std::size_t rows         = std::min(MC, product.m - row_start);
+    const std::size_t columns      = std::min(NC, product.n - column_start);
+    const std::size_t left_size    = left_block_size(product);
+    const std::size_t right_size   = right_block_size(product);
+
+    double* left_real  = packing;
+    double* left_imag  = left_real + left_size;
+    double* right_real = left_imag + left_size;
+    double* right_imag = right_real + right_size;
+    double* left_sum   = product.three_products ? right_imag + right_size : nullptr;
+    double* right_sum  = product.three_products ? left_sum + left_size : nullptr;
+
+    for (std::size_t depth_start = 0; depth_start < product.k; depth_start += KC) {
+        const std::size_t depth = std::min(KC, product.k - depth_start);
+        pack_right(product, depth_start, depth, column_start, columns, right_real, right_imag, right_sum);
+        pack_left(product, row_start, rows, depth_start, depth, left_real, left_imag, left_sum);
+        for (std::size_t j = 0; j < columns; j += NR) {
+            for (std::size_t i = 0; i < rows; i += MR) {
+                const std::size_t left   = i * depth;
+                const std::size_t right  = j * depth;
+                const std::size_t out    = (row_start + i) * product.out_stride + column_start + j;
+                const std::size_t height = std::min(MR, rows - i);
+                const std::size_t width  = std::min(NR, columns - j);
+                if (product.three_products) {
+                    product_kernel_3m(depth, left_real + left, left_imag + left, left_sum + left, right_real + right,
+                                      right_imag + right, right_sum + right, height, width, product.sign,
+                                      product.out_real + out, product.out_imag + out, product.out_stride);
+                } else {
+                    product_kernel(depth, left_real + left, left_imag + left, right_real + right, right_imag + right,
+                                   height, width, product.sign, product.out_real + out, product.out_imag + out,
+                                   product.out_stride);
+                }
+            }
+        }
+    }
+}
+
+// real + i imag = matrix row times vector, summed in LANES interleaved partial sums.
+COMPLEX_SIMD_KERNEL
+void row_product_kernel(std::size_t n, const double* row_real, const double* row_imag, const double* vector_real,
+                        const double* vector_imag, double* real, double* imag) {
+    double sum_real[LANES] = {};
+    double sum_imag[LANES] = {};
+    std::size_t j          = 0;
+    for (; j + LANES <= n; j += LANES) {
+        for (std::size_t lane = 0; lane < LANES; ++lane) {
+            const double a_real = row_real[j + lane];
+            const double a_imag = row_imag[j + lane];
+            const double b_real = vector_real[j + lane];
+            const double b_imag = vector_imag[j + lane];
+            sum_real[lane] += a_real * b_real - a_imag * b_imag;
+            sum_imag[lane] += a_real * b_imag + a_imag * b_real;
+        }
+    }
+    for (std::size_t lane = 0; j < n; ++j, ++lane) {
+        sum_real[lane] += row_real[j] * vector_real[j] - row_imag[j] * vector_imag[j];
+        sum_imag[lane] += row_real[j] * vector_imag[j] + row_imag[j] * vector_real[j];
+    }
+    *real = 0;
+    *imag = 0;
+    for (std::size_t lane = 0; lane < LANES; ++lane) {
+        *real += sum_real[lane];
+        *imag += sum_imag[lane];
+    }
+}
+
+void multiply_rows(const ComplexMatrix& matrix, const ComplexArray& vector, std::size_t begin, std::size_t end,
+                   ComplexArray& result) {
+    const std::size_t columns = matrix.columns();
+    for (std::size_t i = begin; i < end; ++i) {
+        row_product_kernel(columns, matrix.real_data() + i * columns, matrix.imag_data() + i * columns,
+                           vector.real_data(), vector.imag_data(), result.real_data() + i, result.imag_data() + i);
+    }
+}
+
+// target -= factor * source.
+COMPLEX_SIMD_KERNEL
+void eliminate_kernel(std::size_t n, double factor_real, double factor_imag, const double* source_real,
+                      const double* source_imag, double* target_real, double* target_imag) {
+    for (std::size_t i = 0; i < n; ++i) {
+        target_real[i] -= factor_real * source_real[i] - factor_imag * source_imag[i];
+        target_imag[i] -= factor_real * source_imag[i] + factor_imag * source_real[i];
+    }
+}
+
+void swap_rows(std::size_t columns, std::size_t first, std::size_t second, double* real, double* imag) {
+    std::swap_ranges(real + first * columns, real + (first + 1) * columns, real + second * columns);
+    std::swap_ranges(imag + first * columns, imag + (first + 1) * columns, imag + second * columns);
+}
+
+void check_product(const ComplexMatrix& left, std::size_t rows) {
+    if (left.columns() != rows) {
+        throw std::invalid_argument("matrix dimensions do not match");
+    }
+}
+
+}  // namespace
+
+ComplexMatrix::ComplexMatrix(std::size_t rows, std::size_t columns)
+    : row_count(rows), column_count(columns), elements(rows * columns) {}
+
+ComplexMatrix::ComplexMatrix(std::size_t rows, std::size_t columns, std::span<const Complex> values)
+    : row_count(rows), column_count(columns), elements(values) {
+    if (values.size() != rows * columns) {
+        throw std::invalid_argument("matrix values do not match its dimensions");
+    }
+}
+
+ComplexMatrix ComplexMatrix::identity(std::size_t size) {
+    ComplexMatrix matrix(size, size);
+    for (std::size_t i = 0; i < size; ++i) {
+        matrix.real_data()[i * size + i] = 1;
+    }
+    return matrix;
+}
+
+std::size_t ComplexMatrix::rows() const {
+    return row_count;
+}
+
+std::size_t ComplexMatrix::columns() const {
+    return column_count;
+}
+
+Complex ComplexMatrix::operator()(std::size_t row, std::size_t column) const {
+    return elements[row * column_count + column];
+}
+
+void ComplexMatrix::set(std::size_t row, std::size_t column, const Complex& value) {
+    elements.set(row * column_count + column, value);
+}
+
+double* ComplexMatrix::real_data() {
+    return elements.real_data();
+}
+
+const double* ComplexMatrix::real_data() const {
+    return elements.real_data();
+}
+
+double* ComplexMatrix::imag_data() {
+    return elements.imag_data();
+}
+
+const double* ComplexMatrix::imag_data() const {
+    return elements.imag_data();
+}
+
+std::vector<Complex> ComplexMatrix::to_vector() const {
+    return elements.to_vector();
+}
+
+void multiply_add_planes(std::size_t m, std::size_t n, std::size_t k, double sign, const double* left_real,
+                         const double* left_imag, std::size_t left_stride, const double* right_real,
+                         const double* right_imag, std::size_t right_stride, double* out_real, double* out_imag,
+                         std::size_t out_stride, MathAccuracy accuracy, ThreadPool* pool) {
+    if (m == 0 || n == 0 || k == 0) {
+        return;
+    }
+    const Product product = {m, n, k, sign, left_real, left_imag, left_stride, right_real, right_imag, right_stride,
+                             out_real, out_imag, out_stride, accuracy == MathAccuracy::Fast};
+
+    const std::size_t tiles = (m + MC - 1) / MC * ((n + NC - 1) / NC);
+    if (pool == nullptr || tiles == 1) {
+        std::vector<double> packing(packing_size(product));
+        for (std::size_t tile = 0; tile < tiles; ++tile) {
+            multiply_tile(product, tile, packing.data());
+        }
+        return;
+    }
+    // A few chunks per worker balance the load, every chunk allocates packing space once.
+    const std::size_t chunks = std::min(tiles, 4 * pool->size());
+    pool->parallel_for(chunks, [&](std::size_t chunk) {
+        std::vector<double> packing(packing_size(product));
+        for (std::size_t tile = chunk * tiles / chunks; tile < (chunk + 1) * tiles / chunks; ++tile) {
+            multiply_tile(product, tile, packing.data());
+        }
+    });
+}
+
+ComplexMatrix multiply(const ComplexMatrix& left, const ComplexMatrix& right, MathAccuracy accuracy) {
+    check_product(left, right.rows());
+    ComplexMatrix result(left.rows(), right.columns());
+    multiply_add_planes(left.rows(), right.columns(), left.columns(), 1, left.real_data(), left.imag_data(),
+                        left.columns(), right.real_data(), right.imag_data(), right.columns(), result.real_data(),
+                        result.imag_data(), result.columns(), accuracy);
+    return result;
+}
+
+ComplexMatrix multiply(ThreadPool& pool, const ComplexMatrix& left, const ComplexMatrix& right,
+                       MathAccuracy accuracy) {
+    check_product(left, right.rows());
+    ComplexMatrix result(left.rows(), right.columns());
+    multiply_add_planes(left.rows(), right.columns(), left.columns(), 1, left.real_data(), left.imag_data(),
+                        left.columns(), right.real_data(), right.imag_data(), right.columns(), result.real_data(),
+                        result.imag_data(), result.columns(), accuracy, &pool);
+    return result;
+}
+
+ComplexArray multiply(const ComplexMatrix& matrix, const ComplexArray& vector) {
+    check_product(matrix, vector.size());
+    ComplexArray result(matrix.rows());
+    multiply_rows(matrix, vector, 0, matrix.rows(), result);
+    return result;
+}
+
+ComplexArray multiply(ThreadPool& pool, const ComplexMatrix& matrix, const ComplexArray& vector) {
+    check_product(matrix, vector.size());
+    ComplexArray result(matrix.rows());
+    const std::size_t rows = matrix.rows();
+    pool.parallel_for((rows + ROWS_PER_TASK - 1) / ROWS_PER_TASK, [&](std::size_t task) {
+        const std::size_t begin = task * ROWS_PER_TASK;
+        multiply_rows(matrix, vector, begin, std::min(rows, begin + ROWS_PER_TASK), result);
+    });
+    return result;
+}
+
+ComplexMatrix operator*(const ComplexMatrix& left, const ComplexMatrix& right) {
+    return multiply(left, right);
+}
+
+ComplexArray operator*(const ComplexMatrix& matrix, const ComplexArray& vector) {
+    return multiply(matrix, vector);
+}
+
+LuDecomposition::LuDecomposition(const ComplexMatrix& matrix) : lu(matrix) {
+    factorize(nullptr);
+}
+
+LuDecomposition::LuDecomposition(ThreadPool& pool, const ComplexMatrix& matrix) : lu(matrix) {
+    factorize(&pool);
+}
+
+std::size_t LuDecomposition::size() const {
+    return lu.rows();
+}
+
+bool LuDecomposition::is_singular() const {
+    return singular;
+}
+
+const ComplexMatrix& LuDecomposition::factors() const {
+    return lu;
+}
+
+std::vector<std::size_t> LuDecomposition::permutation() const {
+    std::vector<std::size_t> rows(size());
+    std::iota(rows.begin(), rows.end(), std::size_t(0));
+    for (std::size_t i = 0; i < pivots.size(); ++i) {
+        std::swap(rows[i], rows[pivots[i]]);
+    }
+    return rows;
+}
+
+Complex LuDecomposition::determinant() const {
+    Complex result(1);
+    for (std::size_t i = 0; i < size(); ++i) {
+        result *= lu(i, i);
+        if (pivots[i] != i) {
+            result = -result;
+        }
+    }
+    return result;
+}
+
+ComplexArray LuDecomposition::solve(const ComplexArray& right_side) const {
+    if (right_side.size() != size()) {
+        throw std::invalid_argument("right side does not match the matrix");
+    }
+    ComplexArray result = right_side;
+    substitute(1, result.real_data(), result.imag_data());
+    return result;
+}
+
+ComplexMatrix LuDecomposition::solve(const ComplexMatrix& right_side) const {
+    if (right_side.rows() != size()) {
+        throw std::invalid_argument("right side does not match the matrix");
+    }
+    ComplexMatrix result = right_side;
+    substitute(result.columns(), result.real_data(), result.imag_data());
+    return result;
+}
+
+void LuDecomposition::factorize(ThreadPool* pool) {
+    if (lu.rows() != lu.columns()) {
+        throw std::invalid_argument("matrix is not square");
+    }
+    const std::size_t n = size();
+    double* real        = lu.real_data();
+    double* imag        = lu.imag_data();
+    pivots.resize(n);
+    for (std::size_t start = 0; start < n; start += BLOCK) {
+        const std::size_t end = std::min(n, start + BLOCK);
+
+        // Unblocked elimination in the panel of columns [start, end), with the row swaps
+        // applied to whole rows.
+        for (std::size_t j = start; j < end; ++j) {
+            std::size_t pivot = j;
+            double largest    = -1;
+            for (std::size_t i = j; i < n; ++i) {
+                const double magnitude = std::abs(real[i * n + j]) + std::abs(imag[i * n + j]);
+                if (magnitude > largest) {
+                    pivot   = i;
+                    largest = magnitude;
+                }
+            }
+            pivots[j] = pivot;
+            if (pivot != j) {
+                swap_rows(n, j, pivot, real, imag);
+            }
+            const Complex diagonal = lu(j, j);
+            if (is_zero(diagonal)) {
+                singular = true;
+                continue;
+            }
+            for (std::size_t i = j + 1; i < n; ++i) {
+                const Complex factor = lu(i, j) / diagonal;
+                lu.set(i, j, factor);
+                eliminate_kernel(end - j - 1, factor.real(), factor.imag(), real + j * n + j + 1,
+                                 imag + j * n + j + 1, real + i * n + j + 1, imag + i * n + j + 1);
+            }
+        }
+        if (end == n) {
+            break;
+        }
+
+        // The block row of U right of the panel, forward substitution with its unit lower
+        // triangle.
+        for (std::size_t row = start; row < end; ++row) {
+            for (std::size_t i = row + 1; i < end; ++i) {
+                eliminate_kernel(n - end, real[i * n + row], imag[i * n + row], real + row * n + end,
+                                 imag + row * n + end, real + i * n + end, imag + i * n + end);
+            }
+        }
+
+        // The trailing matrix minus the panel below the diagonal times the block row of U.
+        multiply_add_planes(n - end, n - end, end - start, -1, real + end * n + start, imag + end * n + start, n,
+                            real + start * n + end, imag + start * n + end, n, real + end * n + end,
+                            imag + end * n + end, n, MathAccuracy::Accurate, pool);
+    }
+}
+
+void LuDecomposition::substitute(std::size_t columns, double* real, double* imag) const {
+    if (singular) {
+        throw std::domain_error("matrix is singular");
+    }
+    const std::size_t n       = size();
+    const double* factor_real = lu.real_data();
+    const double* factor_imag = lu.imag_data();
+    for (std::size_t i = 0; i < n; ++i) {
+        if (pivots[i] != i) {
+            swap_rows(columns, i, pivots[i], real, imag);
+        }
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t row = 0; row < i; ++row) {
+            eliminate_kernel(columns, factor_real[i * n + row], factor_imag[i * n + row], real + row * columns,
+                             imag + row * columns, real + i * columns, imag + i * columns);
+        }
+    }
+    for (std::size_t i = n; i-- > 0;) {
+        for (std::size_t row = i + 1; row < n; ++row) {
+            eliminate_kernel(columns, factor_real[i * n + row], factor_imag[i * n + row], real + row * columns,
+                             imag + row * columns, real + i * columns, imag + i * columns);
+        }
+        const Complex diagonal = lu(i, i);
+        for (std::size_t column = 0; column < columns; ++column) {
+            const Complex value        = Complex(real[i * columns + column], imag[i * columns + column]) / diagonal;
+            real[i * columns + column] = value.real();
+            imag[i * columns + column] = value.imag();
+        }
+    }
+}
@@ -0,0 +1,457 @@
+#include "complex/fft.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+#include "simd_kernel.hpp"
+
+namespace {
+
+constexpr long double PI = 3.141592653589793238462643383279502884L;
+
+// Operands of one Stockham pass: x holds span blocks of radix * stride values, the
+// result for block j and output s goes to y[(j + s * span) * stride]. The sign is -1
+// for the inverse transform, it conjugates every root of unity.
+struct Pass {
+    std::size_t span;
+    std::size_t stride;
+    double sign;
+    const double* roots_real;
+    const double* roots_imag;
+    const double* x_real;
+    const double* x_imag;
+    double* y_real;
+    double* y_imag;
+};
+
+COMPLEX_SIMD_KERNEL
+void radix2_pass(const Pass& pass) {
+    const std::size_t stride = pass.stride;
+    const std::size_t output = pass.span * stride;
+    for (std::size_t j = 0; j < pass.span; ++j) {
+        const double w_real  = pass.roots_real[j * stride];
+        const double w_imag  = pass.sign * pass.roots_imag[j * stride];
+        const double* a_real = pass.x_real + 2 * j * stride;
+        const double* a_imag = pass.x_imag + 2 * j * stride;
+        double* y_real       = pass.y_real + j * stride;
+        double* y_imag       = pass.y_imag + j * stride;
+        for (std::size_t k = 0; k < stride; ++k) {
+            const double b_real = a_real[stride + k] * w_real - a_imag[stride + k] * w_imag;
+            const double b_imag = a_imag[stride + k] * w_real + a_real[stride + k] * w_imag;
+            y_real[k]           = a_real[k] + b_real;
+            y_imag[k]           = a_imag[k] + b_imag;
+            y_real[output + k]  = a_real[k] - b_real;
+            y_imag[output + k]  = a_imag[k] - b_imag;
+        }
+    }
+}
+
+COMPLEX_SIMD_KERNEL
+void radix3_pass(const Pass& pass) {
+    // sin(2 pi / 3), the imaginary part of the third roots of unity.
+    const double sine        = pass.sign * static_cast<double>(std::sqrt(3.0L) / 2);
+    const std::size_t stride = pass.stride;
+    const std::size_t output = pass.span * stride;
+    for (std::size_t j = 0; j < pass.span; ++j) {
+        const double w1_real = pass.roots_real[j * stride];
+        const double w1_imag = pass.sign * pass.roots_imag[j * stride];
+        const double w2_real = pass.roots_real[2 * j * stride];
+        const double w2_imag = pass.sign * pass.roots_imag[2 * j * stride];
+        const double* a_real = pass.x_real + 3 * j * stride;
+        const double* a_imag = pass.x_imag + 3 * j * stride;
+        double* y_real       = pass.y_real + j * stride;
+        double* y_imag       = pass.y_imag + j * stride;
+        for (std::size_t k = 0; k < stride; ++k) {
+            const double a1_real   = a_real[stride + k] * w1_real - a_imag[stride + k] * w1_imag;
+            const double a1_imag   = a_imag[stride + k] * w1_real + a_real[stride + k] * w1_imag;
+            const double a2_real   = a_real[2 * stride + k] * w2_real - a_imag[2 * stride + k] * w2_imag;
+            const double a2_imag   = a_imag[2 * stride + k] * w2_real + a_real[2 * stride + k] * w2_imag;
+            const double s_real    = a1_real + a2_real;
+            const double s_imag    = a1_imag + a2_imag;
+            const double m_real    = a_real[k] - 0.5 * s_real;
+            const double m_imag    = a_imag[k] - 0.5 * s_imag;
+            const double r_real    = sine * (a1_imag - a2_imag);
+            const double r_imag    = sine * (a2_real - a1_real);
+            y_real[k]              = a_real[k] + s_real;
+            y_imag[k]              = a_imag[k] + s_imag;
+            y_real[output + k]     = m_real + r_real;
+            y_imag[output + k]     = m_imag + r_imag;
+            y_real[2 * output + k] = m_real - r_real;
+            y_imag[2 * output + k] = m_imag - r_imag;
+        }
+    }
+}
+
+COMPLEX_SIMD_KERNEL
+void radix4_pass(const Pass& pass) {
+    const double sign        = pass.sign;
+    const std::size_t stride = pass.stride;
+    const std::size_t output = pass.span * stride;
+    for (std::size_t j = 0; j < pass.span; ++j) {
+        const double w1_real = pass.roots_real[j * stride];
+        const double w1_imag = sign * pass.roots_imag[j * stride];
+        const double w2_real = pass.roots_real[2 * j * stride];
+        const double w2_imag = sign * pass.roots_imag[2 * j * stride];
+        const double w3_real = pass.roots_real[3 * j * stride];
+        const double w3_imag = sign * pass.roots_imag[3 * j * stride];
+        const double* a_real = pass.x_real + 4 * j * stride;
+        const double* a_imag = pass.x_imag + 4 * j * stride;
+        double* y_real       = pass.y_real + j * stride;
+        double* y_imag       = pass.y_imag + j * stride;
+        for (std::size_t k = 0; k < stride; ++k) {
+            const double a1_real = a_real[stride + k] * w1_real - a_imag[stride + k] * w1_imag;
+            const double a1_imag = a_imag[stride + k] * w1_real + a_real[stride + k] * w1_imag;
+            const double a2_real = a_real[2 * stride + k] * w2_real - a_imag[2 * stride + k] * w2_imag;
+            const double a2_imag = a_imag[2 * stride + k] * w2_real + a_real[2 * stride + k] * w2_imag;
+            const double a3_real = a_real[3 * stride + k] * w3_real - a_imag[3 * stride + k] * w3_imag;
+            const double a3_imag = a_imag[3 * stride + k] * w3_real + a_real[3 * stride + k] * w3_imag;
+            const double t0_real = a_real[k] + a2_real;
+            const double t0_imag = a_imag[k] + a2_imag;
+            const double t1_real = a_real[k] - a2_real;
+            const double t1_imag = a_imag[k] - a2_imag;
+            const double t2_real = a1_real + a3_real;
+            const double t2_imag = a1_imag + a3_imag;
+            // (a1 - a3) times -i, or i for the inverse transform.
+            const double t3_real   = sign * (a1_imag - a3_imag);
+            const double t3_imag   = sign * (a3_real - a1_real);
+            y_real[k]              = t0_real + t2_real;
+            y_imag[k]              = t0_imag + t2_imag;
+            y_real[output + k]     = t1_real + t3_real;
+            y_imag[output + k]     = t1_imag + t3_imag;
+            y_real[2 * output + k] = t0_real - t2_real;
+            y_imag[2 * output + k] = t0_imag - t2_imag;
+            y_real[3 * output + k] = t1_real - t3_real;
+            y_imag[3 * output + k] = t1_imag - t3_imag;
+        }
+    }
+}
+
+// Direct DFT of every group of radix values, for the odd prime factors from 5 up to MAX_RADIX.
+void generic_pass(const Pass& pass, std::size_t radix) {
+    std::array<double, FftPlan::MAX_RADIX> w_real;
+    std::array<double, FftPlan::MAX_RADIX> w_imag;
+    std::array<double, FftPlan::MAX_RADIX> omega_real;
+    std::array<double, FftPlan::MAX_RADIX> omega_imag;
+    std::array<double, FftPlan::MAX_RADIX> a_real;
+    std::array<double, FftPlan::MAX_RADIX> a_imag;
+
+    const std::size_t stride = pass.stride;
+    const std::size_t output = pass.span * stride;
+    // The roots of unity of the radix are every output-th root of the plan.
+    for (std::size_t m = 0; m < radix; ++m) {
+        omega_real[m] = pass.roots_real[m * output];
+        omega_imag[m] = pass.sign * pass.roots_imag[m * output];
+    }
+    for (std::size_t j = 0; j < pass.span; ++j) {
+        for (std::size_t q = 0; q < radix; ++q) {
+            w_real[q] = pass.roots_real[q * j * stride];
+            w_imag[q] = pass.sign * pass.roots_imag[q * j * stride];
+        }
+        const double* x_real = pass.x_real + radix * j * stride;
+        const double* x_imag = pass.x_imag + radix * j * stride;
+        double* y_real       = pass.y_real + j * stride;
+        double* y_imag       = pass.y_imag + j * stride;
+        for (std::size_t k = 0; k < stride; ++k) {
+            for (std::size_t q = 0; q < radix; ++q) {
+                const double value_real = x_real[q * stride + k];
+                const double value_imag = x_imag[q * stride + k];
+                a_real[q]               = value_real * w_real[q] - value_imag * w_imag[q];
+                a_imag[q]               = value_imag * w_real[q] + value_real * w_imag[q];
+            }
+            for (std::size_t s = 0; s < radix; ++s) {
+                double sum_real = a_real[0];
+                double sum_imag = a_imag[0];
+                std::size_t m   = 0;
+                for (std::size_t q = 1; q < radix; ++q) {
+                    m = m + s < radix ? m + s : m + s - radix;
+                    sum_real += a_real[q] * omega_real[m] - a_imag[q] * omega_imag[m];
+                    sum_imag += a_imag[q] * omega_real[m] + a_real[q] * omega_imag[m];
+                }
+                y_real[s * output + k] = sum_real;
+                y_imag[s * output + k] = sum_imag;
+            }
+        }
+    }
+}
+
+COMPLEX_SIMD_KERNEL
+void scale_planes(std::size_t n, double factor, double* real, double* imag) {
+    for (std::size_t i = 0; i < n; ++i) {
+        real[i] *= factor;
+        imag[i] *= factor;
+    }
+}
+
+// Prime factors in the order of the stages, fours first.
+std::vector<std::size_t> radices(std::size_t size) {
+    std::vector<std::size_t> factors;
+    while (size % 4 == 0) {
+        factors.push_back(4);
+        size /= 4;
+    }
+    if (size % 2 == 0) {
+        factors.push_back(2);
+        size /= 2;
+    }
+    for (std::size_t factor = 3; factor * factor <= size; factor += 2) {
+        while (size % factor == 0) {
+            factors.push_back(factor);
+            size /= factor;
+        }
+    }
+    if (size > 1) {
+        factors.push_back(size);
+    }
+    return factors;
+}
+
+}  // namespace
+
+FftPlan::FftPlan(std::size_t size) : length(size) {
+    if (size == 0) {
+        throw std::invalid_argument("FFT size has to be positive");
+    }
+
+    const std::vector<std::size_t> factors = radices(size);
+    if (std::all_of(factors.begin(), factors.end(), [](std::size_t factor) { return factor <= MAX_RADIX; })) {
+        std::size_t span = 1;
+        for (std::size_t radix : factors) {
+            stages.push_back(Stage{radix, span, size / (span * radix)});
+            span *= radix;
+        }
+        roots_real.resize(size);
+        roots_imag.resize(size);
+        // Angles in [-pi, pi] rounded from long double, so that every root is within an ulp.
+        for (std::size_t t = 0; t < size; ++t) {
+            const long double turn = 2 * t <= size ? static_cast<long double>(t) : -static_cast<long double>(size - t);
+            const double angle     = static_cast<double>(2 * PI * turn / static_cast<long double>(size));
+            roots_real[t]          = std::cos(angle);
+            roots_imag[t]          = -std::sin(angle);
+        }
+        return;
+    }
+
+    // X[k] = w[k] * sum x[j] w[j] conj(w[k - j]) with the chirp w[k] = exp(-pi i k^2 / n),
+    // a cyclic convolution once it is padded to at least 2n - 1 values.
+    std::size_t padded = 1;
+    while (padded < 2 * size - 1) {
+        padded *= 2;
+    }
+    convolution = std::make_unique<const FftPlan>(padded);
+    chirp_real.resize(size);
+    chirp_imag.resize(size);
+    // k^2 mod 2n keeps the angle exact for large k.
+    std::size_t square = 0;
+    for (std::size_t k = 0; k < size; ++k) {
+        const long double angle = PI * static_cast<long double>(square) / static_cast<long double>(size);
+        chirp_real[k]           = static_cast<double>(std::cos(angle));
+        chirp_imag[k]           = static_cast<double>(-std::sin(angle));
+        square                  = (square + 2 * k + 1) % (2 * size);
+    }
+    kernel_real.assign(padded, 0);
+    kernel_imag.assign(padded, 0);
+    for (std::size_t k = 0; k < size; ++k) {
+        kernel_real[k]                    = chirp_real[k];
+        kernel_imag[k]                    = -chirp_imag[k];
+        kernel_real[(padded - k) % padded] = chirp_real[k];
+        kernel_imag[(padded - k) % padded] = -chirp_imag[k];
+    }
+    convolution->execute(kernel_real.data(), kernel_imag.data(), kernel_real.data(), kernel_imag.data());
+}
+
+std::size_t FftPlan::size() const {
+    return length;
+}
+
+std::size_t FftPlan::scratch_size() const {
+    if (convolution) {
+        return 2 * convolution->size() + convolution->scratch_size();
+    }
+    return 2 * length;
+}
+
+void FftPlan::execute(const double* in_real, const double* in_imag, double* out_real, double* out_imag,
+                      FftDirection direction) const {
+    std::vector<double> scratch(scratch_size());
+    execute(in_real, in_imag, out_real, out_imag, direction, scratch);
+}
+
+void FftPlan::execute(const double* in_real, const double* in_imag, double* out_real, double* out_imag,
+                      FftDirection direction, std::span<double> scratch) const {
+    if (scratch.size() < scratch_size()) {
+        throw std::invalid_argument("not enough scratch space");
+    }
+    if (convolution) {
+        execute_bluestein(in_real, in_imag, out_real, out_imag, direction, scratch);
+    } else {
+        execute_stages(in_real, in_imag, out_real, out_imag, direction, scratch);
+    }
+}
+
+void FftPlan::execute(const ComplexArray& in, ComplexArray& out, FftDirection direction) const {
+    if (in.size() != length || out.size() != length) {
+        throw std::invalid_argument("array size does not match the plan");
+    }
+    execute(in.real_data(), in.imag_data(), out.real_data(), out.imag_data(), direction);
+}
+
+void FftPlan::execute_batch(ThreadPool& pool, std::size_t count, const double* in_real, const double* in_imag,
+                            double* out_real, double* out_imag, FftDirection direction) const {
+    // A few chunks per worker balance the load, every chunk allocates scratch space once.
+    const std::size_t chunks = std::min(count, 4 * pool.size());
+    pool.parallel_for(chunks, [&](std::size_t chunk) {
+        std::vector<double> scratch(scratch_size());
+        for (std::size_t i = chunk * count / chunks; i < (chunk + 1) * count / chunks; ++i) {
+            const std::size_t offset = i * length;
+            execute(in_real + offset, in_imag + offset, out_real + offset, out_imag + offset, direction, scratch);
+        }
+    });
+}
+
+void FftPlan::execute_batch(ThreadPool& pool, const ComplexArray& in, ComplexArray& out,
+                            FftDirection direction) const {
+    if (in.size() % length != 0 || out.size() != in.size()) {
+        throw std::invalid_argument("array size does not match the plan");
+    }
+    execute_batch(pool, in.size() / length, in.real_data(), in.imag_data(), out.real_data(), out.imag_data(),
+                  direction);
+}
+
+void FftPlan::execute_stages(const double* in_real, const double* in_imag, double* out_real, double* out_imag,
+                             FftDirection direction, std::span<double> scratch) const {
+    double* scratch_real = scratch.data();
+    double* scratch_imag = scratch.data() + length;
+
+    // Passes alternate between the output and the scratch space and the last one writes
+    // the output. In place, an odd number of passes has to start from a copy.
+    const double* x_real = in_real;
+    const double* x_imag = in_imag;
+    if (stages.size() % 2 == 1 && in_real == out_real) {
+        std::copy(in_real, in_real + length, scratch_real);
+        std::copy(in_imag, in_imag + length, scratch_imag);
+        x_real = scratch_real;
+        x_imag = scratch_imag;
+    } else if (stages.empty() && in_real != out_real) {
+        std::copy(in_real, in_real + length, out_real);
+        std::copy(in_imag, in_imag + length, out_imag);
+    }
+
+    Pass pass = {0, 0, direction == FftDirection::Forward ? 1.0 : -1.0, roots_real.data(), roots_imag.data(),
+                 x_real, x_imag, nullptr, nullptr};
+    for (std::size_t i = 0; i < stages.size(); ++i) {
+        const bool writes_output = (stages.size() - 1 - i) % 2 == 0;
+        pass.span                = stages[i].span;
+        pass.stride              = stages[i].stride;
+        pass.y_real              = writes_output ? out_real : scratch_real;
+        pass.y_imag              = writes_output ? out_imag : scratch_imag;
+        switch (stages[i].radix) {
+        case 2:
+            radix2_pass(pass);
+            break;
+        case 3:
+            radix3_pass(pass);
+            break;
+        case 4:
+            radix4_pass(pass);
+            break;
+        default:
+            generic_pass(pass, stages[i].radix);
+            break;
+        }
+        pass.x_real = pass.y_real;
+        pass.x_imag = pass.y_imag;
+    }
+
+    if (direction == FftDirection::Inverse && length > 1) {
+        scale_planes(length, 1.0 / static_cast<double>(length), out_real, out_imag);
+    }
+}
+
+void FftPlan::execute_bluestein(const double* in_real, const double* in_imag, double* out_real, double* out_imag,
+                                FftDirection direction, std::span<double> scratch) const {
+    // The inverse transform is the conjugate of the forward transform of the conjugate.
+    const std::size_t padded = convolution->size();
+    const double sign        = direction == FftDirection::Forward ? 1 : -1;
+    double* a_real           = scratch.data();
+    double* a_imag           = scratch.data() + padded;
+
+    for (std::size_t k = 0; k < length; ++k) {
+        const double value_imag = sign * in_imag[k];
+        a_real[k]               = in_real[k] * chirp_real[k] - value_imag * chirp_imag[k];
+        a_imag[k]               = value_imag * chirp_real[k] + in_real[k] * chirp_imag[k];
+    }
+    std::fill(a_real + length, a_real + padded, 0.0);
+    std::fill(a_imag + length, a_imag + padded, 0.0);
+
+    const std::span<double> rest = scratch.subspan(2 * padded);
+    convolution->execute(a_real, a_imag, a_real, a_imag, FftDirection::Forward, rest);
+    multiply_planes(padded, a_real, a_imag, kernel_real.data(), kernel_imag.data(), a_real, a_imag);
+    convolution->execute(a_real, a_imag, a_real, a_imag, FftDirection::Inverse, rest);
+
+    const double scale = direction == FftDirection::Forward ? 1 : 1.0 / static_cast<double>(length);
+    for (std::size_t k = 0; k < length; ++k) {
+        const double result_real = a_real[k] * chirp_real[k] - a_imag[k] * chirp_imag[k];
+        const double result_imag = a_imag[k] * chirp_real[k] + a_real[k] * chirp_imag[k];
+        out_real[k]              = scale * result_real;
+        out_imag[k]              = scale * sign * result_imag;
+    }
+}
+
+std::shared_ptr<const FftPlan> FftPlanCache::plan(std::size_t size) {
+    {
+        std::lock_guard lock(mutex);
+        const auto found = plans.find(size);
+        if (found != plans.end()) {
+            return found->second;
+        }
+    }
+    // Building large plans takes a while, other sizes stay available meanwhile.
+    std::shared_ptr<const FftPlan> plan = std::make_shared<const FftPlan>(size);
+    std::lock_guard lock(mutex);
+    return plans.try_emplace(size, std::move(plan)).first->second;
+}
+
+std::size_t FftPlanCache::size() const {
+    std::lock_guard lock(mutex);
+    return plans.size();
+}
+
+void FftPlanCache::clear() {
+    std::lock_guard lock(mutex);
+    plans.clear();
+}
+
+FftPlanCache& fft_plans() {
+    static FftPlanCache cache;
+    return cache;
+}
+
+namespace {
+
+ComplexArray transform(const ComplexArray& values, FftDirection direction) {
+    ComplexArray result(values.size());
+    if (values.size() > 0) {
+        fft_plans().plan(values.size())->execute(values, result, direction);
+    }
+    return result;
+}
+
+}  // namespace
+
+ComplexArray fft(const ComplexArray& values) {
+    return transform(values, FftDirection::Forward);
+}
+
+ComplexArray inverse_fft(const ComplexArray& values) {
+    return transform(values, FftDirection::Inverse);
+}
+
+std::vector<Complex> fft(std::span<const Complex> values) {
+    return transform(ComplexArray(values), FftDirection::Forward).to_vector();
+}
+
+std::vector<Complex> inverse_fft(std::span<const Complex> values) {
+    return transform(ComplexArray(values), FftDirection::Inverse).to_vector();
+}
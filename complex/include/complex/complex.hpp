@@ -1,66 +1,314 @@
 #ifndef COMPLEX_COMPLEX_HPP
 #define COMPLEX_COMPLEX_HPP
 
+#include <charconv>
 #include <cmath>
 #include <iostream>
-#include <sstream>
+#include <limits>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
 
-class Complex {
+// Tolerance of operator== for every supported precision.
+template <typename T>
+struct ComplexEpsilon;
+
+template <>
+struct ComplexEpsilon<float> {
+    static constexpr float value = 1e-4F;
+};
+
+template <>
+struct ComplexEpsilon<double> {
+    static constexpr double value = 1e-6;
+};
+
+template <>
+struct ComplexEpsilon<long double> {
+    static constexpr long double value = 1e-9L;
+};
+
+// Header-only so that arithmetic inlines into callers. Everything except abs, str
+// and stream output can be used in constant expressions. Binary operators are
+// hidden friends, so mixing with implicitly converted reals keeps working.
+template <typename T>
+class BasicComplex {
 public:
-    Complex() = default;
+    using value_type = T;
 
-    Complex(double real);
+    BasicComplex() = default;
 
-    Complex(double real, double imag);
+    constexpr BasicComplex(T real) noexcept;
 
-    Complex(const Complex& number) = default;
+    constexpr BasicComplex(T real, T imag) noexcept;
 
-    Complex& operator=(Complex&& value) = default;
+    // Converts between precisions, narrowing conversions have to be explicit.
+    template <typename U>
+    constexpr explicit(sizeof(U) > sizeof(T)) BasicComplex(const BasicComplex<U>& number) noexcept;
 
-    double real() const;
+    constexpr T real() const noexcept;
 
-    double imag() const;
+    constexpr T imag() const noexcept;
 
-    double abs() const;
+    T abs() const noexcept;
 
     std::string str() const;
 
-    Complex operator-() const;
-    Complex operator~() const;
+    constexpr BasicComplex operator-() const noexcept;
+    constexpr BasicComplex operator~() const noexcept;
+
+    constexpr BasicComplex& operator+=(const BasicComplex& number) noexcept;
+    constexpr BasicComplex& operator-=(const BasicComplex& number) noexcept;
+    constexpr BasicComplex& operator*=(const BasicComplex& number) noexcept;
+    constexpr BasicComplex& operator/=(const BasicComplex& number) noexcept;
+
+    constexpr BasicComplex inverse() const noexcept;
+
+    friend constexpr BasicComplex operator+(const BasicComplex& left, const BasicComplex& right) noexcept {
+        return BasicComplex(left) += right;
+    }
 
-    Complex& operator+=(const Complex& number);
-    Complex& operator-=(const Complex& number);
-    Complex& operator*=(const Complex& number);
-    Complex& operator/=(const Complex& number);
+    friend constexpr BasicComplex operator-(const BasicComplex& left, const BasicComplex& right) noexcept {
+        return BasicComplex(left) -= right;
+    }
 
-    Complex inverse() const;
+    friend constexpr BasicComplex operator*(const BasicComplex& left, const BasicComplex& right) noexcept {
+        return BasicComplex(left) *= right;
+    }
 
-    friend Complex operator+(const Complex& left, const Complex& right);
-    friend Complex operator-(const Complex& left, const Complex& right);
-    friend Complex operator*(const Complex& left, const Complex& right);
-    friend Complex operator/(const Complex& left, const Complex& right);
+    friend constexpr BasicComplex operator/(const BasicComplex& left, const BasicComplex& right) noexcept {
+        return BasicComplex(left) /= right;
+    }
 
-    friend bool operator==(const Complex& left, const Complex& right);
-    friend bool operator!=(const Complex& left, const Complex& right);
+    friend constexpr bool operator==(const BasicComplex& left, const BasicComplex& right) noexcept {
+        return (absolute(left._real - right._real) < EPS) && (absolute(left._imag - right._imag) < EPS);
+    }
 
-    friend std::ostream& operator<<(std::ostream& out, const Complex& number);
+    friend constexpr bool operator!=(const BasicComplex& left, const BasicComplex& right) noexcept {
+        return !(left == right);
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const BasicComplex& number) {
+        char buffer[STR_CHARS];
+        const char* end = number.write_str(buffer);
+        return out << std::string_view(buffer, end - buffer);
+    }
 
 private:
-    static const double EPS;
+    static constexpr T EPS = ComplexEpsilon<T>::value;
+
+    // Enough for two parts in the six digit format of str, "(-1.23457e-4951; ...)".
+    static constexpr std::size_t STR_CHARS = 64;
+
+    char* write_str(char* buffer) const noexcept;
 
-    double _real;
-    double _imag;
+    // std::abs is not constexpr before C++23.
+    static constexpr T absolute(T value) noexcept;
+
+    T _real;
+    T _imag;
 };
 
-Complex operator+(const Complex& left, const Complex& right);
-Complex operator-(const Complex& left, const Complex& right);
-Complex operator*(const Complex& left, const Complex& right);
-Complex operator/(const Complex& left, const Complex& right);
+using Complex = BasicComplex<double>;
+
+// Writes "(re; im)" into [first, last) like std::to_chars: the shortest text that
+// parses back to the same parts, or the given format and precision. On success ptr is
+// one past the last written character, otherwise ec is std::errc::value_too_large.
+template <typename T>
+std::to_chars_result to_chars(char* first, char* last, const BasicComplex<T>& number);
+
+template <typename T>
+std::to_chars_result to_chars(char* first, char* last, const BasicComplex<T>& number, std::chars_format format,
+                              int precision);
+
+// Reads "(re; im)" with optional spaces inside the brackets, std::from_chars conventions:
+// on failure ptr is first, ec is std::errc::invalid_argument and number is unchanged.
+// A part that does not fit into T yields std::errc::result_out_of_range.
+template <typename T>
+std::from_chars_result from_chars(const char* first, const char* last, BasicComplex<T>& number);
+
+// Upper bound of the to_chars output in the shortest format.
+template <typename T>
+constexpr std::size_t COMPLEX_CHARS_MAX = 2 * (std::numeric_limits<T>::max_digits10 + 10) + 4;
+
+static_assert(std::is_trivially_copyable_v<BasicComplex<float>>);
+static_assert(std::is_trivially_copyable_v<BasicComplex<double>>);
+static_assert(std::is_trivially_copyable_v<BasicComplex<long double>>);
+
+template <typename T>
+constexpr BasicComplex<T>::BasicComplex(T real) noexcept : _real(real), _imag(0) {}
+
+template <typename T>
+constexpr BasicComplex<T>::BasicComplex(T real, T imag) noexcept : _real(real), _imag(imag) {}
+
+template <typename T>
+template <typename U>
+constexpr BasicComplex<T>::BasicComplex(const BasicComplex<U>& number) noexcept
+    : _real(static_cast<T>(number.real())), _imag(static_cast<T>(number.imag())) {}
+
+template <typename T>
+constexpr T BasicComplex<T>::real() const noexcept {
+    return _real;
+}
+
+template <typename T>
+constexpr T BasicComplex<T>::imag() const noexcept {
+    return _imag;
+}
+
+template <typename T>
+T BasicComplex<T>::abs() const noexcept {
+    return std::hypot(_real, _imag);
+}
+
+template <typename T>
+std::string BasicComplex<T>::str() const {
+    char buffer[STR_CHARS];
+    return std::string(buffer, write_str(buffer));
+}
+
+// Six significant digits in the general format, the same text as the default std::ostream formatting.
+template <typename T>
+char* BasicComplex<T>::write_str(char* buffer) const noexcept {
+    return to_chars(buffer, buffer + STR_CHARS, *this, std::chars_format::general, 6).ptr;
+}
+
+template <typename T>
+constexpr BasicComplex<T> BasicComplex<T>::operator-() const noexcept {
+    return BasicComplex(-_real, -_imag);
+}
+
+template <typename T>
+constexpr BasicComplex<T> BasicComplex<T>::operator~() const noexcept {
+    return BasicComplex(_real, -_imag);
+}
+
+template <typename T>
+constexpr BasicComplex<T> BasicComplex<T>::inverse() const noexcept {
+    const T square_abs = _real * _real + _imag * _imag;
+    return BasicComplex(_real / square_abs, -_imag / square_abs);
+}
+
+template <typename T>
+constexpr BasicComplex<T>& BasicComplex<T>::operator+=(const BasicComplex& number) noexcept {
+    _real += number._real;
+    _imag += number._imag;
+    return *this;
+}
+
+template <typename T>
+constexpr BasicComplex<T>& BasicComplex<T>::operator-=(const BasicComplex& number) noexcept {
+    _real -= number._real;
+    _imag -= number._imag;
+    return *this;
+}
+
+template <typename T>
+constexpr BasicComplex<T>& BasicComplex<T>::operator*=(const BasicComplex& number) noexcept {
+    const T real = _real * number._real - _imag * number._imag;
+    _imag        = _imag * number._real + _real * number._imag;
+    _real        = real;
+    return *this;
+}
+
+// Smith's algorithm: divides by the larger part of the divisor first to avoid overflow.
+template <typename T>
+constexpr BasicComplex<T>& BasicComplex<T>::operator/=(const BasicComplex& number) noexcept {
+    const T real = _real;
+    if (absolute(number._imag) < absolute(number._real)) {
+        const T prt1 = number._imag / number._real;
+        const T prt2 = number._real + number._imag * prt1;
+        _real        = (real + _imag * prt1) / prt2;
+        _imag        = (_imag - real * prt1) / prt2;
+    } else {
+        const T prt1 = number._real / number._imag;
+        const T prt2 = number._imag + number._real * prt1;
+        _real        = (real * prt1 + _imag) / prt2;
+        _imag        = (_imag * prt1 - real) / prt2;
+    }
+    return *this;
+}
+
+template <typename T>
+constexpr T BasicComplex<T>::absolute(T value) noexcept {
+    return value < 0 ? -value : value;
+}
+
+// Shared by both to_chars overloads, format_part writes one part with std::to_chars.
+template <typename T, typename FormatPart>
+std::to_chars_result write_complex_chars(char* first, char* last, const BasicComplex<T>& number,
+                                         const FormatPart& format_part) {
+    const std::to_chars_result too_large = {last, std::errc::value_too_large};
+    if (last - first < 1) {
+        return too_large;
+    }
+    *first++ = '(';
+
+    std::to_chars_result result = format_part(first, last, number.real());
+    if (result.ec != std::errc() || last - result.ptr < 2) {
+        return too_large;
+    }
+    *result.ptr++ = ';';
+    *result.ptr++ = ' ';
+    result        = format_part(result.ptr, last, number.imag());
+    if (result.ec != std::errc() || last - result.ptr < 1) {
+        return too_large;
+    }
+    *result.ptr++ = ')';
+    return result;
+}
+
+template <typename T>
+std::to_chars_result to_chars(char* first, char* last, const BasicComplex<T>& number) {
+    return write_complex_chars(first, last, number,
+                               [](char* begin, char* end, T part) { return std::to_chars(begin, end, part); });
+}
+
+template <typename T>
+std::to_chars_result to_chars(char* first, char* last, const BasicComplex<T>& number, std::chars_format format,
+                              int precision) {
+    return write_complex_chars(first, last, number, [&](char* begin, char* end, T part) {
+        return std::to_chars(begin, end, part, format, precision);
+    });
+}
 
-bool operator==(const Complex& left, const Complex& right);
-bool operator!=(const Complex& left, const Complex& right);
+template <typename T>
+std::from_chars_result from_chars(const char* first, const char* last, BasicComplex<T>& number) {
+    const std::from_chars_result invalid = {first, std::errc::invalid_argument};
+    const auto skip_spaces               = [last](const char* position) {
+        while (position != last && *position == ' ') {
+            ++position;
+        }
+        return position;
+    };
 
-std::ostream& operator<<(std::ostream& out, const Complex& number);
+    if (first == last || *first != '(') {
+        return invalid;
+    }
+    T real                                  = 0;
+    const std::from_chars_result real_chars = std::from_chars(skip_spaces(first + 1), last, real);
+    if (real_chars.ec == std::errc::invalid_argument) {
+        return invalid;
+    }
+    const char* position = skip_spaces(real_chars.ptr);
+    if (position == last || *position != ';') {
+        return invalid;
+    }
+    T imag                                  = 0;
+    const std::from_chars_result imag_chars = std::from_chars(skip_spaces(position + 1), last, imag);
+    if (imag_chars.ec == std::errc::invalid_argument) {
+        return invalid;
+    }
+    position = skip_spaces(imag_chars.ptr);
+    if (position == last || *position != ')') {
+        return invalid;
+    }
+    if (real_chars.ec != std::errc() || imag_chars.ec != std::errc()) {
+        return {position + 1, std::errc::result_out_of_range};
+    }
+    number = BasicComplex<T>(real, imag);
+    return {position + 1, std::errc()};
+}
 
 #endif  // COMPLEX_COMPLEX_HPP
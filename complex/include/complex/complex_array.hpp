@@ -0,0 +1,122 @@
+#ifndef COMPLEX_COMPLEX_ARRAY_HPP
+#define COMPLEX_COMPLEX_ARRAY_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <vector>
+
+#include "complex/complex.hpp"
+
+// Elementwise kernels over complex values stored as separate planes of real and
+// imaginary parts, for every precision of BasicComplex. The output may alias any of the
+// operands. The float and double kernels are built for SSE2, AVX2 and AVX-512 on x86-64
+// and the widest version supported by the CPU is picked at load time.
+void add_planes(std::size_t n, const float* left_real, const float* left_imag, const float* right_real,
+                const float* right_imag, float* real, float* imag);
+void add_planes(std::size_t n, const double* left_real, const double* left_imag, const double* right_real,
+                const double* right_imag, double* real, double* imag);
+void add_planes(std::size_t n, const long double* left_real, const long double* left_imag,
+                const long double* right_real, const long double* right_imag, long double* real, long double* imag);
+void subtract_planes(std::size_t n, const float* left_real, const float* left_imag, const float* right_real,
+                     const float* right_imag, float* real, float* imag);
+void subtract_planes(std::size_t n, const double* left_real, const double* left_imag, const double* right_real,
+                     const double* right_imag, double* real, double* imag);
+void subtract_planes(std::size_t n, const long double* left_real, const long double* left_imag,
+                     const long double* right_real, const long double* right_imag, long double* real,
+                     long double* imag);
+void multiply_planes(std::size_t n, const float* left_real, const float* left_imag, const float* right_real,
+                     const float* right_imag, float* real, float* imag);
+void multiply_planes(std::size_t n, const double* left_real, const double* left_imag, const double* right_real,
+                     const double* right_imag, double* real, double* imag);
+void multiply_planes(std::size_t n, const long double* left_real, const long double* left_imag,
+                     const long double* right_real, const long double* right_imag, long double* real,
+                     long double* imag);
+// Smith's division, rounds exactly like BasicComplex::operator/=.
+void divide_planes(std::size_t n, const float* left_real, const float* left_imag, const float* right_real,
+                   const float* right_imag, float* real, float* imag);
+void divide_planes(std::size_t n, const double* left_real, const double* left_imag, const double* right_real,
+                   const double* right_imag, double* real, double* imag);
+void divide_planes(std::size_t n, const long double* left_real, const long double* left_imag,
+                   const long double* right_real, const long double* right_imag, long double* real, long double* imag);
+void negate_planes(std::size_t n, const float* operand_real, const float* operand_imag, float* real, float* imag);
+void negate_planes(std::size_t n, const double* operand_real, const double* operand_imag, double* real, double* imag);
+void negate_planes(std::size_t n, const long double* operand_real, const long double* operand_imag, long double* real,
+                   long double* imag);
+void conjugate_planes(std::size_t n, const float* operand_real, const float* operand_imag, float* real, float* imag);
+void conjugate_planes(std::size_t n, const double* operand_real, const double* operand_imag, double* real,
+                      double* imag);
+void conjugate_planes(std::size_t n, const long double* operand_real, const long double* operand_imag,
+                      long double* real, long double* imag);
+void abs_planes(std::size_t n, const float* operand_real, const float* operand_imag, float* abs);
+void abs_planes(std::size_t n, const double* operand_real, const double* operand_imag, double* abs);
+void abs_planes(std::size_t n, const long double* operand_real, const long double* operand_imag, long double* abs);
+
+// Array of complex numbers with 64-byte aligned real and imaginary planes.
+class ComplexArray {
+public:
+    static constexpr std::size_t ALIGNMENT = 64;
+
+    ComplexArray() = default;
+
+    explicit ComplexArray(std::size_t size);
+
+    ComplexArray(std::span<const Complex> values);
+
+    ComplexArray(const ComplexArray& array);
+    ComplexArray(ComplexArray&& array) noexcept = default;
+
+    ComplexArray& operator=(const ComplexArray& array);
+    ComplexArray& operator=(ComplexArray&& array) noexcept = default;
+
+    std::size_t size() const;
+
+    Complex operator[](std::size_t index) const;
+
+    void set(std::size_t index, const Complex& value);
+
+    double* real_data();
+    const double* real_data() const;
+
+    double* imag_data();
+    const double* imag_data() const;
+
+    std::vector<Complex> to_vector() const;
+
+    std::vector<double> abs() const;
+
+    ComplexArray operator-() const;
+    ComplexArray operator~() const;
+
+    // Binary operations require arrays of the same size.
+    ComplexArray& operator+=(const ComplexArray& array);
+    ComplexArray& operator-=(const ComplexArray& array);
+    ComplexArray& operator*=(const ComplexArray& array);
+    ComplexArray& operator/=(const ComplexArray& array);
+
+    friend ComplexArray operator+(const ComplexArray& left, const ComplexArray& right);
+    friend ComplexArray operator-(const ComplexArray& left, const ComplexArray& right);
+    friend ComplexArray operator*(const ComplexArray& left, const ComplexArray& right);
+    friend ComplexArray operator/(const ComplexArray& left, const ComplexArray& right);
+
+private:
+    struct AlignedDelete {
+        void operator()(double* data) const;
+    };
+
+    using Plane = std::unique_ptr<double[], AlignedDelete>;
+
+    static Plane allocate(std::size_t size);
+
+    std::size_t length = 0;
+    Plane real_plane;
+    Plane imag_plane;
+};
+
+ComplexArray operator+(const ComplexArray& left, const ComplexArray& right);
+ComplexArray operator-(const ComplexArray& left, const ComplexArray& right);
+ComplexArray operator*(const ComplexArray& left, const ComplexArray& right);
+ComplexArray operator/(const ComplexArray& left, const ComplexArray& right);
+
+#endif  // COMPLEX_COMPLEX_ARRAY_HPP
@@ -0,0 +1,21 @@
+#ifndef COMPLEX_COMPLEX_FORMAT_HPP
+#define COMPLEX_COMPLEX_FORMAT_HPP
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "complex/complex.hpp"
+#include "complex/complex_array.hpp"
+
+// Appends every value in the shortest round-trip format of to_chars, one per line.
+void format_complex(std::span<const Complex> values, std::string& out);
+void format_complex(const ComplexArray& values, std::string& out);
+
+// Reads "(re; im)" values separated by whitespace, the inverse of format_complex.
+// Throws std::invalid_argument with the offset of the first malformed value.
+std::vector<Complex> parse_complex(std::string_view text);
+ComplexArray parse_complex_array(std::string_view text);
+
+#endif  // COMPLEX_COMPLEX_FORMAT_HPP
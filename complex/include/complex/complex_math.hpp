@@ -0,0 +1,199 @@
+#ifndef COMPLEX_COMPLEX_MATH_HPP
+#define COMPLEX_COMPLEX_MATH_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "complex/complex.hpp"
+#include "complex/complex_array.hpp"
+
+// Elementary functions of BasicComplex on the principal branch: log and sqrt have their
+// branch cut along the negative real axis, pow(z, w) is exp(w * log(z)).
+//
+// Error bounds are normwise, |computed - exact| <= k * u * |exact| with the unit
+// roundoff u = 2^-53 of double. They were measured against long double references for
+// |Re z| <= 700 with |Im z| <= 1e6 (exp), |Re z| <= 1e6 with |Im z| <= 700 (sin, cos)
+// and 1e-100 <= |z| <= 1e100 (log, sqrt):
+//
+//   function   Accurate   Fast
+//   exp        k = 3      k = 4
+//   log        k = 2      k = 3
+//   sqrt       k = 3      k = 3
+//   sin, cos   k = 4      k = 4
+//
+// For log the bound is relative to max(|log z|, 1) instead, log|z| cancels close to the
+// unit circle. pow has no fixed bound, its error grows with |w * log z| through exp.
+// The integer pow multiplies by squaring and has the usual bound of a product of that
+// many factors.
+//
+// The scalar functions below are the accurate tier, built on the standard library. The
+// plane and array forms can also run the fast tier: polynomial kernels without library
+// calls that vectorize like the kernels of complex_array.hpp. Their domains are
+// |Re z| <= 708 with |Im z| <= 1e6 for exp, |Re z| <= 1e6 with |Im z| <= 708 for sin and
+// cos and 1e-150 <= |z| <= 1e150 for log and sqrt. Elements outside, infinities and NaN
+// included, fall back to the accurate tier. Float planes are computed in double, long
+// double planes always use the accurate tier.
+enum class MathAccuracy { Accurate, Fast };
+
+template <typename T>
+BasicComplex<T> exp(const BasicComplex<T>& number);
+
+template <typename T>
+BasicComplex<T> log(const BasicComplex<T>& number);
+
+template <typename T>
+BasicComplex<T> sqrt(const BasicComplex<T>& number);
+
+template <typename T>
+BasicComplex<T> sin(const BasicComplex<T>& number);
+
+template <typename T>
+BasicComplex<T> cos(const BasicComplex<T>& number);
+
+// pow(0, w) is 1 for w = 0 and 0 for Re w > 0.
+template <typename T>
+BasicComplex<T> pow(const BasicComplex<T>& base, const BasicComplex<T>& exponent);
+
+// Exponentiation by squaring: floor(log2 |n|) + popcount(|n|) - 1 multiplications, a
+// negative n raises base.inverse(). pow(z, 0) is 1 for every z, NaN included.
+template <typename T>
+BasicComplex<T> pow(const BasicComplex<T>& base, std::int32_t exponent);
+
+void exp_planes(std::size_t n, const float* operand_real, const float* operand_imag, float* real, float* imag,
+                MathAccuracy accuracy = MathAccuracy::Accurate);
+void exp_planes(std::size_t n, const double* operand_real, const double* operand_imag, double* real, double* imag,
+                MathAccuracy accuracy = MathAccuracy::Accurate);
+void exp_planes(std::size_t n, const long double* operand_real, const long double* operand_imag, long double* real,
+                long double* imag, MathAccuracy accuracy = MathAccuracy::Accurate);
+void log_planes(std::size_t n, const float* operand_real, const float* operand_imag, float* real, float* imag,
+                MathAccuracy accuracy = MathAccuracy::Accurate);
+void log_planes(std::size_t n, const double* operand_real, const double* operand_imag, double* real, double* imag,
+                MathAccuracy accuracy = MathAccuracy::Accurate);
+void log_planes(std::size_t n, const long double* operand_real, const long double* operand_imag, long double* real,
+                long double* imag, MathAccuracy accuracy = MathAccuracy::Accurate);
+void sqrt_planes(std::size_t n, const float* operand_real, const float* operand_imag, float* real, float* imag,
+                 MathAccuracy accuracy = MathAccuracy::Accurate);
+void sqrt_planes(std::size_t n, const double* operand_real, const double* operand_imag, double* real, double* imag,
+                 MathAccuracy accuracy = MathAccuracy::Accurate);
+void sqrt_planes(std::size_t n, const long double* operand_real, const long double* operand_imag, long double* real,
+                 long double* imag, MathAccuracy accuracy = MathAccuracy::Accurate);
+void sin_planes(std::size_t n, const float* operand_real, const float* operand_imag, float* real, float* imag,
+                MathAccuracy accuracy = MathAccuracy::Accurate);
+void sin_planes(std::size_t n, const double* operand_real, const double* operand_imag, double* real, double* imag,
+                MathAccuracy accuracy = MathAccuracy::Accurate);
+void sin_planes(std::size_t n, const long double* operand_real, const long double* operand_imag, long double* real,
+                long double* imag, MathAccuracy accuracy = MathAccuracy::Accurate);
+void cos_planes(std::size_t n, const float* operand_real, const float* operand_imag, float* real, float* imag,
+                MathAccuracy accuracy = MathAccuracy::Accurate);
+void cos_planes(std::size_t n, const double* operand_real, const double* operand_imag, double* real, double* imag,
+                MathAccuracy accuracy = MathAccuracy::Accurate);
+void cos_planes(std::size_t n, const long double* operand_real, const long double* operand_imag, long double* real,
+                long double* imag, MathAccuracy accuracy = MathAccuracy::Accurate);
+void pow_planes(std::size_t n, const float* base_real, const float* base_imag, const float* exponent_real,
+                const float* exponent_imag, float* real, float* imag, MathAccuracy accuracy = MathAccuracy::Accurate);
+void pow_planes(std::size_t n, const double* base_real, const double* base_imag, const double* exponent_real,
+                const double* exponent_imag, double* real, double* imag,
+                MathAccuracy accuracy = MathAccuracy::Accurate);
+void pow_planes(std::size_t n, const long double* base_real, const long double* base_imag,
+                const long double* exponent_real, const long double* exponent_imag, long double* real,
+                long double* imag, MathAccuracy accuracy = MathAccuracy::Accurate);
+// Integer powers, rounded exactly like the scalar pow of the same precision.
+void pow_planes(std::size_t n, const float* base_real, const float* base_imag, std::int32_t exponent, float* real,
+                float* imag);
+void pow_planes(std::size_t n, const double* base_real, const double* base_imag, std::int32_t exponent, double* real,
+                double* imag);
+void pow_planes(std::size_t n, const long double* base_real, const long double* base_imag, std::int32_t exponent,
+                long double* real, long double* imag);
+
+ComplexArray exp(const ComplexArray& array, MathAccuracy accuracy = MathAccuracy::Accurate);
+ComplexArray log(const ComplexArray& array, MathAccuracy accuracy = MathAccuracy::Accurate);
+ComplexArray sqrt(const ComplexArray& array, MathAccuracy accuracy = MathAccuracy::Accurate);
+ComplexArray sin(const ComplexArray& array, MathAccuracy accuracy = MathAccuracy::Accurate);
+ComplexArray cos(const ComplexArray& array, MathAccuracy accuracy = MathAccuracy::Accurate);
+// Throws std::invalid_argument for arrays of different sizes.
+ComplexArray pow(const ComplexArray& base, const ComplexArray& exponent,
+                 MathAccuracy accuracy = MathAccuracy::Accurate);
+ComplexArray pow(const ComplexArray& base, std::int32_t exponent);
+
+template <typename T>
+BasicComplex<T> exp(const BasicComplex<T>& number) {
+    const T magnitude = std::exp(number.real());
+    // A real argument keeps an exactly real result, even when magnitude is infinite.
+    if (number.imag() == 0) {
+        return BasicComplex<T>(magnitude, number.imag());
+    }
+    return BasicComplex<T>(magnitude * std::cos(number.imag()), magnitude * std::sin(number.imag()));
+}
+
+template <typename T>
+BasicComplex<T> log(const BasicComplex<T>& number) {
+    return BasicComplex<T>(std::log(number.abs()), std::atan2(number.imag(), number.real()));
+}
+
+// Kahan's formula: the part computed from the square root never suffers cancellation
+// and the other one is derived from it with a division.
+template <typename T>
+BasicComplex<T> sqrt(const BasicComplex<T>& number) {
+    const T real = number.real();
+    const T imag = number.imag();
+    if (real == 0 && imag == 0) {
+        return BasicComplex<T>(0, imag);
+    }
+    const T root = std::sqrt((std::abs(real) + number.abs()) / 2);
+    if (real >= 0) {
+        return BasicComplex<T>(root, imag / (2 * root));
+    }
+    return BasicComplex<T>(std::abs(imag) / (2 * root), std::copysign(root, imag));
+}
+
+template <typename T>
+BasicComplex<T> sin(const BasicComplex<T>& number) {
+    return BasicComplex<T>(std::sin(number.real()) * std::cosh(number.imag()),
+                           std::cos(number.real()) * std::sinh(number.imag()));
+}
+
+template <typename T>
+BasicComplex<T> cos(const BasicComplex<T>& number) {
+    return BasicComplex<T>(std::cos(number.real()) * std::cosh(number.imag()),
+                           -(std::sin(number.real()) * std::sinh(number.imag())));
+}
+
+template <typename T>
+BasicComplex<T> pow(const BasicComplex<T>& base, const BasicComplex<T>& exponent) {
+    if (base.real() == 0 && base.imag() == 0) {
+        if (exponent.real() == 0 && exponent.imag() == 0) {
+            return BasicComplex<T>(1);
+        }
+        if (exponent.real() > 0) {
+            return BasicComplex<T>(0);
+        }
+    }
+    return exp(exponent * log(base));
+}
+
+template <typename T>
+BasicComplex<T> pow(const BasicComplex<T>& base, std::int32_t exponent) {
+    if (exponent == 0) {
+        return BasicComplex<T>(1);
+    }
+    BasicComplex<T> square = exponent < 0 ? base.inverse() : base;
+    // Unsigned, so that the magnitude of the smallest exponent fits.
+    std::uint32_t bits = exponent < 0 ? 0U - static_cast<std::uint32_t>(exponent) : exponent;
+    // The product starts at the lowest set bit instead of (1; 0), which would turn
+    // infinite parts into NaN.
+    while ((bits & 1) == 0) {
+        square *= square;
+        bits >>= 1;
+    }
+    BasicComplex<T> result = square;
+    while ((bits >>= 1) != 0) {
+        square *= square;
+        if ((bits & 1) != 0) {
+            result *= square;
+        }
+    }
+    return result;
+}
+
+#endif  // COMPLEX_COMPLEX_MATH_HPP
@@ -0,0 +1,121 @@
+#ifndef COMPLEX_COMPLEX_MATRIX_HPP
+#define COMPLEX_COMPLEX_MATRIX_HPP
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "complex/complex.hpp"
+#include "complex/complex_array.hpp"
+#include "complex/complex_math.hpp"
+#include "complex/thread_pool.hpp"
+
+// Dense row-major matrix of complex numbers with 64-byte aligned planes of real and
+// imaginary parts, like ComplexArray.
+class ComplexMatrix {
+public:
+    ComplexMatrix() = default;
+
+    // Zero matrix.
+    ComplexMatrix(std::size_t rows, std::size_t columns);
+
+    // Requires rows * columns values in row-major order.
+    ComplexMatrix(std::size_t rows, std::size_t columns, std::span<const Complex> values);
+
+    static ComplexMatrix identity(std::size_t size);
+
+    std::size_t rows() const;
+    std::size_t columns() const;
+
+    Complex operator()(std::size_t row, std::size_t column) const;
+
+    void set(std::size_t row, std::size_t column, const Complex& value);
+
+    // Row-major planes, row i starts at i * columns().
+    double* real_data();
+    const double* real_data() const;
+
+    double* imag_data();
+    const double* imag_data() const;
+
+    std::vector<Complex> to_vector() const;
+
+private:
+    std::size_t row_count    = 0;
+    std::size_t column_count = 0;
+    ComplexArray elements;
+};
+
+// Adds sign * left * right to out, where left is m x k, right k x n and out m x n, each
+// given by its planes and the distance between the starts of its rows. out must not
+// overlap the operands. The product is computed in cache-sized blocks that are packed
+// into panels for a register-blocked kernel, the pool spreads the tiles of out.
+//
+// Accurate computes the real and imaginary parts with four real products each, as the
+// naive loops do. Fast uses the 3M method, which gets the imaginary part from three
+// real products (ar + ai)(br + bi) - ar br - ai bi. That saves a quarter of the
+// multiplications, but its error in the imaginary parts is only bounded relative to
+// (|ar| + |ai|)(|br| + |bi|) summed over k, which is fine for normwise accurate results
+// and loses the imaginary parts of entries that are small by cancellation.
+void multiply_add_planes(std::size_t m, std::size_t n, std::size_t k, double sign, const double* left_real,
+                         const double* left_imag, std::size_t left_stride, const double* right_real,
+                         const double* right_imag, std::size_t right_stride, double* out_real, double* out_imag,
+                         std::size_t out_stride, MathAccuracy accuracy = MathAccuracy::Accurate,
+                         ThreadPool* pool = nullptr);
+
+// Matrix product, requires left.columns() == right.rows().
+ComplexMatrix multiply(const ComplexMatrix& left, const ComplexMatrix& right,
+                       MathAccuracy accuracy = MathAccuracy::Accurate);
+ComplexMatrix multiply(ThreadPool& pool, const ComplexMatrix& left, const ComplexMatrix& right,
+                       MathAccuracy accuracy = MathAccuracy::Accurate);
+
+// Matrix vector product, requires matrix.columns() == vector.size().
+ComplexArray multiply(const ComplexMatrix& matrix, const ComplexArray& vector);
+ComplexArray multiply(ThreadPool& pool, const ComplexMatrix& matrix, const ComplexArray& vector);
+
+ComplexMatrix operator*(const ComplexMatrix& left, const ComplexMatrix& right);
+ComplexArray operator*(const ComplexMatrix& matrix, const ComplexArray& vector);
+
+// LU decomposition P A = L U of a square matrix with partial pivoting on the largest
+// |re| + |im| in each column. The factorization runs on panels of BLOCK columns, the
+// update of the trailing matrix is a matrix product, which the pool spreads. A matrix
+// with an exactly zero pivot is singular, its factorization still completes but solving
+// with it throws std::domain_error.
+class LuDecomposition {
+public:
+    static constexpr std::size_t BLOCK = 64;
+
+    // Throws std::invalid_argument for matrices that are not square.
+    explicit LuDecomposition(const ComplexMatrix& matrix);
+    LuDecomposition(ThreadPool& pool, const ComplexMatrix& matrix);
+
+    std::size_t size() const;
+
+    bool is_singular() const;
+
+    // L below the diagonal with an implicit unit diagonal, U on and above it.
+    const ComplexMatrix& factors() const;
+
+    // Row i of P A is row permutation()[i] of A.
+    std::vector<std::size_t> permutation() const;
+
+    Complex determinant() const;
+
+    // Solves A x = right_side, requires right_side.size() == size().
+    ComplexArray solve(const ComplexArray& right_side) const;
+
+    // Solves A X = right_side for all columns at once, requires right_side.rows() == size().
+    ComplexMatrix solve(const ComplexMatrix& right_side) const;
+
+private:
+    void factorize(ThreadPool* pool);
+
+    void substitute(std::size_t columns, double* real, double* imag) const;
+
+    ComplexMatrix lu;
+    // Row swaps in order, step i swapped rows i and pivots[i].
+    std::vector<std::size_t> pivots;
+    bool singular = false;
+};
+
+#endif  // COMPLEX_COMPLEX_MATRIX_HPP
@@ -0,0 +1,115 @@
+#ifndef COMPLEX_FFT_HPP
+#define COMPLEX_FFT_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "complex/complex.hpp"
+#include "complex/complex_array.hpp"
+#include "complex/thread_pool.hpp"
+
+// The forward transform is X[k] = sum x[j] * exp(-2 pi i j k / n), the inverse uses the
+// opposite sign and divides by n, so that it undoes the forward transform.
+enum class FftDirection { Forward, Inverse };
+
+// Transform of one size with precomputed roots of unity. Sizes whose prime factors are
+// at most MAX_RADIX run as a self-sorting mixed radix FFT with radix 4, 2, 3 and
+// direct butterflies for the other factors. Sizes with a larger prime factor are
+// computed with Bluestein's algorithm as a convolution of a power of two size.
+//
+// Plans work on separate planes of real and imaginary parts, like ComplexArray. They are
+// immutable after construction and may be shared between threads.
+class FftPlan {
+public:
+    static constexpr std::size_t MAX_RADIX = 32;
+
+    // The size has to be positive.
+    explicit FftPlan(std::size_t size);
+
+    FftPlan(const FftPlan&)            = delete;
+    FftPlan& operator=(const FftPlan&) = delete;
+
+    std::size_t size() const;
+
+    // Number of doubles of scratch space that execute needs.
+    std::size_t scratch_size() const;
+
+    // The output planes may be the input planes, which transforms in place. Other
+    // overlaps are not allowed.
+    void execute(const double* in_real, const double* in_imag, double* out_real, double* out_imag,
+                 FftDirection direction = FftDirection::Forward) const;
+
+    // Same as above, but uses caller provided scratch space of at least scratch_size() values.
+    void execute(const double* in_real, const double* in_imag, double* out_real, double* out_imag,
+                 FftDirection direction, std::span<double> scratch) const;
+
+    // Requires arrays of the plan size, out may be in.
+    void execute(const ComplexArray& in, ComplexArray& out, FftDirection direction = FftDirection::Forward) const;
+
+    // Transforms count consecutive sequences of the plan size, spread over the pool.
+    void execute_batch(ThreadPool& pool, std::size_t count, const double* in_real, const double* in_imag,
+                       double* out_real, double* out_imag, FftDirection direction = FftDirection::Forward) const;
+
+    // Requires arrays of the same size that is a multiple of the plan size, out may be in.
+    void execute_batch(ThreadPool& pool, const ComplexArray& in, ComplexArray& out,
+                       FftDirection direction = FftDirection::Forward) const;
+
+private:
+    // One pass of the Stockham algorithm: span is the product of the radices of the
+    // earlier stages, stride the product of the later ones.
+    struct Stage {
+        std::size_t radix;
+        std::size_t span;
+        std::size_t stride;
+    };
+
+    void execute_stages(const double* in_real, const double* in_imag, double* out_real, double* out_imag,
+                        FftDirection direction, std::span<double> scratch) const;
+
+    void execute_bluestein(const double* in_real, const double* in_imag, double* out_real, double* out_imag,
+                           FftDirection direction, std::span<double> scratch) const;
+
+    std::size_t length;
+    std::vector<Stage> stages;
+    // exp(-2 pi i t / n) for t in [0, n), empty for Bluestein plans.
+    std::vector<double> roots_real;
+    std::vector<double> roots_imag;
+
+    // Bluestein plans: the chirp exp(-pi i k^2 / n) and the transformed convolution kernel.
+    std::unique_ptr<const FftPlan> convolution;
+    std::vector<double> chirp_real;
+    std::vector<double> chirp_imag;
+    std::vector<double> kernel_real;
+    std::vector<double> kernel_imag;
+};
+
+// Plans shared by size. Lookups are thread-safe, a plan is built outside of the lock
+// and the first one stored for a size wins. Returned plans stay valid after clear.
+class FftPlanCache {
+public:
+    std::shared_ptr<const FftPlan> plan(std::size_t size);
+
+    // Number of cached plans.
+    std::size_t size() const;
+
+    void clear();
+
+private:
+    mutable std::mutex mutex;
+    std::unordered_map<std::size_t, std::shared_ptr<const FftPlan>> plans;
+};
+
+// The cache behind the functions below.
+FftPlanCache& fft_plans();
+
+ComplexArray fft(const ComplexArray& values);
+ComplexArray inverse_fft(const ComplexArray& values);
+
+std::vector<Complex> fft(std::span<const Complex> values);
+std::vector<Complex> inverse_fft(std::span<const Complex> values);
+
+#endif  // COMPLEX_FFT_HPP
@@ -0,0 +1,80 @@
+#ifndef COMPLEX_POLYNOMIAL_HPP
+#define COMPLEX_POLYNOMIAL_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "complex/complex.hpp"
+#include "complex/complex_array.hpp"
+#include "complex/thread_pool.hpp"
+
+// Horner's rule is one multiply-add per coefficient in a chain. Estrin's scheme combines
+// coefficient pairs with z, then pairs of those with z^2 and so on, which shortens the
+// chain to log2 of the degree at the cost of the powers z^(2^k). Both round differently.
+// Over blocks of points the chains of different points are independent anyway, there
+// Horner's rule is usually faster.
+enum class PolynomialScheme { Horner, Estrin };
+
+// Polynomial in one complex variable with its coefficients from the constant term up.
+// Trailing zero coefficients are dropped, so the last one is the leading coefficient and
+// the zero polynomial has none.
+class Polynomial {
+public:
+    Polynomial() = default;
+
+    explicit Polynomial(std::vector<Complex> coefficients);
+
+    // Degree of the zero polynomial and of constants is 0.
+    std::size_t degree() const;
+
+    const std::vector<Complex>& coefficients() const;
+
+    bool is_constant() const;
+
+    Complex operator()(const Complex& z) const;
+
+    // The output may alias the points.
+    void eval_planes(std::size_t n, const double* z_real, const double* z_imag, double* real, double* imag,
+                     PolynomialScheme scheme = PolynomialScheme::Horner) const;
+
+    ComplexArray eval(const ComplexArray& points, PolynomialScheme scheme = PolynomialScheme::Horner) const;
+
+    // Same as above with blocks of points spread over the pool.
+    ComplexArray eval(ThreadPool& pool, const ComplexArray& points,
+                      PolynomialScheme scheme = PolynomialScheme::Horner) const;
+
+    Polynomial derivative() const;
+
+    // All degree() roots with multiplicity, in no particular order. Runs the Aberth-Ehrlich
+    // iteration from initial approximations on the circles of the Newton polygon of the
+    // coefficient moduli. Every step updates all unconverged roots at once from the
+    // previous approximations, the pool spreads these updates. A root has converged once
+    // |p(z)| is below the rounding error bound of evaluating it, roots that have not after
+    // max_iterations are returned as they are. Throws std::invalid_argument for the zero
+    // polynomial.
+    std::vector<Complex> roots(std::size_t max_iterations = 100) const;
+    std::vector<Complex> roots(ThreadPool& pool, std::size_t max_iterations = 100) const;
+
+    Polynomial operator-() const;
+
+    Polynomial& operator+=(const Polynomial& polynomial);
+    Polynomial& operator-=(const Polynomial& polynomial);
+    Polynomial& operator*=(const Polynomial& polynomial);
+
+    friend Polynomial operator+(const Polynomial& left, const Polynomial& right);
+    friend Polynomial operator-(const Polynomial& left, const Polynomial& right);
+    friend Polynomial operator*(const Polynomial& left, const Polynomial& right);
+
+private:
+    void trim();
+
+    std::vector<Complex> find_roots(ThreadPool* pool, std::size_t max_iterations) const;
+
+    std::vector<Complex> terms;
+};
+
+Polynomial operator+(const Polynomial& left, const Polynomial& right);
+Polynomial operator-(const Polynomial& left, const Polynomial& right);
+Polynomial operator*(const Polynomial& left, const Polynomial& right);
+
+#endif  // COMPLEX_POLYNOMIAL_HPP
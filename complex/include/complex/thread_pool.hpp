@@ -0,0 +1,62 @@
+#ifndef COMPLEX_THREAD_POOL_HPP
+#define COMPLEX_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+// Fixed set of workers with one task deque each. A worker takes tasks from the front
+// of its own deque and, once it runs dry, steals from the back of the others.
+class ThreadPool {
+public:
+    explicit ThreadPool(std::size_t threads = std::thread::hardware_concurrency());
+
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool();
+
+    // Runs task(i) for every i in [0, count) and returns once all of them are done.
+    // Rethrows the first exception thrown by a task. Calls from a task of the same pool
+    // run all tasks inline on the calling worker, so nested parallel code does not
+    // deadlock. Tasks that wait on another pool whose tasks call back into this one
+    // still do.
+    void parallel_for(std::size_t count, const std::function<void(std::size_t)>& task);
+
+    std::size_t size() const;
+
+private:
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<std::size_t> tasks;
+    };
+
+    void work(std::size_t worker);
+
+    std::optional<std::size_t> next_task(std::size_t worker);
+
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    std::vector<std::thread> threads;
+
+    std::mutex run_mutex;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(std::size_t)>* job = nullptr;
+    std::uint64_t generation                   = 0;
+    std::size_t remaining                      = 0;
+    std::size_t active                         = 0;
+    bool stopping                              = false;
+    std::exception_ptr failure;
+};
+
+#endif  // COMPLEX_THREAD_POOL_HPP
@@ -0,0 +1,481 @@
+#include "complex/polynomial.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "simd_kernel.hpp"
+
+namespace {
+
+constexpr std::size_t BLOCK = 256;
+
+// Blocks of points that one task of the parallel evaluation takes.
+constexpr std::size_t BLOCKS_PER_TASK = 16;
+
+constexpr double UNIT_ROUNDOFF = 0x1p-53;
+
+constexpr double PI = 3.14159265358979323846;
+
+bool is_zero(const Complex& number) {
+    return number.real() == 0 && number.imag() == 0;
+}
+
+// Rounds like the scalar acc = acc * z + c of operator().
+COMPLEX_SIMD_KERNEL
+void horner_kernel(std::size_t n, const double* z_real, const double* z_imag, const Complex* coefficients,
+                   std::size_t count, double* real, double* imag) {
+    std::fill(real, real + n, coefficients[count - 1].real());
+    std::fill(imag, imag + n, coefficients[count - 1].imag());
+    for (std::size_t k = count - 1; k-- > 0;) {
+        const double coefficient_real = coefficients[k].real();
+        const double coefficient_imag = coefficients[k].imag();
+        for (std::size_t i = 0; i < n; ++i) {
+            const double product_real = real[i] * z_real[i] - imag[i] * z_imag[i];
+            const double product_imag = imag[i] * z_real[i] + real[i] * z_imag[i];
+            real[i]                   = product_real + coefficient_real;
+            imag[i]                   = product_imag + coefficient_imag;
+        }
+    }
+}
+
+// low + high * z.
+COMPLEX_SIMD_KERNEL
+void linear_kernel(std::size_t n, const double* z_real, const double* z_imag, const Complex& low, const Complex& high,
+                   double* real, double* imag) {
+    for (std::size_t i = 0; i < n; ++i) {
+        real[i] = (high.real() * z_real[i] - high.imag() * z_imag[i]) + low.real();
+        imag[i] = (high.imag() * z_real[i] + high.real() * z_imag[i]) + low.imag();
+    }
+}
+
+// acc += left * right.
+COMPLEX_SIMD_KERNEL
+void multiply_add_kernel(std::size_t n, const double* left_real, const double* left_imag, const double* right_real,
+                         const double* right_imag, double* real, double* imag) {
+    for (std::size_t i = 0; i < n; ++i) {
+        real[i] = (left_real[i] * right_real[i] - left_imag[i] * right_imag[i]) + real[i];
+        imag[i] = (left_imag[i] * right_real[i] + left_real[i] * right_imag[i]) + imag[i];
+    }
+}
+
+// Value, derivative and Higham's running error bound of Horner's rule for a block of
+// points x with moduli |x|. The moduli of the values are taken as |re| + |im|, which
+// overestimates them by at most sqrt(2).
+COMPLEX_SIMD_KERNEL
+void newton_kernel(std::size_t n, const double* x_real, const double* x_imag, const double* x_abs,
+                   const Complex* coefficients, std::size_t count, double* value_real, double* value_imag,
+                   double* derivative_real, double* derivative_imag, double* error) {
+    const Complex leading = coefficients[count - 1];
+    for (std::size_t i = 0; i < n; ++i) {
+        value_real[i]      = leading.real();
+        value_imag[i]      = leading.imag();
+        derivative_real[i] = 0;
+        derivative_imag[i] = 0;
+        error[i]           = (std::abs(leading.real()) + std::abs(leading.imag())) / 2;
+    }
+    for (std::size_t k = count - 1; k-- > 0;) {
+        const double coefficient_real = coefficients[k].real();
+        const double coefficient_imag = coefficients[k].imag();
+        for (std::size_t i = 0; i < n; ++i) {
+            const double d_real = derivative_real[i] * x_real[i] - derivative_imag[i] * x_imag[i] + value_real[i];
+            const double d_imag = derivative_imag[i] * x_real[i] + derivative_real[i] * x_imag[i] + value_imag[i];
+            const double v_real = value_real[i] * x_real[i] - value_imag[i] * x_imag[i] + coefficient_real;
+            const double v_imag = value_imag[i] * x_real[i] + value_real[i] * x_imag[i] + coefficient_imag;
+            derivative_real[i]  = d_real;
+            derivative_imag[i]  = d_imag;
+            value_real[i]       = v_real;
+            value_imag[i]       = v_imag;
+            error[i]            = error[i] * x_abs[i] + std::abs(v_real) + std::abs(v_imag);
+        }
+    }
+}
+
+// Sum of 1 / (z - roots[j]) over [0, n). Separate sums per lane keep the order of the
+// additions fixed, so the loop vectorizes without reassociation.
+COMPLEX_SIMD_KERNEL
+Complex inverse_difference_sum(std::size_t n, const double* roots_real, const double* roots_imag, double z_real,
+                               double z_imag) {
+    constexpr std::size_t LANES = 8;
+    std::array<double, LANES> sum_real{};
+    std::array<double, LANES> sum_imag{};
+    std::size_t j = 0;
+    for (; j + LANES <= n; j += LANES) {
+        for (std::size_t lane = 0; lane < LANES; ++lane) {
+            const double difference_real = z_real - roots_real[j + lane];
+            const double difference_imag = z_imag - roots_imag[j + lane];
+            const double inverse_norm    = 1 / (difference_real * difference_real + difference_imag * difference_imag);
+            sum_real[lane] += difference_real * inverse_norm;
+            sum_imag[lane] -= difference_imag * inverse_norm;
+        }
+    }
+    for (; j < n; ++j) {
+        const double difference_real = z_real - roots_real[j];
+        const double difference_imag = z_imag - roots_imag[j];
+        const double inverse_norm    = 1 / (difference_real * difference_real + difference_imag * difference_imag);
+        sum_real[0] += difference_real * inverse_norm;
+        sum_imag[0] -= difference_imag * inverse_norm;
+    }
+    Complex sum(0);
+    for (std::size_t lane = 0; lane < LANES; ++lane) {
+        sum += Complex(sum_real[lane], sum_imag[lane]);
+    }
+    return sum;
+}
+
+// Evaluates the first count coefficients, at most 2^level of them, with Estrin's scheme.
+// powers holds z^(2^l) for every level below, temps one block per level.
+struct EstrinBlock {
+    std::size_t n;
+    const double* z_real;
+    const double* z_imag;
+    std::vector<std::array<double, BLOCK>> powers_real;
+    std::vector<std::array<double, BLOCK>> powers_imag;
+    std::vector<std::array<double, BLOCK>> temps_real;
+    std::vector<std::array<double, BLOCK>> temps_imag;
+
+    void eval(const Complex* coefficients, std::size_t count, std::size_t level, double* real, double* imag) {
+        if (count == 1) {
+            std::fill(real, real + n, coefficients[0].real());
+            std::fill(imag, imag + n, coefficients[0].imag());
+            return;
+        }
+        if (count == 2) {
+            linear_kernel(n, z_real, z_imag, coefficients[0], coefficients[1], real, imag);
+            return;
+        }
+        const std::size_t half = std::size_t(1) << (level - 1);
+        if (count <= half) {
+            eval(coefficients, count, level - 1, real, imag);
+            return;
+        }
+        eval(coefficients, half, level - 1, real, imag);
+        eval(coefficients + half, count - half, level - 1, temps_real[level].data(), temps_imag[level].data());
+        multiply_add_kernel(n, temps_real[level].data(), temps_imag[level].data(), powers_real[level - 1].data(),
+                            powers_imag[level - 1].data(), real, imag);
+    }
+};
+
+// Initial approximations on the circles of the upper convex hull of (k, log|c_k|), as
+// proposed by Bini: an edge from i to j carries j - i points on the circle of radius
+// (|c_i| / |c_j|)^(1 / (j - i)), rotated against each other to avoid symmetries.
+std::vector<Complex> initial_approximations(const std::vector<Complex>& coefficients) {
+    const std::size_t degree = coefficients.size() - 1;
+    std::vector<double> logs;
+    for (const Complex& coefficient : coefficients) {
+        logs.push_back(is_zero(coefficient) ? -std::numeric_limits<double>::infinity() : std::log(coefficient.abs()));
+    }
+
+    std::vector<std::size_t> hull;
+    for (std::size_t k = 0; k <= degree; ++k) {
+        if (std::isinf(logs[k])) {
+            continue;
+        }
+        // Drops the last vertex while it is on or below the line from the one before it to k.
+        while (hull.size() >= 2) {
+            const std::size_t a = hull[hull.size() - 2];
+            const std::size_t b = hull.back();
+            const double turn   = (logs[k] - logs[a]) * static_cast<double>(b - a) -
+                                (logs[b] - logs[a]) * static_cast<double>(k - a);
+            if (turn < 0) {
+                break;
+            }
+            hull.pop_back();
+        }
+        hull.push_back(k);
+    }
+
+    std::vector<Complex> approximations;
+    for (std::size_t edge = 0; edge + 1 < hull.size(); ++edge) {
+        const std::size_t count = hull[edge + 1] - hull[edge];
+        const double radius     = std::exp((logs[hull[edge]] - logs[hull[edge + 1]]) / static_cast<double>(count));
+        for (std::size_t m = 0; m < count; ++m) {
+            const double angle = 2 * PI * static_cast<double>(m) / static_cast<double>(count) +
+                                 2 * PI * static_cast<double>(hull[edge]) / static_cast<double>(degree) + 0.7;
+            approximations.emplace_back(radius * std::cos(angle), radius * std::sin(angle));
+        }
+    }
+    return approximations;
+}
+
+}  // namespace
+
+Polynomial::Polynomial(std::vector<Complex> coefficients) : terms(std::move(coefficients)) {
+    trim();
+}
+
+std::size_t Polynomial::degree() const {
+    return terms.empty() ? 0 : terms.size() - 1;
+}
+
+const std::vector<Complex>& Polynomial::coefficients() const {
+    return terms;
+}
+
+bool Polynomial::is_constant() const {
+    return terms.size() <= 1;
+}
+
+Complex Polynomial::operator()(const Complex& z) const {
+    if (terms.empty()) {
+        return Complex(0);
+    }
+    Complex result = terms.back();
+    for (std::size_t k = terms.size() - 1; k-- > 0;) {
+        result = result * z + terms[k];
+    }
+    return result;
+}
+
+void Polynomial::eval_planes(std::size_t n, const double* z_real, const double* z_imag, double* real, double* imag,
+                             PolynomialScheme scheme) const {
+    if (terms.empty()) {
+        std::fill(real, real + n, 0.0);
+        std::fill(imag, imag + n, 0.0);
+        return;
+    }
+    std::size_t levels = 0;
+    while ((std::size_t(1) << levels) < terms.size()) {
+        ++levels;
+    }
+    EstrinBlock estrin = {0, nullptr, nullptr, {}, {}, {}, {}};
+    if (scheme == PolynomialScheme::Estrin) {
+        estrin.powers_real.resize(levels);
+        estrin.powers_imag.resize(levels);
+        estrin.temps_real.resize(levels + 1);
+        estrin.temps_imag.resize(levels + 1);
+    }
+
+    // Blocks go through local planes, so that the output may alias the points.
+    std::array<double, BLOCK> block_real;
+    std::array<double, BLOCK> block_imag;
+    for (std::size_t start = 0; start < n; start += BLOCK) {
+        const std::size_t count = std::min(BLOCK, n - start);
+        if (scheme == PolynomialScheme::Horner) {
+            horner_kernel(count, z_real + start, z_imag + start, terms.data(), terms.size(), block_real.data(),
+                          block_imag.data());
+        } else {
+            estrin.n      = count;
+            estrin.z_real = z_real + start;
+            estrin.z_imag = z_imag + start;
+            if (levels > 0) {
+                std::copy(z_real + start, z_real + start + count, estrin.powers_real[0].data());
+                std::copy(z_imag + start, z_imag + start + count, estrin.powers_imag[0].data());
+            }
+            for (std::size_t level = 1; level < levels; ++level) {
+                multiply_planes(count, estrin.powers_real[level - 1].data(), estrin.powers_imag[level - 1].data(),
+                                estrin.powers_real[level - 1].data(), estrin.powers_imag[level - 1].data(),
+                                estrin.powers_real[level].data(), estrin.powers_imag[level].data());
+            }
+            estrin.eval(terms.data(), terms.size(), levels, block_real.data(), block_imag.data());
+        }
+        std::copy(block_real.begin(), block_real.begin() + count, real + start);
+        std::copy(block_imag.begin(), block_imag.begin() + count, imag + start);
+    }
+}
+
+ComplexArray Polynomial::eval(const ComplexArray& points, PolynomialScheme scheme) const {
+    ComplexArray result(points.size());
+    eval_planes(points.size(), points.real_data(), points.imag_data(), result.real_data(), result.imag_data(), scheme);
+    return result;
+}
+
+ComplexArray Polynomial::eval(ThreadPool& pool, const ComplexArray& points, PolynomialScheme scheme) const {
+    ComplexArray result(points.size());
+    constexpr std::size_t TASK = BLOCK * BLOCKS_PER_TASK;
+    pool.parallel_for((points.size() + TASK - 1) / TASK, [&](std::size_t task) {
+        const std::size_t start = task * TASK;
+        eval_planes(std::min(TASK, points.size() - start), points.real_data() + start, points.imag_data() + start,
+                    result.real_data() + start, result.imag_data() + start, scheme);
+    });
+    return result;
+}
+
+Polynomial Polynomial::derivative() const {
+    std::vector<Complex> coefficients;
+    for (std::size_t k = 1; k < terms.size(); ++k) {
+        coefficients.push_back(static_cast<double>(k) * terms[k]);
+    }
+    return Polynomial(std::move(coefficients));
+}
+
+std::vector<Complex> Polynomial::roots(std::size_t max_iterations) const {
+    return find_roots(nullptr, max_iterations);
+}
+
+std::vector<Complex> Polynomial::roots(ThreadPool& pool, std::size_t max_iterations) const {
+    return find_roots(&pool, max_iterations);
+}
+
+std::vector<Complex> Polynomial::find_roots(ThreadPool* pool, std::size_t max_iterations) const {
+    if (terms.empty()) {
+        throw std::invalid_argument("every number is a root of the zero polynomial");
+    }
+
+    // Roots at zero are exact, the others are roots of the polynomial divided by z^zeros.
+    std::size_t zeros = 0;
+    while (is_zero(terms[zeros])) {
+        ++zeros;
+    }
+    std::vector<Complex> result(zeros, Complex(0));
+    const std::vector<Complex> coefficients(terms.begin() + static_cast<std::ptrdiff_t>(zeros), terms.end());
+    const std::size_t degree = coefficients.size() - 1;
+    if (degree == 0) {
+        return result;
+    }
+    // For |z| > 1 the iteration evaluates q(w) = w^n p(1 / w) at w = 1 / z, which does
+    // not overflow like p(z) for large degrees: p(z) / p'(z) = z q(w) / (n q(w) - w q'(w)).
+    const std::vector<Complex> reversed(coefficients.rbegin(), coefficients.rend());
+
+    std::vector<double> z_real;
+    std::vector<double> z_imag;
+    for (const Complex& approximation : initial_approximations(coefficients)) {
+        z_real.push_back(approximation.real());
+        z_imag.push_back(approximation.imag());
+    }
+    std::vector<double> next_real(degree);
+    std::vector<double> next_imag(degree);
+    // Written by the tasks concurrently, so bytes instead of std::vector<bool>.
+    std::vector<std::uint8_t> converged(degree, 0);
+
+    // Newton corrections p(z) / p'(z) for the unconverged roots of [begin, end) and the
+    // Aberth step z - N / (1 - N * sum 1 / (z - z_j)) from the current approximations.
+    const auto update = [&](std::size_t begin, std::size_t end) {
+        std::array<std::size_t, BLOCK> indices;
+        std::array<double, BLOCK> x_real;
+        std::array<double, BLOCK> x_imag;
+        std::array<double, BLOCK> x_abs;
+        std::array<double, BLOCK> value_real;
+        std::array<double, BLOCK> value_imag;
+        std::array<double, BLOCK> derivative_real;
+        std::array<double, BLOCK> derivative_imag;
+        std::array<double, BLOCK> error;
+        for (std::size_t start = begin; start < end; start += BLOCK) {
+            const std::size_t stop = std::min(end, start + BLOCK);
+            std::copy(z_real.begin() + start, z_real.begin() + stop, next_real.begin() + start);
+            std::copy(z_imag.begin() + start, z_imag.begin() + stop, next_imag.begin() + start);
+            for (const bool outside : {false, true}) {
+                std::size_t count = 0;
+                for (std::size_t i = start; i < stop; ++i) {
+                    const Complex z(z_real[i], z_imag[i]);
+                    if (converged[i] || (z.abs() > 1) != outside) {
+                        continue;
+                    }
+                    const Complex x = outside ? z.inverse() : z;
+                    indices[count]  = i;
+                    x_real[count]   = x.real();
+                    x_imag[count]   = x.imag();
+                    x_abs[count]    = x.abs();
+                    ++count;
+                }
+                const std::vector<Complex>& polynomial = outside ? reversed : coefficients;
+                newton_kernel(count, x_real.data(), x_imag.data(), x_abs.data(), polynomial.data(), polynomial.size(),
+                              value_real.data(), value_imag.data(), derivative_real.data(), derivative_imag.data(),
+                              error.data());
+                for (std::size_t slot = 0; slot < count; ++slot) {
+                    const std::size_t i = indices[slot];
+                    const Complex z(z_real[i], z_imag[i]);
+                    const Complex x(x_real[slot], x_imag[slot]);
+                    const Complex value(value_real[slot], value_imag[slot]);
+                    const Complex derivative(derivative_real[slot], derivative_imag[slot]);
+                    const Complex newton = outside ? z * value / (static_cast<double>(degree) * value - x * derivative)
+                                                   : value / derivative;
+                    const Complex sum =
+                        inverse_difference_sum(i, z_real.data(), z_imag.data(), z.real(), z.imag()) +
+                        inverse_difference_sum(degree - i - 1, z_real.data() + i + 1, z_imag.data() + i + 1, z.real(),
+                                               z.imag());
+                    const Complex step = newton / (Complex(1) - newton * sum);
+                    if (std::isfinite(step.real()) && std::isfinite(step.imag())) {
+                        next_real[i] = z.real() - step.real();
+                        next_imag[i] = z.imag() - step.imag();
+                    }
+                    converged[i] = value.abs() <= 8 * UNIT_ROUNDOFF * error[slot];
+                }
+            }
+        }
+    };
+
+    const std::size_t tasks = pool == nullptr ? 1 : std::min(degree, 4 * pool->size());
+    const std::function<void(std::size_t)> task = [&](std::size_t index) {
+        update(index * degree / tasks, (index + 1) * degree / tasks);
+    };
+    for (std::size_t iteration = 0; iteration < max_iterations; ++iteration) {
+        if (std::all_of(converged.begin(), converged.end(), [](std::uint8_t done) { return done != 0; })) {
+            break;
+        }
+        if (pool == nullptr) {
+            task(0);
+        } else {
+            pool->parallel_for(tasks, task);
+        }
+        std::swap(z_real, next_real);
+        std::swap(z_imag, next_imag);
+    }
+
+    for (std::size_t i = 0; i < degree; ++i) {
+        result.emplace_back(z_real[i], z_imag[i]);
+    }
+    return result;
+}
+
+Polynomial Polynomial::operator-() const {
+    Polynomial result = *this;
+    for (Complex& term : result.terms) {
+        term = -term;
+    }
+    return result;
+}
+
+Polynomial& Polynomial::operator+=(const Polynomial& polynomial) {
+    terms.resize(std::max(terms.size(), polynomial.terms.size()), Complex(0));
+    for (std::size_t k = 0; k < polynomial.terms.size(); ++k) {
+        terms[k] += polynomial.terms[k];
+    }
+    trim();
+    return *this;
+}
+
+Polynomial& Polynomial::operator-=(const Polynomial& polynomial) {
+    terms.resize(std::max(terms.size(), polynomial.terms.size()), Complex(0));
+    for (std::size_t k = 0; k < polynomial.terms.size(); ++k) {
+        terms[k] -= polynomial.terms[k];
+    }
+    trim();
+    return *this;
+}
+
+Polynomial& Polynomial::operator*=(const Polynomial& polynomial) {
+    return *this = *this * polynomial;
+}
+
+Polynomial operator+(const Polynomial& left, const Polynomial& right) {
+    return Polynomial(left) += right;
+}
+
+Polynomial operator-(const Polynomial& left, const Polynomial& right) {
+    return Polynomial(left) -= right;
+}
+
+Polynomial operator*(const Polynomial& left, const Polynomial& right) {
+    if (left.terms.empty() || right.terms.empty()) {
+        return Polynomial();
+    }
+    std::vector<Complex> product(left.terms.size() + right.terms.size() - 1, Complex(0));
+    for (std::size_t i = 0; i < left.terms.size(); ++i) {
+        for (std::size_t j = 0; j < right.terms.size(); ++j) {
+            product[i + j] += left.terms[i] * right.terms[j];
+        }
+    }
+    return Polynomial(std::move(product));
+}
+
+void Polynomial::trim() {
+    while (!terms.empty() && is_zero(terms.back())) {
+        terms.pop_back();
+    }
+}
@@ -0,0 +1,12 @@
+#ifndef COMPLEX_SIMD_KERNEL_HPP
+#define COMPLEX_SIMD_KERNEL_HPP
+
+// Builds a function for SSE2, AVX2 and AVX-512 on x86-64, the widest version supported
+// by the CPU is picked at load time.
+#if defined(__x86_64__) && defined(__GNUC__) && defined(__linux__)
+#define COMPLEX_SIMD_KERNEL __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define COMPLEX_SIMD_KERNEL
+#endif
+
+#endif  // COMPLEX_SIMD_KERNEL_HPP
@@ -0,0 +1,138 @@
+#include "complex/thread_pool.hpp"
+
+#include <algorithm>
+
+namespace {
+
+// The pool whose worker runs on this thread, if any.
+thread_local const ThreadPool* worker_pool = nullptr;
+
+}  // namespace
+
+ThreadPool::ThreadPool(std::size_t threads) {
+    threads = std::max<std::size_t>(threads, 1);
+    for (std::size_t i = 0; i < threads; ++i) {
+        queues.push_back(std::make_unique<TaskQueue>());
+    }
+    this->threads.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        this->threads.emplace_back([this, i] { work(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::parallel_for(std::size_t count, const std::function<void(std::size_t)>& task) {
+    if (count == 0) {
+        return;
+    }
+    // The workers are busy with the calling task, waiting for them would never end.
+    if (worker_pool == this) {
+        for (std::size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+    std::lock_guard run_lock(run_mutex);
+
+    // Every worker starts with a contiguous range of tasks, stealing evens out the rest.
+    const std::size_t workers = queues.size();
+    for (std::size_t worker = 0; worker < workers; ++worker) {
+        std::lock_guard queue_lock(queues[worker]->mutex);
+        for (std::size_t i = worker * count / workers; i < (worker + 1) * count / workers; ++i) {
+            queues[worker]->tasks.push_back(i);
+        }
+    }
+
+    std::unique_lock lock(mutex);
+    job       = &task;
+    remaining = count;
+    failure   = nullptr;
+    ++generation;
+    wake.notify_all();
+    // Waiting for idle workers too guarantees that nobody still holds a pointer to this task.
+    done.wait(lock, [this] { return remaining == 0 && active == 0; });
+    job = nullptr;
+
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+std::size_t ThreadPool::size() const {
+    return threads.size();
+}
+
+void ThreadPool::work(std::size_t worker) {
+    worker_pool        = this;
+    std::uint64_t seen = 0;
+    while (true) {
+        const std::function<void(std::size_t)>* task = nullptr;
+        {
+            std::unique_lock lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+            task = job;
+            ++active;
+        }
+
+        std::size_t finished = 0;
+        std::exception_ptr error;
+        while (task != nullptr) {
+            const std::optional<std::size_t> index = next_task(worker);
+            if (!index) {
+                break;
+            }
+            try {
+                (*task)(*index);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            ++finished;
+        }
+
+        std::lock_guard lock(mutex);
+        if (error && !failure) {
+            failure = error;
+        }
+        remaining -= finished;
+        --active;
+        if (remaining == 0 && active == 0) {
+            done.notify_all();
+        }
+    }
+}
+
+std::optional<std::size_t> ThreadPool::next_task(std::size_t worker) {
+    {
+        TaskQueue& own = *queues[worker];
+        std::lock_guard lock(own.mutex);
+        if (!own.tasks.empty()) {
+            const std::size_t index = own.tasks.front();
+            own.tasks.pop_front();
+            return index;
+        }
+    }
+    for (std::size_t offset = 1; offset < queues.size(); ++offset) {
+        TaskQueue& victim = *queues[(worker + offset) % queues.size()];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            const std::size_t index = victim.tasks.back();
+            victim.tasks.pop_back();
+            return index;
+        }
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,437 @@
+#include "expressions/compiled_expression.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#include "complex/complex_array.hpp"
+#include "complex/complex_math.hpp"
+
+// Lowers the tree into a list of value nodes in evaluation order. With common subexpression
+// elimination every node is hash-consed on its kind and operands, constants on their bit
+// pattern and variables on their slot, so every distinct subexpression becomes one node.
+// Registers are then assigned by liveness: a register is released after the last use of
+// its value and reused by the next node.
+class CompiledExpression::Compiler: public ExpressionVisitor {
+public:
+    Compiler(CompiledExpression& target, const VariableSlots& slots, const CompileOptions& options)
+        : target(target), slots(slots), options(options) {}
+
+    std::uint32_t visit_const(const Complex& value) {
+        const std::pair key(std::bit_cast<std::uint64_t>(value.real()), std::bit_cast<std::uint64_t>(value.imag()));
+        auto [constant, inserted] = constant_ids.try_emplace(key, static_cast<std::uint32_t>(target.constants.size()));
+        if (inserted || !options.eliminate_common_subexpressions) {
+            constant->second = static_cast<std::uint32_t>(target.constants.size());
+            target.constants.push_back(value);
+        }
+        return intern({OpCode::Const, constant->second, 0});
+    }
+
+    std::uint32_t visit_variable(const std::string& name) {
+        const std::size_t slot = slots.at(name);
+        target.slots           = std::max(target.slots, slot + 1);
+        return intern({OpCode::Load, static_cast<std::uint32_t>(slot), 0});
+    }
+
+    std::uint32_t visit_unary(Operation operation, std::uint32_t operand) {
+        return intern({opcode(operation), operand, 0});
+    }
+
+    std::uint32_t visit_binary(Operation operation, std::uint32_t left, std::uint32_t right) {
+        return intern({opcode(operation), left, right});
+    }
+
+    std::uint32_t visit_power(std::uint32_t base, std::int32_t exponent) {
+        return intern({OpCode::Power, base, std::bit_cast<std::uint32_t>(exponent)});
+    }
+
+    // Emits the instructions computing node root and returns the register holding it.
+    std::uint32_t emit(std::uint32_t root) {
+        std::vector<std::uint32_t> last_use(nodes.size(), NO_USE);
+        for (std::uint32_t i = 0; i < nodes.size(); ++i) {
+            for (std::size_t k = 0; k < arity(nodes[i].code); ++k) {
+                last_use[operand(nodes[i], k)] = i;
+            }
+        }
+
+        std::vector<std::uint32_t> node_register(nodes.size());
+        std::vector<std::uint32_t> free_registers;
+        target.instructions.reserve(nodes.size());
+        for (std::uint32_t i = 0; i < nodes.size(); ++i) {
+            const Node& node        = nodes[i];
+            Instruction instruction = {node.code, 0, node.left, node.right};
+            if (arity(node.code) >= 1) {
+                instruction.left = node_register[node.left];
+            }
+            if (arity(node.code) == 2) {
+                instruction.right = node_register[node.right];
+            }
+            // Operands die before the result is allocated, kernels allow the result to alias them.
+            for (std::size_t k = 0; k < arity(node.code); ++k) {
+                const bool repeated = k == 1 && node.right == node.left;
+                if (last_use[operand(node, k)] == i && !repeated) {
+                    free_registers.push_back(node_register[operand(node, k)]);
+                }
+            }
+            if (free_registers.empty()) {
+                free_registers.push_back(static_cast<std::uint32_t>(target.registers++));
+            }
+            node_register[i] = free_registers.back();
+            free_registers.pop_back();
+            instruction.destination = node_register[i];
+            target.instructions.push_back(instruction);
+        }
+        return node_register[root];
+    }
+
+private:
+    struct Node {
+        OpCode code;
+        std::uint32_t left;
+        std::uint32_t right;
+
+        bool operator==(const Node& node) const = default;
+    };
+
+    struct NodeHash {
+        std::size_t operator()(const Node& node) const {
+            const std::size_t operands = (static_cast<std::size_t>(node.left) << 32) | node.right;
+            return std::hash<std::size_t>()(operands * 31 + static_cast<std::size_t>(node.code));
+        }
+    };
+
+    struct ConstantHash {
+        std::size_t operator()(const std::pair<std::uint64_t, std::uint64_t>& bits) const {
+            return std::hash<std::uint64_t>()(bits.first * 31 + bits.second);
+        }
+    };
+
+    static constexpr std::uint32_t NO_USE = std::numeric_limits<std::uint32_t>::max();
+
+    static std::size_t arity(OpCode code) {
+        switch (code) {
+        case OpCode::Const:
+        case OpCode::Load:
+            return 0;
+        case OpCode::Negate:
+        case OpCode::Conjugate:
+        case OpCode::Exp:
+        case OpCode::Log:
+        case OpCode::Sqrt:
+        case OpCode::Sin:
+        case OpCode::Cos:
+        case OpCode::Power:
+            return 1;
+        default:
+            return 2;
+        }
+    }
+
+    static std::uint32_t operand(const Node& node, std::size_t index) {
+        return index == 0 ? node.left : node.right;
+    }
+
+    std::uint32_t intern(const Node& node) {
+        const auto id = static_cast<std::uint32_t>(nodes.size());
+        if (!options.eliminate_common_subexpressions) {
+            nodes.push_back(node);
+            return id;
+        }
+        auto [existing, inserted] = node_ids.try_emplace(node, id);
+        if (inserted) {
+            nodes.push_back(node);
+        }
+        return existing->second;
+    }
+
+    static OpCode opcode(Operation operation) {
+        switch (operation) {
+        case Operation::Add:
+            return OpCode::Add;
+        case Operation::Subtract:
+            return OpCode::Subtract;
+        case Operation::Multiply:
+            return OpCode::Multiply;
+        case Operation::Divide:
+            return OpCode::Divide;
+        case Operation::Negate:
+            return OpCode::Negate;
+        case Operation::Conjugate:
+            return OpCode::Conjugate;
+        case Operation::Exp:
+            return OpCode::Exp;
+        case Operation::Log:
+            return OpCode::Log;
+        case Operation::Sqrt:
+            return OpCode::Sqrt;
+        case Operation::Sin:
+            return OpCode::Sin;
+        case Operation::Cos:
+            return OpCode::Cos;
+        case Operation::Power:
+            return OpCode::Power;
+        case Operation::ComplexPower:
+            return OpCode::ComplexPower;
+        }
+        throw std::invalid_argument("unknown operation");
+    }
+
+    CompiledExpression& target;
+    const VariableSlots& slots;
+    const CompileOptions& options;
+    std::vector<Node> nodes;
+    std::unordered_map<Node, std::uint32_t, NodeHash> node_ids;
+    std::unordered_map<std::pair<std::uint64_t, std::uint64_t>, std::uint32_t, ConstantHash> constant_ids;
+};
+
+CompiledExpression::CompiledExpression(const Expression& expr, const VariableSlots& slots,
+                                       const CompileOptions& options) {
+    Compiler compiler(*this, slots, options);
+    result         = compiler.emit(expr.accept(compiler));
+    batch_accuracy = options.batch_accuracy;
+}
+
+BasicComplex<float> CompiledExpression::eval(std::span<const BasicComplex<float>> values) const {
+    return eval_inline(values);
+}
+
+Complex CompiledExpression::eval(std::span<const Complex> values) const {
+    return eval_inline(values);
+}
+
+BasicComplex<long double> CompiledExpression::eval(std::span<const BasicComplex<long double>> values) const {
+    return eval_inline(values);
+}
+
+BasicComplex<float> CompiledExpression::eval(std::span<const BasicComplex<float>> values,
+                                             std::span<BasicComplex<float>> scratch) const {
+    return eval_tape(values, scratch);
+}
+
+Complex CompiledExpression::eval(std::span<const Complex> values, std::span<Complex> scratch) const {
+    return eval_tape(values, scratch);
+}
+
+BasicComplex<long double> CompiledExpression::eval(std::span<const BasicComplex<long double>> values,
+                                                   std::span<BasicComplex<long double>> scratch) const {
+    return eval_tape(values, scratch);
+}
+
+void CompiledExpression::eval_batch(std::span<const BasicComplexColumn<float>> columns, std::size_t rows,
+                                    BasicMutableComplexColumn<float> out) const {
+    eval_rows(columns, 0, rows, out);
+}
+
+void CompiledExpression::eval_batch(std::span<const ComplexColumn> columns, std::size_t rows,
+                                    MutableComplexColumn out) const {
+    eval_rows(columns, 0, rows, out);
+}
+
+void CompiledExpression::eval_batch(std::span<const BasicComplexColumn<long double>> columns, std::size_t rows,
+                                    BasicMutableComplexColumn<long double> out) const {
+    eval_rows(columns, 0, rows, out);
+}
+
+void CompiledExpression::eval_parallel(ThreadPool& pool, std::span<const BasicComplexColumn<float>> columns,
+                                       std::size_t rows, BasicMutableComplexColumn<float> out,
+                                       std::size_t chunk_rows) const {
+    eval_chunks(pool, columns, rows, out, chunk_rows);
+}
+
+void CompiledExpression::eval_parallel(ThreadPool& pool, std::span<const ComplexColumn> columns, std::size_t rows,
+                                       MutableComplexColumn out, std::size_t chunk_rows) const {
+    eval_chunks(pool, columns, rows, out, chunk_rows);
+}
+
+void CompiledExpression::eval_parallel(ThreadPool& pool, std::span<const BasicComplexColumn<long double>> columns,
+                                       std::size_t rows, BasicMutableComplexColumn<long double> out,
+                                       std::size_t chunk_rows) const {
+    eval_chunks(pool, columns, rows, out, chunk_rows);
+}
+
+template <typename T>
+BasicComplex<T> CompiledExpression::eval_inline(std::span<const BasicComplex<T>> values) const {
+    if (registers <= INLINE_REGISTERS) {
+        std::array<BasicComplex<T>, INLINE_REGISTERS> scratch;
+        return eval_tape<T>(values, scratch);
+    }
+    std::vector<BasicComplex<T>> scratch(registers);
+    return eval_tape<T>(values, scratch);
+}
+
+template <typename T>
+BasicComplex<T> CompiledExpression::eval_tape(std::span<const BasicComplex<T>> values,
+                                              std::span<BasicComplex<T>> scratch) const {
+    if (values.size() < slots) {
+        throw std::out_of_range("not enough variable values");
+    }
+    if (scratch.size() < registers) {
+        throw std::out_of_range("scratch smaller than the register count");
+    }
+    for (const Instruction& instruction : instructions) {
+        BasicComplex<T>& destination = scratch[instruction.destination];
+        switch (instruction.code) {
+        case OpCode::Const:
+            destination = BasicComplex<T>(constants[instruction.left]);
+            break;
+        case OpCode::Load:
+            destination = values[instruction.left];
+            break;
+        case OpCode::Add:
+            destination = scratch[instruction.left] + scratch[instruction.right];
+            break;
+        case OpCode::Subtract:
+            destination = scratch[instruction.left] - scratch[instruction.right];
+            break;
+        case OpCode::Multiply:
+            destination = scratch[instruction.left] * scratch[instruction.right];
+            break;
+        case OpCode::Divide:
+            destination = scratch[instruction.left] / scratch[instruction.right];
+            break;
+        case OpCode::Negate:
+            destination = -scratch[instruction.left];
+            break;
+        case OpCode::Conjugate:
+            destination = ~scratch[instruction.left];
+            break;
+        case OpCode::Exp:
+            destination = exp(scratch[instruction.left]);
+            break;
+        case OpCode::Log:
+            destination = log(scratch[instruction.left]);
+            break;
+        case OpCode::Sqrt:
+            destination = sqrt(scratch[instruction.left]);
+            break;
+        case OpCode::Sin:
+            destination = sin(scratch[instruction.left]);
+            break;
+        case OpCode::Cos:
+            destination = cos(scratch[instruction.left]);
+            break;
+        case OpCode::Power:
+            destination = pow(scratch[instruction.left], std::bit_cast<std::int32_t>(instruction.right));
+            break;
+        case OpCode::ComplexPower:
+            destination = pow(scratch[instruction.left], scratch[instruction.right]);
+            break;
+        }
+    }
+    return scratch[result];
+}
+
+void CompiledExpression::check_columns(std::size_t count) const {
+    if (count < slots) {
+        throw std::out_of_range("not enough variable columns");
+    }
+}
+
+template <typename T>
+void CompiledExpression::eval_rows(std::span<const BasicComplexColumn<T>> columns, std::size_t first,
+                                   std::size_t count, BasicMutableComplexColumn<T> out) const {
+    check_columns(columns.size());
+    std::vector<T> scratch(2 * registers * std::min(count, BATCH_BLOCK));
+    for (std::size_t offset = 0; offset < count; offset += BATCH_BLOCK) {
+        eval_block<T>(columns, first + offset, std::min(BATCH_BLOCK, count - offset), scratch, out);
+    }
+}
+
+template <typename T>
+void CompiledExpression::eval_chunks(ThreadPool& pool, std::span<const BasicComplexColumn<T>> columns,
+                                     std::size_t rows, BasicMutableComplexColumn<T> out,
+                                     std::size_t chunk_rows) const {
+    check_columns(columns.size());
+    chunk_rows               = std::max<std::size_t>(chunk_rows, 1);
+    const std::size_t chunks = (rows + chunk_rows - 1) / chunk_rows;
+    pool.parallel_for(chunks, [&](std::size_t chunk) {
+        const std::size_t first = chunk * chunk_rows;
+        eval_rows(columns, first, std::min(chunk_rows, rows - first), out);
+    });
+}
+
+template <typename T>
+void CompiledExpression::eval_block(std::span<const BasicComplexColumn<T>> columns, std::size_t first,
+                                    std::size_t count, std::span<T> scratch, BasicMutableComplexColumn<T> out) const {
+    // Register r keeps its real parts at [2 * r * count, (2 * r + 1) * count) and its imaginary parts right after.
+    auto real = [&](std::uint32_t reg) { return scratch.data() + 2 * reg * count; };
+    auto imag = [&](std::uint32_t reg) { return scratch.data() + (2 * reg + 1) * count; };
+
+    for (const Instruction& instruction : instructions) {
+        T* real_out = real(instruction.destination);
+        T* imag_out = imag(instruction.destination);
+        switch (instruction.code) {
+        case OpCode::Const:
+            std::fill_n(real_out, count, static_cast<T>(constants[instruction.left].real()));
+            std::fill_n(imag_out, count, static_cast<T>(constants[instruction.left].imag()));
+            break;
+        case OpCode::Load:
+            std::copy_n(columns[instruction.left].real + first, count, real_out);
+            std::copy_n(columns[instruction.left].imag + first, count, imag_out);
+            break;
+        case OpCode::Add:
+            add_planes(count, real(instruction.left), imag(instruction.left), real(instruction.right),
+                       imag(instruction.right), real_out, imag_out);
+            break;
+        case OpCode::Subtract:
+            subtract_planes(count, real(instruction.left), imag(instruction.left), real(instruction.right),
+                            imag(instruction.right), real_out, imag_out);
+            break;
+        case OpCode::Multiply:
+            multiply_planes(count, real(instruction.left), imag(instruction.left), real(instruction.right),
+                            imag(instruction.right), real_out, imag_out);
+            break;
+        case OpCode::Divide:
+            divide_planes(count, real(instruction.left), imag(instruction.left), real(instruction.right),
+                          imag(instruction.right), real_out, imag_out);
+            break;
+        case OpCode::Negate:
+            negate_planes(count, real(instruction.left), imag(instruction.left), real_out, imag_out);
+            break;
+        case OpCode::Conjugate:
+            conjugate_planes(count, real(instruction.left), imag(instruction.left), real_out, imag_out);
+            break;
+        case OpCode::Exp:
+            exp_planes(count, real(instruction.left), imag(instruction.left), real_out, imag_out, batch_accuracy);
+            break;
+        case OpCode::Log:
+            log_planes(count, real(instruction.left), imag(instruction.left), real_out, imag_out, batch_accuracy);
+            break;
+        case OpCode::Sqrt:
+            sqrt_planes(count, real(instruction.left), imag(instruction.left), real_out, imag_out, batch_accuracy);
+            break;
+        case OpCode::Sin:
+            sin_planes(count, real(instruction.left), imag(instruction.left), real_out, imag_out, batch_accuracy);
+            break;
+        case OpCode::Cos:
+            cos_planes(count, real(instruction.left), imag(instruction.left), real_out, imag_out, batch_accuracy);
+            break;
+        case OpCode::Power:
+            pow_planes(count, real(instruction.left), imag(instruction.left),
+                       std::bit_cast<std::int32_t>(instruction.right), real_out, imag_out);
+            break;
+        case OpCode::ComplexPower:
+            pow_planes(count, real(instruction.left), imag(instruction.left), real(instruction.right),
+                       imag(instruction.right), real_out, imag_out, batch_accuracy);
+            break;
+        }
+    }
+    std::copy_n(real(result), count, out.real + first);
+    std::copy_n(imag(result), count, out.imag + first);
+}
+
+std::size_t CompiledExpression::register_count() const {
+    return registers;
+}
+
+std::size_t CompiledExpression::slot_count() const {
+    return slots;
+}
+
+std::size_t CompiledExpression::instruction_count() const {
+    return instructions.size();
+}
@@ -0,0 +1,574 @@
+#include "expressions/expression_file.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "complex/complex_math.hpp"
+
+namespace {
+
+constexpr char MAGIC[8]                   = {'C', 'X', 'E', 'X', 'P', 'R', '\0', '\0'};
+constexpr char ARCHIVE_MAGIC[8]           = {'C', 'X', 'E', 'X', 'P', 'R', 'A', '\0'};
+constexpr std::size_t HEADER_SIZE         = 32;
+constexpr std::size_t ARCHIVE_HEADER_SIZE = 16;
+constexpr std::size_t ARCHIVE_ENTRY_SIZE  = 16;
+constexpr std::size_t NODE_SIZE           = 12;
+constexpr std::size_t CONSTANT_SIZE       = 16;
+
+// Values are part of the file format, new kinds are only ever appended. The right operand
+// of Power is the bit pattern of its exponent.
+enum class Kind : std::uint32_t {
+    Const,
+    Variable,
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    Negate,
+    Conjugate,
+    Exp,
+    Log,
+    Sqrt,
+    Sin,
+    Cos,
+    Power,
+    ComplexPower
+};
+
+// Byte-wise loads and stores keep the format little-endian on every host and allow
+// unaligned data; compilers turn them into plain moves on little-endian machines.
+std::uint32_t load_u32(const unsigned char* bytes) {
+    return static_cast<std::uint32_t>(bytes[0]) | static_cast<std::uint32_t>(bytes[1]) << 8 |
+           static_cast<std::uint32_t>(bytes[2]) << 16 | static_cast<std::uint32_t>(bytes[3]) << 24;
+}
+
+std::uint64_t load_u64(const unsigned char* bytes) {
+    return load_u32(bytes) | static_cast<std::uint64_t>(load_u32(bytes + 4)) << 32;
+}
+
+double load_f64(const unsigned char* bytes) {
+    return std::bit_cast<double>(load_u64(bytes));
+}
+
+void store_u32(std::string& out, std::uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out += static_cast<char>((value >> shift) & 0xFF);
+    }
+}
+
+void store_u64(std::string& out, std::uint64_t value) {
+    store_u32(out, static_cast<std::uint32_t>(value));
+    store_u32(out, static_cast<std::uint32_t>(value >> 32));
+}
+
+void store_f64(std::string& out, double value) {
+    store_u64(out, std::bit_cast<std::uint64_t>(value));
+}
+
+std::uint32_t fnv1a(const unsigned char* bytes, std::size_t size) {
+    std::uint32_t hash = 2166136261U;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 16777619U;
+    }
+    return hash;
+}
+
+std::size_t align8(std::size_t offset) {
+    return (offset + 7) & ~static_cast<std::size_t>(7);
+}
+
+std::uint32_t checked_u32(std::size_t value) {
+    if (value > UINT32_MAX) {
+        throw std::length_error("expression is too large for the file format");
+    }
+    return static_cast<std::uint32_t>(value);
+}
+
+class Writer: public ExpressionVisitor {
+public:
+    std::uint32_t visit_const(const Complex& value) {
+        constants.push_back(value);
+        return add(Kind::Const, checked_u32(constants.size() - 1), 0);
+    }
+
+    std::uint32_t visit_variable(const std::string& name) {
+        auto existing = name_ids.find(name);
+        if (existing == name_ids.end()) {
+            names.push_back(name);
+            existing = name_ids.emplace(name, checked_u32(names.size() - 1)).first;
+        }
+        return add(Kind::Variable, existing->second, 0);
+    }
+
+    std::uint32_t visit_unary(Operation operation, std::uint32_t operand) {
+        return add(kind(operation), operand, 0);
+    }
+
+    std::uint32_t visit_binary(Operation operation, std::uint32_t left, std::uint32_t right) {
+        return add(kind(operation), left, right);
+    }
+
+    std::uint32_t visit_power(std::uint32_t base, std::int32_t exponent) {
+        return add(Kind::Power, base, std::bit_cast<std::uint32_t>(exponent));
+    }
+
+    std::string serialize() const {
+        std::string body;
+        for (const std::uint32_t value : nodes) {
+            store_u32(body, value);
+        }
+        body.resize(align8(HEADER_SIZE + body.size()) - HEADER_SIZE);
+        for (const Complex& value : constants) {
+            store_f64(body, value.real());
+            store_f64(body, value.imag());
+        }
+        std::size_t name_size = 0;
+        for (const std::string& name : names) {
+            name_size += name.size();
+            store_u32(body, checked_u32(name_size));
+        }
+        for (const std::string& name : names) {
+            body += name;
+        }
+
+        std::string out(MAGIC, sizeof(MAGIC));
+        store_u32(out, ExpressionView::VERSION);
+        store_u32(out, checked_u32(nodes.size() / 3));
+        store_u32(out, checked_u32(constants.size()));
+        store_u32(out, checked_u32(names.size()));
+        store_u32(out, checked_u32(name_size));
+        store_u32(out, fnv1a(reinterpret_cast<const unsigned char*>(body.data()), body.size()));
+        return out + body;
+    }
+
+private:
+    std::uint32_t add(Kind node_kind, std::uint32_t left, std::uint32_t right) {
+        nodes.insert(nodes.end(), {static_cast<std::uint32_t>(node_kind), left, right});
+        return checked_u32(nodes.size() / 3 - 1);
+    }
+
+    static Kind kind(Operation operation) {
+        switch (operation) {
+        case Operation::Add:
+            return Kind::Add;
+        case Operation::Subtract:
+            return Kind::Subtract;
+        case Operation::Multiply:
+            return Kind::Multiply;
+        case Operation::Divide:
+            return Kind::Divide;
+        case Operation::Negate:
+            return Kind::Negate;
+        case Operation::Conjugate:
+            return Kind::Conjugate;
+        case Operation::Exp:
+            return Kind::Exp;
+        case Operation::Log:
+            return Kind::Log;
+        case Operation::Sqrt:
+            return Kind::Sqrt;
+        case Operation::Sin:
+            return Kind::Sin;
+        case Operation::Cos:
+            return Kind::Cos;
+        case Operation::Power:
+            return Kind::Power;
+        case Operation::ComplexPower:
+            return Kind::ComplexPower;
+        }
+        throw std::invalid_argument("unknown operation");
+    }
+
+    std::vector<std::uint32_t> nodes;
+    std::vector<Complex> constants;
+    std::vector<std::string> names;
+    std::unordered_map<std::string, std::uint32_t> name_ids;
+};
+
+// POSIX calls rather than an ofstream, which does not report why a write failed.
+void write_file(const std::string& bytes, const std::string& path) {
+    const int descriptor = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (descriptor < 0) {
+        throw std::system_error(errno, std::generic_category(), "cannot open " + path);
+    }
+    std::size_t written = 0;
+    while (written < bytes.size()) {
+        const ssize_t count = ::write(descriptor, bytes.data() + written, bytes.size() - written);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count < 0) {
+            const int error = errno;
+            ::close(descriptor);
+            throw std::system_error(error, std::generic_category(), "cannot write " + path);
+        }
+        written += static_cast<std::size_t>(count);
+    }
+    if (::close(descriptor) != 0) {
+        throw std::system_error(errno, std::generic_category(), "cannot write " + path);
+    }
+}
+
+[[noreturn]] void corrupt_node(std::uint32_t id) {
+    throw std::runtime_error("corrupt expression file node " + std::to_string(id));
+}
+
+}  // namespace
+
+std::string serialize_expression(const Expression& expr) {
+    Writer writer;
+    expr.accept(writer);
+    return writer.serialize();
+}
+
+void save_expression(const Expression& expr, const std::string& path) {
+    write_file(serialize_expression(expr), path);
+}
+
+std::string serialize_archive(std::span<const std::shared_ptr<Expression>> expressions) {
+    std::string body;
+    std::string table;
+    const std::size_t start = ARCHIVE_HEADER_SIZE + ARCHIVE_ENTRY_SIZE * expressions.size();
+    for (const std::shared_ptr<Expression>& expr : expressions) {
+        const std::string bytes = serialize_expression(*expr);
+        store_u64(table, start + body.size());
+        store_u64(table, bytes.size());
+        body += bytes;
+        body.resize(align8(body.size()));
+    }
+
+    std::string out(ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+    store_u32(out, MappedArchive::VERSION);
+    store_u32(out, checked_u32(expressions.size()));
+    return out + table + body;
+}
+
+void save_archive(std::span<const std::shared_ptr<Expression>> expressions, const std::string& path) {
+    write_file(serialize_archive(expressions), path);
+}
+
+ExpressionView::ExpressionView(const unsigned char* data, std::size_t size) : data(data), size(size) {
+    if (size < HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("not an expression file");
+    }
+    if (load_u32(data + 8) != VERSION) {
+        throw std::runtime_error("unsupported expression file version");
+    }
+    total_nodes     = load_u32(data + 12);
+    total_constants = load_u32(data + 16);
+    total_names     = load_u32(data + 20);
+    name_end        = load_u32(data + 24);
+
+    const std::size_t constants_offset = align8(HEADER_SIZE + std::size_t{NODE_SIZE} * total_nodes);
+    const std::size_t offsets_offset   = constants_offset + CONSTANT_SIZE * total_constants;
+    const std::size_t names_offset     = offsets_offset + std::size_t{4} * total_names;
+    if (total_nodes == 0 || names_offset + name_end != size) {
+        throw std::runtime_error("truncated expression file");
+    }
+    nodes      = data + HEADER_SIZE;
+    constants  = data + constants_offset;
+    offsets    = data + offsets_offset;
+    name_bytes = reinterpret_cast<const char*>(data + names_offset);
+}
+
+Complex ExpressionView::eval(const std::unordered_map<std::string, Complex>& values) const {
+    std::vector<Complex> slots;
+    slots.reserve(total_names);
+    for (std::size_t i = 0; i < total_names; ++i) {
+        slots.push_back(values.at(std::string(variable_name(i))));
+    }
+    return eval(slots);
+}
+
+Complex ExpressionView::eval(std::span<const Complex> values) const {
+    if (values.size() < total_names) {
+        throw std::invalid_argument("not enough variable values");
+    }
+    return eval_nodes([&](std::uint32_t variable) { return values[variable]; });
+}
+
+std::size_t ExpressionView::node_count() const {
+    return total_nodes;
+}
+
+std::size_t ExpressionView::variable_count() const {
+    return total_names;
+}
+
+std::string_view ExpressionView::variable_name(std::size_t index) const {
+    if (index >= total_names) {
+        throw std::out_of_range("variable index out of range");
+    }
+    const std::uint32_t begin = index == 0 ? 0 : load_u32(offsets + 4 * (index - 1));
+    const std::uint32_t end   = load_u32(offsets + 4 * index);
+    if (begin > end || end > name_end) {
+        throw std::runtime_error("corrupt expression file name table");
+    }
+    return {name_bytes + begin, end - begin};
+}
+
+// Children have to precede their parents, so one pass in id order sees every operand
+// before its users and evaluates shared subexpressions once.
+template <typename Lookup>
+Complex ExpressionView::eval_nodes(const Lookup& lookup) const {
+    std::vector<Complex> results(total_nodes);
+    for (std::uint32_t id = 0; id < total_nodes; ++id) {
+        const unsigned char* node = nodes + NODE_SIZE * id;
+        const std::uint32_t left  = load_u32(node + 4);
+        const std::uint32_t right = load_u32(node + 8);
+        const auto operand        = [&](std::uint32_t child) {
+            if (child >= id) {
+                corrupt_node(id);
+            }
+            return results[child];
+        };
+        Complex& result = results[id];
+        switch (static_cast<Kind>(load_u32(node))) {
+        case Kind::Const:
+            if (left >= total_constants) {
+                corrupt_node(id);
+            }
+            result = Complex(load_f64(constants + CONSTANT_SIZE * left),
+                             load_f64(constants + CONSTANT_SIZE * left + 8));
+            break;
+        case Kind::Variable:
+            if (left >= total_names) {
+                corrupt_node(id);
+            }
+            result = lookup(left);
+            break;
+        case Kind::Add:
+            result = operand(left) + operand(right);
+            break;
+        case Kind::Subtract:
+            result = operand(left) - operand(right);
+            break;
+        case Kind::Multiply:
+            result = operand(left) * operand(right);
+            break;
+        case Kind::Divide:
+            result = operand(left) / operand(right);
+            break;
+        case Kind::Negate:
+            result = -operand(left);
+            break;
+        case Kind::Conjugate:
+            result = ~operand(left);
+            break;
+        case Kind::Exp:
+            result = exp(operand(left));
+            break;
+        case Kind::Log:
+            result = log(operand(left));
+            break;
+        case Kind::Sqrt:
+            result = sqrt(operand(left));
+            break;
+        case Kind::Sin:
+            result = sin(operand(left));
+            break;
+        case Kind::Cos:
+            result = cos(operand(left));
+            break;
+        case Kind::Power:
+            result = pow(operand(left), std::bit_cast<std::int32_t>(right));
+            break;
+        case Kind::ComplexPower:
+            result = pow(operand(left), operand(right));
+            break;
+        default:
+            corrupt_node(id);
+        }
+    }
+    return results.back();
+}
+
+void ExpressionView::verify() const {
+    if (fnv1a(data + HEADER_SIZE, size - HEADER_SIZE) != load_u32(data + 28)) {
+        throw std::runtime_error("expression file checksum mismatch");
+    }
+
+    std::uint32_t previous = 0;
+    for (std::uint32_t i = 0; i < total_names; ++i) {
+        const std::uint32_t offset = load_u32(offsets + 4 * i);
+        if (offset < previous || offset > name_end) {
+            throw std::runtime_error("corrupt expression file name table");
+        }
+        previous = offset;
+    }
+    if (previous != name_end) {
+        throw std::runtime_error("corrupt expression file name table");
+    }
+
+    for (std::uint32_t i = 0; i < total_nodes; ++i) {
+        const unsigned char* node = nodes + NODE_SIZE * i;
+        const std::uint32_t left  = load_u32(node + 4);
+        const std::uint32_t right = load_u32(node + 8);
+        bool valid                = false;
+        switch (static_cast<Kind>(load_u32(node))) {
+        case Kind::Const:
+            valid = left < total_constants;
+            break;
+        case Kind::Variable:
+            valid = left < total_names;
+            break;
+        case Kind::Add:
+        case Kind::Subtract:
+        case Kind::Multiply:
+        case Kind::Divide:
+        case Kind::ComplexPower:
+            valid = left < i && right < i;
+            break;
+        case Kind::Negate:
+        case Kind::Conjugate:
+        case Kind::Exp:
+        case Kind::Log:
+        case Kind::Sqrt:
+        case Kind::Sin:
+        case Kind::Cos:
+        case Kind::Power:
+            valid = left < i;
+            break;
+        }
+        if (!valid) {
+            corrupt_node(i);
+        }
+    }
+}
+
+MappedFile::MappedFile(const std::string& path) {
+    const int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0) {
+        throw std::system_error(errno, std::generic_category(), "cannot open " + path);
+    }
+    struct stat status = {};
+    if (::fstat(descriptor, &status) != 0) {
+        const int error = errno;
+        ::close(descriptor);
+        throw std::system_error(error, std::generic_category(), "cannot stat " + path);
+    }
+    length = static_cast<std::size_t>(status.st_size);
+    if (length == 0) {
+        ::close(descriptor);
+        return;
+    }
+    void* mapping   = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    const int error = errno;
+    ::close(descriptor);
+    if (mapping == MAP_FAILED) {
+        length = 0;
+        throw std::system_error(error, std::generic_category(), "cannot map " + path);
+    }
+    bytes = static_cast<const unsigned char*>(mapping);
+}
+
+MappedFile::MappedFile(MappedFile&& file) noexcept
+    : bytes(std::exchange(file.bytes, nullptr)), length(std::exchange(file.length, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& file) noexcept {
+    if (this != &file) {
+        unmap();
+        bytes  = std::exchange(file.bytes, nullptr);
+        length = std::exchange(file.length, 0);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+const unsigned char* MappedFile::data() const {
+    return bytes;
+}
+
+std::size_t MappedFile::size() const {
+    return length;
+}
+
+void MappedFile::unmap() noexcept {
+    if (bytes != nullptr) {
+        ::munmap(const_cast<unsigned char*>(bytes), length);
+        bytes  = nullptr;
+        length = 0;
+    }
+}
+
+MappedExpression::MappedExpression(const std::string& path)
+    : file(path), expression(file.data(), file.size()) {}
+
+Complex MappedExpression::eval(const std::unordered_map<std::string, Complex>& values) const {
+    return expression.eval(values);
+}
+
+Complex MappedExpression::eval(std::span<const Complex> values) const {
+    return expression.eval(values);
+}
+
+std::size_t MappedExpression::node_count() const {
+    return expression.node_count();
+}
+
+std::size_t MappedExpression::variable_count() const {
+    return expression.variable_count();
+}
+
+std::string_view MappedExpression::variable_name(std::size_t index) const {
+    return expression.variable_name(index);
+}
+
+void MappedExpression::verify() const {
+    expression.verify();
+}
+
+const ExpressionView& MappedExpression::view() const {
+    return expression;
+}
+
+MappedArchive::MappedArchive(const std::string& path) : file(path) {
+    const unsigned char* data = file.data();
+    if (file.size() < ARCHIVE_HEADER_SIZE || std::memcmp(data, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0) {
+        throw std::runtime_error(path + " is not an expression archive");
+    }
+    if (load_u32(data + 8) != VERSION) {
+        throw std::runtime_error("unsupported expression archive version");
+    }
+    count = load_u32(data + 12);
+    if (file.size() < ARCHIVE_HEADER_SIZE + ARCHIVE_ENTRY_SIZE * count) {
+        throw std::runtime_error("truncated expression archive");
+    }
+}
+
+std::size_t MappedArchive::size() const {
+    return count;
+}
+
+ExpressionView MappedArchive::operator[](std::size_t index) const {
+    if (index >= count) {
+        throw std::out_of_range("expression index out of range");
+    }
+    const unsigned char* entry = file.data() + ARCHIVE_HEADER_SIZE + ARCHIVE_ENTRY_SIZE * index;
+    const std::uint64_t offset = load_u64(entry);
+    const std::uint64_t length = load_u64(entry + 8);
+    if (offset < ARCHIVE_HEADER_SIZE + ARCHIVE_ENTRY_SIZE * count || offset % 8 != 0 || offset > file.size() ||
+        length > file.size() - offset) {
+        throw std::runtime_error("corrupt expression archive offsets");
+    }
+    return ExpressionView(file.data() + offset, length);
+}
+
+void MappedArchive::verify() const {
+    for (std::size_t i = 0; i < count; ++i) {
+        (*this)[i].verify();
+    }
+}
@@ -0,0 +1,213 @@
+#include "expressions/expression_store.hpp"
+
+#include <bit>
+#include <stdexcept>
+
+#include "complex/complex_math.hpp"
+#include "expressions/parser.hpp"
+
+class ExpressionStore::Builder: public ExpressionVisitor {
+public:
+    explicit Builder(ExpressionStore& store) : store(store) {}
+
+    std::uint32_t visit_const(const Complex& value) {
+        store.constants.push_back(value);
+        return add({Leaf::Const, {}, static_cast<std::uint32_t>(store.constants.size() - 1), 0});
+    }
+
+    std::uint32_t visit_variable(const std::string& name) {
+        auto existing = store.name_ids.find(name);
+        if (existing == store.name_ids.end()) {
+            // A deque never moves its elements, so the string_view keys stay valid.
+            store.names.push_back(name);
+            existing = store.name_ids.emplace(store.names.back(), store.names.size() - 1).first;
+        }
+        return add({Leaf::Variable, {}, existing->second, 0});
+    }
+
+    std::uint32_t visit_unary(Operation operation, std::uint32_t operand) {
+        return add({Leaf::None, operation, operand, 0});
+    }
+
+    std::uint32_t visit_binary(Operation operation, std::uint32_t left, std::uint32_t right) {
+        return add({Leaf::None, operation, left, right});
+    }
+
+    std::uint32_t visit_power(std::uint32_t base, std::int32_t exponent) {
+        return add({Leaf::None, Operation::Power, base, std::bit_cast<std::uint32_t>(exponent)});
+    }
+
+private:
+    std::uint32_t add(const Node& node) {
+        store.nodes.push_back(node);
+        return static_cast<std::uint32_t>(store.nodes.size() - 1);
+    }
+
+    ExpressionStore& store;
+};
+
+ExpressionStore::ExpressionStore(const ExpressionStore& store)
+    : nodes(store.nodes), constants(store.constants), names(store.names) {
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        name_ids.emplace(names[i], static_cast<std::uint32_t>(i));
+    }
+}
+
+ExpressionStore& ExpressionStore::operator=(const ExpressionStore& store) {
+    if (this != &store) {
+        *this = ExpressionStore(store);
+    }
+    return *this;
+}
+
+ExpressionId ExpressionStore::add(const Expression& expr) {
+    Builder builder(*this);
+    return expr.accept(builder);
+}
+
+ExpressionId ExpressionStore::parse(std::string_view text) {
+    const std::size_t node_end     = nodes.size();
+    const std::size_t constant_end = constants.size();
+    const std::size_t name_end     = names.size();
+    try {
+        Builder builder(*this);
+        return parse_expression(text, builder);
+    } catch (const ParseError&) {
+        nodes.resize(node_end);
+        constants.resize(constant_end);
+        while (names.size() > name_end) {
+            name_ids.erase(names.back());
+            names.pop_back();
+        }
+        throw;
+    }
+}
+
+Complex ExpressionStore::eval(ExpressionId root, const std::unordered_map<std::string, Complex>& values) const {
+    return eval_node(root, [&](std::uint32_t variable) { return values.at(names[variable]); });
+}
+
+Complex ExpressionStore::eval(ExpressionId root, std::span<const Complex> values) const {
+    return eval_node(root, [&](std::uint32_t variable) {
+        if (variable >= values.size()) {
+            throw std::out_of_range("variable " + names[variable] + " has no value in its slot");
+        }
+        return values[variable];
+    });
+}
+
+template <typename Lookup>
+Complex ExpressionStore::eval_node(ExpressionId id, const Lookup& lookup) const {
+    const Node& node = nodes[id];
+    switch (node.leaf) {
+    case Leaf::Const:
+        return constants[node.left];
+    case Leaf::Variable:
+        return lookup(node.left);
+    case Leaf::None:
+        break;
+    }
+    switch (node.operation) {
+    case Operation::Add:
+        return eval_node(node.left, lookup) + eval_node(node.right, lookup);
+    case Operation::Subtract:
+        return eval_node(node.left, lookup) - eval_node(node.right, lookup);
+    case Operation::Multiply:
+        return eval_node(node.left, lookup) * eval_node(node.right, lookup);
+    case Operation::Divide:
+        return eval_node(node.left, lookup) / eval_node(node.right, lookup);
+    case Operation::Negate:
+        return -eval_node(node.left, lookup);
+    case Operation::Conjugate:
+        return ~eval_node(node.left, lookup);
+    case Operation::Exp:
+        return exp(eval_node(node.left, lookup));
+    case Operation::Log:
+        return log(eval_node(node.left, lookup));
+    case Operation::Sqrt:
+        return sqrt(eval_node(node.left, lookup));
+    case Operation::Sin:
+        return sin(eval_node(node.left, lookup));
+    case Operation::Cos:
+        return cos(eval_node(node.left, lookup));
+    case Operation::Power:
+        return pow(eval_node(node.left, lookup), std::bit_cast<std::int32_t>(node.right));
+    case Operation::ComplexPower:
+        return pow(eval_node(node.left, lookup), eval_node(node.right, lookup));
+    }
+    throw std::logic_error("unknown node kind");
+}
+
+std::string ExpressionStore::str(ExpressionId root) const {
+    std::string out;
+    write(root, out);
+    return out;
+}
+
+void ExpressionStore::write(ExpressionId id, std::string& out) const {
+    const Node& node = nodes[id];
+    switch (node.leaf) {
+    case Leaf::Const:
+        out += constants[node.left].str();
+        return;
+    case Leaf::Variable:
+        out += names[node.left];
+        return;
+    case Leaf::None:
+        break;
+    }
+    switch (node.operation) {
+    case Operation::Negate:
+    case Operation::Conjugate:
+        out += '(';
+        out += operation_sign(node.operation);
+        write(node.left, out);
+        out += ')';
+        return;
+    case Operation::Exp:
+    case Operation::Log:
+    case Operation::Sqrt:
+    case Operation::Sin:
+    case Operation::Cos:
+        out += operation_sign(node.operation);
+        out += '(';
+        write(node.left, out);
+        out += ')';
+        return;
+    case Operation::Power:
+        out += '(';
+        write(node.left, out);
+        out += " ^ ";
+        out += std::to_string(std::bit_cast<std::int32_t>(node.right));
+        out += ')';
+        return;
+    default:
+        break;
+    }
+    out += '(';
+    write(node.left, out);
+    out += ' ';
+    out += operation_sign(node.operation);
+    out += ' ';
+    write(node.right, out);
+    out += ')';
+}
+
+std::uint32_t ExpressionStore::variable_id(std::string_view name) const {
+    return name_ids.at(name);
+}
+
+const std::deque<std::string>& ExpressionStore::variable_names() const {
+    return names;
+}
+
+std::size_t ExpressionStore::node_count() const {
+    return nodes.size();
+}
+
+void ExpressionStore::clear() {
+    nodes     = {};
+    constants = {};
+    name_ids  = {};
+    names     = {};
+}
@@ -1,8 +1,105 @@
 #include "expressions/expressions.hpp"
 
+#include <stdexcept>
+
+#include "complex/complex_math.hpp"
+
+std::string_view operation_sign(Operation operation) {
+    switch (operation) {
+    case Operation::Add:
+        return "+";
+    case Operation::Subtract:
+    case Operation::Negate:
+        return "-";
+    case Operation::Multiply:
+        return "*";
+    case Operation::Divide:
+        return "/";
+    case Operation::Conjugate:
+        return "~";
+    case Operation::Exp:
+        return "exp";
+    case Operation::Log:
+        return "log";
+    case Operation::Sqrt:
+        return "sqrt";
+    case Operation::Sin:
+        return "sin";
+    case Operation::Cos:
+        return "cos";
+    case Operation::Power:
+    case Operation::ComplexPower:
+        return "^";
+    }
+    throw std::invalid_argument("unknown operation");
+}
+
+std::string_view operation_name(Operation operation) {
+    switch (operation) {
+    case Operation::Add:
+        return "Add";
+    case Operation::Subtract:
+        return "Subtract";
+    case Operation::Multiply:
+        return "Multiply";
+    case Operation::Divide:
+        return "Divide";
+    case Operation::Negate:
+        return "Negate";
+    case Operation::Conjugate:
+        return "Conjugate";
+    case Operation::Exp:
+        return "Exp";
+    case Operation::Log:
+        return "Log";
+    case Operation::Sqrt:
+        return "Sqrt";
+    case Operation::Sin:
+        return "Sin";
+    case Operation::Cos:
+        return "Cos";
+    case Operation::Power:
+        return "Power";
+    case Operation::ComplexPower:
+        return "ComplexPower";
+    }
+    throw std::invalid_argument("unknown operation");
+}
+
+std::size_t operation_arity(Operation operation) {
+    switch (operation) {
+    case Operation::Add:
+    case Operation::Subtract:
+    case Operation::Multiply:
+    case Operation::Divide:
+    case Operation::ComplexPower:
+        return 2;
+    case Operation::Negate:
+    case Operation::Conjugate:
+    case Operation::Exp:
+    case Operation::Log:
+    case Operation::Sqrt:
+    case Operation::Sin:
+    case Operation::Cos:
+    case Operation::Power:
+        return 1;
+    }
+    throw std::invalid_argument("unknown operation");
+}
+
+std::string Expression::str() const {
+    std::string out;
+    write_to(out);
+    return out;
+}
+
 Const::Const(const Complex& const_value) : const_value(const_value) {}
 
-Complex Const::eval(const std::unordered_map<std::string, Complex> values) const {
+Complex Const::eval(const std::unordered_map<std::string, Complex>& values) const {
+    return const_value;
+}
+
+Complex Const::eval(std::span<const Complex> /*values*/) const {
     return const_value;
 }
 
@@ -10,150 +107,542 @@ Expression* Const::clone() const {
     return new Const(*this);
 }
 
-std::string Const::str() const {
-    return const_value.str();
+Expression* Const::move_clone() {
+    return new Const(std::move(*this));
+}
+
+void Const::write_to(std::string& out) const {
+    out += const_value.str();
+}
+
+void Const::write_to(std::ostream& out) const {
+    out << const_value;
+}
+
+Expression* Const::bind(const VariableSlots& /*slots*/) const {
+    return new Const(*this);
+}
+
+std::uint32_t Const::accept(ExpressionVisitor& visitor) const {
+    return visitor.visit_const(const_value);
 }
 
 Variable::Variable(std::string&& variable_name) : variable_name(std::move(variable_name)) {}
 
-Complex Variable::eval(const std::unordered_map<std::string, Complex> values) const {
+Complex Variable::eval(const std::unordered_map<std::string, Complex>& values) const {
     return values.at(variable_name);
 }
 
+Complex Variable::eval(std::span<const Complex> values) const {
+    if (variable_slot == UNBOUND) {
+        throw std::logic_error("variable " + variable_name + " is not bound to a slot");
+    }
+    if (variable_slot >= values.size()) {
+        throw std::out_of_range("variable " + variable_name + " has no value in its slot");
+    }
+    return values[variable_slot];
+}
+
 Expression* Variable::clone() const {
     return new Variable(*this);
 }
 
-std::string Variable::str() const {
-    return variable_name;
+Expression* Variable::move_clone() {
+    return new Variable(std::move(*this));
+}
+
+void Variable::write_to(std::string& out) const {
+    out += variable_name;
+}
+
+void Variable::write_to(std::ostream& out) const {
+    out << variable_name;
+}
+
+Expression* Variable::bind(const VariableSlots& slots) const {
+    auto* bound          = new Variable(*this);
+    bound->variable_slot = slots.at(variable_name);
+    return bound;
+}
+
+std::uint32_t Variable::accept(ExpressionVisitor& visitor) const {
+    return visitor.visit_variable(variable_name);
 }
 
 BinaryOperation::BinaryOperation(const Expression& left_operand, const Expression& right_opernad)
     : left_operand(left_operand.clone()), right_operand(right_opernad.clone()) {}
 
-Complex BinaryOperation::eval(const std::unordered_map<std::string, Complex> values) const {
+BinaryOperation::BinaryOperation(std::shared_ptr<Expression> left_operand, std::shared_ptr<Expression> right_operand)
+    : left_operand(std::move(left_operand)), right_operand(std::move(right_operand)) {}
+
+Complex BinaryOperation::eval(const std::unordered_map<std::string, Complex>& values) const {
     return compute_operation(left_operand->eval(values), right_operand->eval(values));
 }
 
-std::string BinaryOperation::str() const {
-    return '(' + left_operand->str() + ' ' + operation_sign() + ' ' + right_operand->str() + ')';
+Complex BinaryOperation::eval(std::span<const Complex> values) const {
+    return compute_operation(left_operand->eval(values), right_operand->eval(values));
+}
+
+void BinaryOperation::write_to(std::string& out) const {
+    out += '(';
+    left_operand->write_to(out);
+    out += ' ';
+    out += operation_sign(operation());
+    out += ' ';
+    right_operand->write_to(out);
+    out += ')';
+}
+
+void BinaryOperation::write_to(std::ostream& out) const {
+    out << '(';
+    left_operand->write_to(out);
+    out << ' ' << operation_sign(operation()) << ' ';
+    right_operand->write_to(out);
+    out << ')';
+}
+
+Expression* BinaryOperation::bind(const VariableSlots& slots) const {
+    std::shared_ptr<Expression> bound_left(left_operand->bind(slots));
+    std::shared_ptr<Expression> bound_right(right_operand->bind(slots));
+    auto* bound          = static_cast<BinaryOperation*>(clone());
+    bound->left_operand  = std::move(bound_left);
+    bound->right_operand = std::move(bound_right);
+    return bound;
+}
+
+std::uint32_t BinaryOperation::accept(ExpressionVisitor& visitor) const {
+    const std::uint32_t left_id = left_operand->accept(visitor);
+    return visitor.visit_binary(operation(), left_id, right_operand->accept(visitor));
 }
 
 UnaryOperation::UnaryOperation(const Expression& operand) : operand(operand.clone()) {}
 
-Complex UnaryOperation::eval(const std::unordered_map<std::string, Complex> values) const {
+UnaryOperation::UnaryOperation(std::shared_ptr<Expression> operand) : operand(std::move(operand)) {}
+
+Complex UnaryOperation::eval(const std::unordered_map<std::string, Complex>& values) const {
+    return compute_operation(operand->eval(values));
+}
+
+Complex UnaryOperation::eval(std::span<const Complex> values) const {
     return compute_operation(operand->eval(values));
 }
 
-std::string UnaryOperation::str() const {
-    return '(' + operation_sign() + operand->str() + ')';
+void UnaryOperation::write_to(std::string& out) const {
+    out += '(';
+    out += operation_sign(operation());
+    operand->write_to(out);
+    out += ')';
+}
+
+void UnaryOperation::write_to(std::ostream& out) const {
+    out << '(' << operation_sign(operation());
+    operand->write_to(out);
+    out << ')';
+}
+
+Expression* UnaryOperation::bind(const VariableSlots& slots) const {
+    std::shared_ptr<Expression> bound_operand(operand->bind(slots));
+    auto* bound    = static_cast<UnaryOperation*>(clone());
+    bound->operand = std::move(bound_operand);
+    return bound;
+}
+
+std::uint32_t UnaryOperation::accept(ExpressionVisitor& visitor) const {
+    return visitor.visit_unary(operation(), operand->accept(visitor));
+}
+
+const Expression& UnaryOperation::operand_expression() const {
+    return *operand;
+}
+
+void ElementaryFunction::write_to(std::string& out) const {
+    out += operation_sign(operation());
+    out += '(';
+    operand_expression().write_to(out);
+    out += ')';
+}
+
+void ElementaryFunction::write_to(std::ostream& out) const {
+    out << operation_sign(operation()) << '(';
+    operand_expression().write_to(out);
+    out << ')';
 }
 
 Add::Add(const Expression& left_operand, const Expression& right_operand)
     : BinaryOperation(left_operand, right_operand) {}
 
+Add::Add(std::shared_ptr<Expression> left_operand, std::shared_ptr<Expression> right_operand)
+    : BinaryOperation(std::move(left_operand), std::move(right_operand)) {}
+
 Expression* Add::clone() const {
     return new Add(*this);
 }
 
+Expression* Add::move_clone() {
+    return new Add(std::move(*this));
+}
+
 Complex Add::compute_operation(const Complex& left_operand_value, const Complex& right_operand_value) const {
     return left_operand_value + right_operand_value;
 }
 
-std::string Add::operation_sign() const {
-    return "+";
+Operation Add::operation() const {
+    return Operation::Add;
 }
 
 Subtract::Subtract(const Expression& left_operand, const Expression& right_operand)
     : BinaryOperation(left_operand, right_operand) {}
 
+Subtract::Subtract(std::shared_ptr<Expression> left_operand, std::shared_ptr<Expression> right_operand)
+    : BinaryOperation(std::move(left_operand), std::move(right_operand)) {}
+
 Expression* Subtract::clone() const {
     return new Subtract(*this);
 }
 
+Expression* Subtract::move_clone() {
+    return new Subtract(std::move(*this));
+}
+
 Complex Subtract::compute_operation(const Complex& left_operand_value, const Complex& right_operand_value) const {
     return left_operand_value - right_operand_value;
 }
 
-std::string Subtract::operation_sign() const {
-    return "-";
+Operation Subtract::operation() const {
+    return Operation::Subtract;
 }
 
 Multiply::Multiply(const Expression& left_operand, const Expression& right_operand)
     : BinaryOperation(left_operand, right_operand) {}
 
+Multiply::Multiply(std::shared_ptr<Expression> left_operand, std::shared_ptr<Expression> right_operand)
+    : BinaryOperation(std::move(left_operand), std::move(right_operand)) {}
+
 Expression* Multiply::clone() const {
     return new Multiply(*this);
 }
 
+Expression* Multiply::move_clone() {
+    return new Multiply(std::move(*this));
+}
+
 Complex Multiply::compute_operation(const Complex& left_operand_value, const Complex& right_operand_value) const {
     return left_operand_value * right_operand_value;
 }
 
-std::string Multiply::operation_sign() const {
-    return "*";
+Operation Multiply::operation() const {
+    return Operation::Multiply;
 }
 
 Divide::Divide(const Expression& left_operand, const Expression& right_operand)
     : BinaryOperation(left_operand, right_operand) {}
 
+Divide::Divide(std::shared_ptr<Expression> left_operand, std::shared_ptr<Expression> right_operand)
+    : BinaryOperation(std::move(left_operand), std::move(right_operand)) {}
+
 Expression* Divide::clone() const {
     return new Divide(*this);
 }
 
+Expression* Divide::move_clone() {
+    return new Divide(std::move(*this));
+}
+
 Complex Divide::compute_operation(const Complex& left_operand_value, const Complex& right_operand_value) const {
     return left_operand_value / right_operand_value;
 }
 
-std::string Divide::operation_sign() const {
-    return "/";
+Operation Divide::operation() const {
+    return Operation::Divide;
+}
+
+ComplexPower::ComplexPower(const Expression& left_operand, const Expression& right_operand)
+    : BinaryOperation(left_operand, right_operand) {}
+
+ComplexPower::ComplexPower(std::shared_ptr<Expression> left_operand, std::shared_ptr<Expression> right_operand)
+    : BinaryOperation(std::move(left_operand), std::move(right_operand)) {}
+
+Expression* ComplexPower::clone() const {
+    return new ComplexPower(*this);
+}
+
+Expression* ComplexPower::move_clone() {
+    return new ComplexPower(std::move(*this));
+}
+
+Complex ComplexPower::compute_operation(const Complex& left_operand_value, const Complex& right_operand_value) const {
+    return pow(left_operand_value, right_operand_value);
+}
+
+Operation ComplexPower::operation() const {
+    return Operation::ComplexPower;
 }
 
 Conjugate::Conjugate(const Expression& operand) : UnaryOperation(operand) {}
 
+Conjugate::Conjugate(std::shared_ptr<Expression> operand) : UnaryOperation(std::move(operand)) {}
+
 Expression* Conjugate::clone() const {
     return new Conjugate(*this);
 }
 
+Expression* Conjugate::move_clone() {
+    return new Conjugate(std::move(*this));
+}
+
 Complex Conjugate::compute_operation(const Complex& operand_value) const {
     return ~Complex(operand_value);
 }
 
-std::string Conjugate::operation_sign() const {
-    return "~";
+Operation Conjugate::operation() const {
+    return Operation::Conjugate;
 }
 
 Negate::Negate(const Expression& operand) : UnaryOperation(operand) {}
 
+Negate::Negate(std::shared_ptr<Expression> operand) : UnaryOperation(std::move(operand)) {}
+
 Expression* Negate::clone() const {
     return new Negate(*this);
 }
 
+Expression* Negate::move_clone() {
+    return new Negate(std::move(*this));
+}
+
 Complex Negate::compute_operation(const Complex& operand_value) const {
     return -Complex(operand_value);
 }
 
-std::string Negate::operation_sign() const {
-    return "-";
+Operation Negate::operation() const {
+    return Operation::Negate;
+}
+
+Exp::Exp(const Expression& operand) : ElementaryFunction(operand) {}
+
+Exp::Exp(std::shared_ptr<Expression> operand) : ElementaryFunction(std::move(operand)) {}
+
+Expression* Exp::clone() const {
+    return new Exp(*this);
+}
+
+Expression* Exp::move_clone() {
+    return new Exp(std::move(*this));
+}
+
+Complex Exp::compute_operation(const Complex& operand_value) const {
+    return exp(operand_value);
+}
+
+Operation Exp::operation() const {
+    return Operation::Exp;
+}
+
+Log::Log(const Expression& operand) : ElementaryFunction(operand) {}
+
+Log::Log(std::shared_ptr<Expression> operand) : ElementaryFunction(std::move(operand)) {}
+
+Expression* Log::clone() const {
+    return new Log(*this);
+}
+
+Expression* Log::move_clone() {
+    return new Log(std::move(*this));
+}
+
+Complex Log::compute_operation(const Complex& operand_value) const {
+    return log(operand_value);
+}
+
+Operation Log::operation() const {
+    return Operation::Log;
+}
+
+Sqrt::Sqrt(const Expression& operand) : ElementaryFunction(operand) {}
+
+Sqrt::Sqrt(std::shared_ptr<Expression> operand) : ElementaryFunction(std::move(operand)) {}
+
+Expression* Sqrt::clone() const {
+    return new Sqrt(*this);
+}
+
+Expression* Sqrt::move_clone() {
+    return new Sqrt(std::move(*this));
+}
+
+Complex Sqrt::compute_operation(const Complex& operand_value) const {
+    return sqrt(operand_value);
+}
+
+Operation Sqrt::operation() const {
+    return Operation::Sqrt;
+}
+
+Sin::Sin(const Expression& operand) : ElementaryFunction(operand) {}
+
+Sin::Sin(std::shared_ptr<Expression> operand) : ElementaryFunction(std::move(operand)) {}
+
+Expression* Sin::clone() const {
+    return new Sin(*this);
+}
+
+Expression* Sin::move_clone() {
+    return new Sin(std::move(*this));
+}
+
+Complex Sin::compute_operation(const Complex& operand_value) const {
+    return sin(operand_value);
+}
+
+Operation Sin::operation() const {
+    return Operation::Sin;
+}
+
+Cos::Cos(const Expression& operand) : ElementaryFunction(operand) {}
+
+Cos::Cos(std::shared_ptr<Expression> operand) : ElementaryFunction(std::move(operand)) {}
+
+Expression* Cos::clone() const {
+    return new Cos(*this);
+}
+
+Expression* Cos::move_clone() {
+    return new Cos(std::move(*this));
+}
+
+Complex Cos::compute_operation(const Complex& operand_value) const {
+    return cos(operand_value);
+}
+
+Operation Cos::operation() const {
+    return Operation::Cos;
+}
+
+Power::Power(const Expression& operand, std::int32_t exponent) : UnaryOperation(operand), exponent(exponent) {}
+
+Power::Power(std::shared_ptr<Expression> operand, std::int32_t exponent)
+    : UnaryOperation(std::move(operand)), exponent(exponent) {}
+
+Expression* Power::clone() const {
+    return new Power(*this);
+}
+
+Expression* Power::move_clone() {
+    return new Power(std::move(*this));
+}
+
+void Power::write_to(std::string& out) const {
+    out += '(';
+    operand_expression().write_to(out);
+    out += " ^ ";
+    out += std::to_string(exponent);
+    out += ')';
+}
+
+void Power::write_to(std::ostream& out) const {
+    out << '(';
+    operand_expression().write_to(out);
+    // Streams may have showpos, hex or a locale set, the text has to match write_to(std::string&).
+    out << " ^ " << std::to_string(exponent) << ')';
+}
+
+std::uint32_t Power::accept(ExpressionVisitor& visitor) const {
+    return visitor.visit_power(operand_expression().accept(visitor), exponent);
+}
+
+Complex Power::compute_operation(const Complex& operand_value) const {
+    return pow(operand_value, exponent);
+}
+
+Operation Power::operation() const {
+    return Operation::Power;
+}
+
+std::shared_ptr<Expression> to_shared(const Expression& expr) {
+    return std::shared_ptr<Expression>(expr.clone());
+}
+
+std::shared_ptr<Expression> to_shared(Expression&& expr) {
+    return std::shared_ptr<Expression>(expr.move_clone());
+}
+
+std::shared_ptr<Expression> make_const(const Complex& value) {
+    return std::make_shared<Const>(value);
+}
+
+std::shared_ptr<Expression> make_variable(std::string name) {
+    return std::make_shared<Variable>(std::move(name));
+}
+
+std::shared_ptr<Expression> make_add(std::shared_ptr<Expression> left, std::shared_ptr<Expression> right) {
+    return std::make_shared<Add>(std::move(left), std::move(right));
+}
+
+std::shared_ptr<Expression> make_subtract(std::shared_ptr<Expression> left, std::shared_ptr<Expression> right) {
+    return std::make_shared<Subtract>(std::move(left), std::move(right));
+}
+
+std::shared_ptr<Expression> make_multiply(std::shared_ptr<Expression> left, std::shared_ptr<Expression> right) {
+    return std::make_shared<Multiply>(std::move(left), std::move(right));
+}
+
+std::shared_ptr<Expression> make_divide(std::shared_ptr<Expression> left, std::shared_ptr<Expression> right) {
+    return std::make_shared<Divide>(std::move(left), std::move(right));
+}
+
+std::shared_ptr<Expression> make_negate(std::shared_ptr<Expression> operand) {
+    return std::make_shared<Negate>(std::move(operand));
+}
+
+std::shared_ptr<Expression> make_conjugate(std::shared_ptr<Expression> operand) {
+    return std::make_shared<Conjugate>(std::move(operand));
+}
+
+std::shared_ptr<Expression> make_exp(std::shared_ptr<Expression> operand) {
+    return std::make_shared<Exp>(std::move(operand));
+}
+
+std::shared_ptr<Expression> make_log(std::shared_ptr<Expression> operand) {
+    return std::make_shared<Log>(std::move(operand));
+}
+
+std::shared_ptr<Expression> make_sqrt(std::shared_ptr<Expression> operand) {
+    return std::make_shared<Sqrt>(std::move(operand));
+}
+
+std::shared_ptr<Expression> make_sin(std::shared_ptr<Expression> operand) {
+    return std::make_shared<Sin>(std::move(operand));
+}
+
+std::shared_ptr<Expression> make_cos(std::shared_ptr<Expression> operand) {
+    return std::make_shared<Cos>(std::move(operand));
 }
 
-Add operator+(const Expression& left, const Expression& right) {
-    return Add(left, right);
+std::shared_ptr<Expression> make_power(std::shared_ptr<Expression> operand, std::int32_t exponent) {
+    return std::make_shared<Power>(std::move(operand), exponent);
 }
 
-Subtract operator-(const Expression& left, const Expression& right) {
-    return Subtract(left, right);
+std::shared_ptr<Expression> make_complex_power(std::shared_ptr<Expression> base, std::shared_ptr<Expression> exponent) {
+    return std::make_shared<ComplexPower>(std::move(base), std::move(exponent));
 }
 
-Multiply operator*(const Expression& left, const Expression& right) {
-    return Multiply(left, right);
+std::shared_ptr<Expression> make_sum(std::span<const std::shared_ptr<Expression>> terms) {
+    std::shared_ptr<Expression> sum = terms.front();
+    for (std::size_t i = 1; i < terms.size(); ++i) {
+        sum = make_add(std::move(sum), terms[i]);
+    }
+    return sum;
 }
 
-Divide operator/(const Expression& left, const Expression& right) {
-    return Divide(left, right);
+std::shared_ptr<Expression> make_product(std::span<const std::shared_ptr<Expression>> factors) {
+    std::shared_ptr<Expression> product = factors.front();
+    for (std::size_t i = 1; i < factors.size(); ++i) {
+        product = make_multiply(std::move(product), factors[i]);
+    }
+    return product;
 }
 
 std::ostream& operator<<(std::ostream& out, const Expression& expr) {
-    out << expr.str();
+    expr.write_to(out);
     return out;
 }
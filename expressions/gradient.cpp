@@ -0,0 +1,242 @@
+#include "expressions/gradient.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <stdexcept>
+
+#include "complex/complex_math.hpp"
+
+class GradientTape::Builder: public ExpressionVisitor {
+public:
+    Builder(GradientTape& tape, const VariableSlots& slots) : tape(tape), slots(slots) {}
+
+    std::uint32_t visit_const(const Complex& value) {
+        tape.constants.push_back(value);
+        return add({Leaf::Const, {}, static_cast<std::uint32_t>(tape.constants.size() - 1), 0});
+    }
+
+    std::uint32_t visit_variable(const std::string& name) {
+        return add({Leaf::Variable, {}, static_cast<std::uint32_t>(slots.at(name)), 0});
+    }
+
+    std::uint32_t visit_unary(Operation operation, std::uint32_t operand) {
+        return add({Leaf::None, operation, operand, 0});
+    }
+
+    std::uint32_t visit_binary(Operation operation, std::uint32_t left, std::uint32_t right) {
+        return add({Leaf::None, operation, left, right});
+    }
+
+    std::uint32_t visit_power(std::uint32_t base, std::int32_t exponent) {
+        return add({Leaf::None, Operation::Power, base, std::bit_cast<std::uint32_t>(exponent)});
+    }
+
+private:
+    std::uint32_t add(const Node& node) {
+        tape.nodes.push_back(node);
+        return static_cast<std::uint32_t>(tape.nodes.size() - 1);
+    }
+
+    GradientTape& tape;
+    const VariableSlots& slots;
+};
+
+GradientTape::GradientTape(const Expression& expr, const VariableSlots& slots) {
+    Builder builder(*this, slots);
+    expr.accept(builder);
+    for (const auto& [name, slot] : slots) {
+        this->slots = std::max(this->slots, slot + 1);
+    }
+}
+
+Complex GradientTape::gradient(std::span<const Complex> values, std::span<Complex> d_dz,
+                               std::span<Complex> d_dconj) const {
+    if (values.size() < slots || d_dz.size() < slots || d_dconj.size() < slots) {
+        throw std::invalid_argument("gradient spans are shorter than slot_count()");
+    }
+    Sweep sweep;
+    return run(sweep, [&](std::uint32_t slot) { return values[slot]; }, d_dz, d_dconj);
+}
+
+void GradientTape::gradient_batch(std::span<const ComplexColumn> columns, std::size_t rows, MutableComplexColumn out,
+                                  std::span<const MutableComplexColumn> d_dz,
+                                  std::span<const MutableComplexColumn> d_dconj) const {
+    if (columns.size() < slots || d_dz.size() < slots || d_dconj.size() < slots) {
+        throw std::invalid_argument("gradient columns are fewer than slot_count()");
+    }
+    // The scratch space is reused by every row.
+    Sweep sweep;
+    std::vector<Complex> row_d_dz(slots);
+    std::vector<Complex> row_d_dconj(slots);
+    for (std::size_t row = 0; row < rows; ++row) {
+        const Complex value = run(
+            sweep, [&](std::uint32_t slot) { return Complex(columns[slot].real[row], columns[slot].imag[row]); },
+            row_d_dz, row_d_dconj);
+        if (out.real != nullptr) {
+            out.real[row] = value.real();
+            out.imag[row] = value.imag();
+        }
+        for (std::size_t slot = 0; slot < slots; ++slot) {
+            if (d_dz[slot].real != nullptr) {
+                d_dz[slot].real[row] = row_d_dz[slot].real();
+                d_dz[slot].imag[row] = row_d_dz[slot].imag();
+            }
+            if (d_dconj[slot].real != nullptr) {
+                d_dconj[slot].real[row] = row_d_dconj[slot].real();
+                d_dconj[slot].imag[row] = row_d_dconj[slot].imag();
+            }
+        }
+    }
+}
+
+std::size_t GradientTape::slot_count() const {
+    return slots;
+}
+
+std::size_t GradientTape::node_count() const {
+    return nodes.size();
+}
+
+template <typename Load>
+Complex GradientTape::run(Sweep& sweep, const Load& load, std::span<Complex> d_dz, std::span<Complex> d_dconj) const {
+    std::vector<Complex>& values = sweep.values;
+    values.resize(nodes.size());
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        const Node& node = nodes[i];
+        if (node.leaf == Leaf::Const) {
+            values[i] = constants[node.left];
+            continue;
+        }
+        if (node.leaf == Leaf::Variable) {
+            values[i] = load(node.left);
+            continue;
+        }
+        switch (node.operation) {
+        case Operation::Add:
+            values[i] = values[node.left] + values[node.right];
+            break;
+        case Operation::Subtract:
+            values[i] = values[node.left] - values[node.right];
+            break;
+        case Operation::Multiply:
+            values[i] = values[node.left] * values[node.right];
+            break;
+        case Operation::Divide:
+            values[i] = values[node.left] / values[node.right];
+            break;
+        case Operation::Negate:
+            values[i] = -values[node.left];
+            break;
+        case Operation::Conjugate:
+            values[i] = ~values[node.left];
+            break;
+        case Operation::Exp:
+            values[i] = exp(values[node.left]);
+            break;
+        case Operation::Log:
+            values[i] = log(values[node.left]);
+            break;
+        case Operation::Sqrt:
+            values[i] = sqrt(values[node.left]);
+            break;
+        case Operation::Sin:
+            values[i] = sin(values[node.left]);
+            break;
+        case Operation::Cos:
+            values[i] = cos(values[node.left]);
+            break;
+        case Operation::Power:
+            values[i] = pow(values[node.left], std::bit_cast<std::int32_t>(node.right));
+            break;
+        case Operation::ComplexPower:
+            values[i] = pow(values[node.left], values[node.right]);
+            break;
+        }
+    }
+
+    // Adjoints of the root: df/df = 1 and df/dconj(f) = 0.
+    std::vector<Complex>& d_du      = sweep.d_du;
+    std::vector<Complex>& d_dconj_u = sweep.d_dconj_u;
+    d_du.assign(nodes.size(), Complex());
+    d_dconj_u.assign(nodes.size(), Complex());
+    d_du.back() = Complex(1);
+    std::fill(d_dz.begin(), d_dz.begin() + slots, Complex());
+    std::fill(d_dconj.begin(), d_dconj.begin() + slots, Complex());
+
+    // A holomorphic node w with dw/du = derivative passes df/dw * dw/du to df/du and
+    // df/dconj(w) * conj(dw/du) to df/dconj(u).
+    const auto propagate = [&](std::size_t from, std::uint32_t to, const Complex& derivative) {
+        d_du[to] += d_du[from] * derivative;
+        d_dconj_u[to] += d_dconj_u[from] * ~derivative;
+    };
+    for (std::size_t i = nodes.size(); i-- > 0;) {
+        const Node& node = nodes[i];
+        if (node.leaf == Leaf::Variable) {
+            d_dz[node.left] += d_du[i];
+            d_dconj[node.left] += d_dconj_u[i];
+        }
+        if (node.leaf != Leaf::None) {
+            continue;
+        }
+        switch (node.operation) {
+        case Operation::Add:
+            propagate(i, node.left, Complex(1));
+            propagate(i, node.right, Complex(1));
+            break;
+        case Operation::Subtract:
+            propagate(i, node.left, Complex(1));
+            propagate(i, node.right, Complex(-1));
+            break;
+        case Operation::Multiply:
+            propagate(i, node.left, values[node.right]);
+            propagate(i, node.right, values[node.left]);
+            break;
+        case Operation::Divide:
+            propagate(i, node.left, Complex(1) / values[node.right]);
+            propagate(i, node.right, -(values[i] / values[node.right]));
+            break;
+        case Operation::Negate:
+            propagate(i, node.left, Complex(-1));
+            break;
+        case Operation::Conjugate:
+            // w = conj(u): dw/du = 0 and dw/dconj(u) = 1, so the adjoints swap.
+            d_du[node.left] += d_dconj_u[i];
+            d_dconj_u[node.left] += d_du[i];
+            break;
+        case Operation::Exp:
+            propagate(i, node.left, values[i]);
+            break;
+        case Operation::Log:
+            propagate(i, node.left, Complex(1) / values[node.left]);
+            break;
+        case Operation::Sqrt:
+            propagate(i, node.left, Complex(1) / (2 * values[i]));
+            break;
+        case Operation::Sin:
+            propagate(i, node.left, cos(values[node.left]));
+            break;
+        case Operation::Cos:
+            propagate(i, node.left, -sin(values[node.left]));
+            break;
+        case Operation::Power: {
+            // n * u^(n - 1), where n - 1 of the smallest exponent divides by u instead.
+            const auto exponent = std::bit_cast<std::int32_t>(node.right);
+            if (exponent == 0) {
+                break;
+            }
+            const Complex lowered = exponent == std::numeric_limits<std::int32_t>::min()
+                                        ? values[i] / values[node.left]
+                                        : pow(values[node.left], exponent - 1);
+            propagate(i, node.left, Complex(exponent) * lowered);
+            break;
+        }
+        case Operation::ComplexPower:
+            // w = u^v: dw/du = v * w / u and dw/dv = w * log(u).
+            propagate(i, node.left, values[node.right] * values[i] / values[node.left]);
+            propagate(i, node.right, values[i] * log(values[node.left]));
+            break;
+        }
+    }
+    return values.back();
+}
@@ -0,0 +1,149 @@
+#ifndef EXPRESSIONS_COMPILED_EXPRESSION_HPP
+#define EXPRESSIONS_COMPILED_EXPRESSION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "complex/complex.hpp"
+#include "complex/complex_math.hpp"
+#include "complex/thread_pool.hpp"
+#include "expressions/expressions.hpp"
+
+// Column of complex values stored as separate arrays of real and imaginary parts.
+template <typename T>
+struct BasicComplexColumn {
+    const T* real;
+    const T* imag;
+};
+
+template <typename T>
+struct BasicMutableComplexColumn {
+    T* real;
+    T* imag;
+};
+
+using ComplexColumn        = BasicComplexColumn<double>;
+using MutableComplexColumn = BasicMutableComplexColumn<double>;
+
+struct CompileOptions {
+    // Computes structurally identical subexpressions once per evaluation.
+    bool eliminate_common_subexpressions = true;
+    // Tier of the elementary functions in eval_batch and eval_parallel, the evaluation of
+    // single values always uses the accurate one.
+    MathAccuracy batch_accuracy = MathAccuracy::Accurate;
+};
+
+// Expression lowered into a flat array of register instructions. The tape is
+// immutable after construction, so one object can be evaluated from many threads.
+// Every evaluation mode is available in float, double and long double precision,
+// constants are rounded to the precision of the evaluation.
+class CompiledExpression {
+public:
+    CompiledExpression(const Expression& expr, const VariableSlots& slots, const CompileOptions& options = {});
+
+    static constexpr std::size_t DEFAULT_CHUNK_ROWS = 1 << 14;
+
+    // Evaluates the tape, values are indexed by the slots the tape was compiled with and
+    // must cover slot_count() of them, otherwise std::out_of_range is thrown.
+    BasicComplex<float> eval(std::span<const BasicComplex<float>> values) const;
+    Complex eval(std::span<const Complex> values) const;
+    BasicComplex<long double> eval(std::span<const BasicComplex<long double>> values) const;
+
+    // Same as above, but uses caller provided scratch space of at least register_count() values,
+    // throws std::out_of_range for less.
+    BasicComplex<float> eval(std::span<const BasicComplex<float>> values,
+                             std::span<BasicComplex<float>> scratch) const;
+    Complex eval(std::span<const Complex> values, std::span<Complex> scratch) const;
+    BasicComplex<long double> eval(std::span<const BasicComplex<long double>> values,
+                                   std::span<BasicComplex<long double>> scratch) const;
+
+    // Evaluates rows [0, rows) of the columns, indexed by slot, into out. The tape is
+    // walked once per block of rows and every instruction runs as a loop over the block.
+    // Throws std::out_of_range if there are fewer than slot_count() columns.
+    void eval_batch(std::span<const BasicComplexColumn<float>> columns, std::size_t rows,
+                    BasicMutableComplexColumn<float> out) const;
+    void eval_batch(std::span<const ComplexColumn> columns, std::size_t rows, MutableComplexColumn out) const;
+    void eval_batch(std::span<const BasicComplexColumn<long double>> columns, std::size_t rows,
+                    BasicMutableComplexColumn<long double> out) const;
+
+    // Same as eval_batch, but splits the rows into chunks of chunk_rows that are scheduled
+    // on the pool. Every chunk writes only its own rows, so the output does not depend on
+    // the schedule.
+    void eval_parallel(ThreadPool& pool, std::span<const BasicComplexColumn<float>> columns, std::size_t rows,
+                       BasicMutableComplexColumn<float> out, std::size_t chunk_rows = DEFAULT_CHUNK_ROWS) const;
+    void eval_parallel(ThreadPool& pool, std::span<const ComplexColumn> columns, std::size_t rows,
+                       MutableComplexColumn out, std::size_t chunk_rows = DEFAULT_CHUNK_ROWS) const;
+    void eval_parallel(ThreadPool& pool, std::span<const BasicComplexColumn<long double>> columns, std::size_t rows,
+                       BasicMutableComplexColumn<long double> out, std::size_t chunk_rows = DEFAULT_CHUNK_ROWS) const;
+
+    std::size_t register_count() const;
+
+    // One past the highest slot the expression reads.
+    std::size_t slot_count() const;
+
+    std::size_t instruction_count() const;
+
+private:
+    class Compiler;
+
+    enum class OpCode : std::uint8_t {
+        Const,
+        Load,
+        Add,
+        Subtract,
+        Multiply,
+        Divide,
+        Negate,
+        Conjugate,
+        Exp,
+        Log,
+        Sqrt,
+        Sin,
+        Cos,
+        Power,
+        ComplexPower
+    };
+
+    struct Instruction {
+        OpCode code;
+        std::uint32_t destination;
+        // Register operands, or the constant index for Const and the variable slot for Load.
+        // The right operand of Power is the bit pattern of its exponent.
+        std::uint32_t left;
+        std::uint32_t right;
+    };
+
+    static constexpr std::size_t INLINE_REGISTERS = 64;
+    static constexpr std::size_t BATCH_BLOCK      = 256;
+
+    template <typename T>
+    BasicComplex<T> eval_tape(std::span<const BasicComplex<T>> values, std::span<BasicComplex<T>> scratch) const;
+
+    template <typename T>
+    BasicComplex<T> eval_inline(std::span<const BasicComplex<T>> values) const;
+
+    void check_columns(std::size_t count) const;
+
+    template <typename T>
+    void eval_rows(std::span<const BasicComplexColumn<T>> columns, std::size_t first, std::size_t count,
+                   BasicMutableComplexColumn<T> out) const;
+
+    template <typename T>
+    void eval_chunks(ThreadPool& pool, std::span<const BasicComplexColumn<T>> columns, std::size_t rows,
+                     BasicMutableComplexColumn<T> out, std::size_t chunk_rows) const;
+
+    template <typename T>
+    void eval_block(std::span<const BasicComplexColumn<T>> columns, std::size_t first, std::size_t count,
+                    std::span<T> scratch, BasicMutableComplexColumn<T> out) const;
+
+    std::vector<Instruction> instructions;
+    std::vector<Complex> constants;
+    std::size_t registers       = 0;
+    std::size_t slots           = 0;
+    std::uint32_t result        = 0;
+    MathAccuracy batch_accuracy = MathAccuracy::Accurate;
+};
+
+#endif  // EXPRESSIONS_COMPILED_EXPRESSION_HPP
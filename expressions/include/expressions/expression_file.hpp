@@ -0,0 +1,161 @@
+#ifndef EXPRESSIONS_EXPRESSION_FILE_HPP
+#define EXPRESSIONS_EXPRESSION_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "complex/complex.hpp"
+#include "expressions/expressions.hpp"
+
+// Binary expression format, all integers and doubles little-endian:
+//   header      magic "CXEXPR\0\0", then u32 version, node count, constant count,
+//               name count, name bytes and FNV-1a checksum of everything after the header
+//   nodes       u32 kind, left, right per node in post-order, the root is the last node;
+//               left is the constant index of Const and the name index of Variable nodes
+//   constants   f64 real and imaginary part, starting at an 8-byte aligned offset
+//   names       u32 end offsets of every name followed by the name bytes
+std::string serialize_expression(const Expression& expr);
+
+// Writes serialize_expression(expr) to path, throws std::system_error on I/O errors.
+void save_expression(const Expression& expr, const std::string& path);
+
+// Archive of many expressions in one file, so that a catalogue needs a single mapping:
+//   header      magic "CXEXPRA\0", then u32 version and expression count
+//   offsets     u64 offset and size of every expression
+//   expressions the serialize_expression bytes of each, starting at 8-byte aligned offsets
+std::string serialize_archive(std::span<const std::shared_ptr<Expression>> expressions);
+
+// Writes serialize_archive(expressions) to path, throws std::system_error on I/O errors.
+void save_archive(std::span<const std::shared_ptr<Expression>> expressions, const std::string& path);
+
+// Read-only view of one serialized expression in memory owned by someone else. Opening
+// checks only the header and the section sizes, so it does not touch the rest of the
+// bytes. Evaluation computes every node once in file order, checks each and throws
+// std::runtime_error on corrupt ones instead of reading out of bounds, verify also checks
+// the names and the checksum.
+class ExpressionView {
+public:
+    static constexpr std::uint32_t VERSION = 1;
+
+    // Throws std::runtime_error if the bytes do not start with a valid header or the
+    // sections do not fill them exactly.
+    ExpressionView(const unsigned char* data, std::size_t size);
+
+    Complex eval(const std::unordered_map<std::string, Complex>& values) const;
+
+    // Values are indexed like variable_name, the span must cover every variable.
+    Complex eval(std::span<const Complex> values) const;
+
+    std::size_t node_count() const;
+
+    std::size_t variable_count() const;
+
+    std::string_view variable_name(std::size_t index) const;
+
+    // Reads every byte: throws std::runtime_error on a checksum mismatch or on nodes and
+    // names that evaluation would reject.
+    void verify() const;
+
+private:
+    template <typename Lookup>
+    Complex eval_nodes(const Lookup& lookup) const;
+
+    const unsigned char* data;
+    std::size_t size;
+    const unsigned char* nodes;
+    const unsigned char* constants;
+    const unsigned char* offsets;
+    const char* name_bytes;
+    std::uint32_t total_nodes;
+    std::uint32_t total_constants;
+    std::uint32_t total_names;
+    std::uint32_t name_end;
+};
+
+// A whole file mapped read-only into memory.
+class MappedFile {
+public:
+    // Throws std::system_error if the file cannot be mapped.
+    explicit MappedFile(const std::string& path);
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& file) noexcept;
+    MappedFile& operator=(MappedFile&& file) noexcept;
+
+    ~MappedFile();
+
+    const unsigned char* data() const;
+
+    std::size_t size() const;
+
+private:
+    void unmap() noexcept;
+
+    const unsigned char* bytes = nullptr;
+    std::size_t length         = 0;
+};
+
+// Expression file mapped into memory. Nothing is copied on load, evaluation walks the
+// nodes in the mapping.
+class MappedExpression {
+public:
+    static constexpr std::uint32_t VERSION = ExpressionView::VERSION;
+
+    // Throws std::system_error if the file cannot be mapped and std::runtime_error if its
+    // header is not a valid expression header.
+    explicit MappedExpression(const std::string& path);
+
+    Complex eval(const std::unordered_map<std::string, Complex>& values) const;
+
+    // Values are indexed like variable_name, the span must cover every variable.
+    Complex eval(std::span<const Complex> values) const;
+
+    std::size_t node_count() const;
+
+    std::size_t variable_count() const;
+
+    std::string_view variable_name(std::size_t index) const;
+
+    // See ExpressionView::verify.
+    void verify() const;
+
+    const ExpressionView& view() const;
+
+private:
+    MappedFile file;
+    ExpressionView expression;
+};
+
+// Archive file mapped into memory. Opening reads only the header, every expression is
+// checked like an ExpressionView when it is looked up.
+class MappedArchive {
+public:
+    static constexpr std::uint32_t VERSION = 1;
+
+    // Throws std::system_error if the file cannot be mapped and std::runtime_error if it
+    // is not an archive.
+    explicit MappedArchive(const std::string& path);
+
+    std::size_t size() const;
+
+    // Throws std::out_of_range for indices past size() and std::runtime_error if the
+    // offset table entry or the header of the expression is corrupt. The view is valid
+    // as long as the archive.
+    ExpressionView operator[](std::size_t index) const;
+
+    // Verifies every expression, see ExpressionView::verify.
+    void verify() const;
+
+private:
+    MappedFile file;
+    std::uint32_t count = 0;
+};
+
+#endif  // EXPRESSIONS_EXPRESSION_FILE_HPP
@@ -0,0 +1,83 @@
+#ifndef EXPRESSIONS_EXPRESSION_STORE_HPP
+#define EXPRESSIONS_EXPRESSION_STORE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "complex/complex.hpp"
+#include "expressions/expressions.hpp"
+
+using ExpressionId = std::uint32_t;
+
+// Keeps many expressions as compact nodes in a few contiguous arrays: 12 bytes per node
+// with 32-bit child indices, constants in a separate array and every variable name
+// stored once. Memory is released for all expressions at once by clear or destruction.
+class ExpressionStore {
+public:
+    ExpressionStore() = default;
+
+    // Copies rebuild the name lookup, which refers to the strings of its own store.
+    ExpressionStore(const ExpressionStore& store);
+    ExpressionStore(ExpressionStore&& store) noexcept = default;
+
+    ExpressionStore& operator=(const ExpressionStore& store);
+    ExpressionStore& operator=(ExpressionStore&& store) noexcept = default;
+
+    // Copies the expression into the store and returns the id of its root.
+    ExpressionId add(const Expression& expr);
+
+    // Reads text in the format of parse_expression straight into the store, without
+    // allocating Expression nodes. Throws ParseError and leaves the store unchanged on
+    // malformed text.
+    ExpressionId parse(std::string_view text);
+
+    Complex eval(ExpressionId root, const std::unordered_map<std::string, Complex>& values) const;
+
+    // Values are indexed by variable_id, throws std::out_of_range if the expression reads
+    // a variable past the end of values.
+    Complex eval(ExpressionId root, std::span<const Complex> values) const;
+
+    // Same text as Expression::str of the added expression.
+    std::string str(ExpressionId root) const;
+
+    // Id of an interned variable name, throws std::out_of_range for unknown names.
+    std::uint32_t variable_id(std::string_view name) const;
+
+    const std::deque<std::string>& variable_names() const;
+
+    std::size_t node_count() const;
+
+    void clear();
+
+private:
+    class Builder;
+
+    struct Node {
+        Leaf leaf;
+        // Operation of the nodes that are not leaves.
+        Operation operation;
+        // Constant index for Const, variable id for Variable, operand node ids otherwise. The
+        // right operand of Power is the bit pattern of its exponent.
+        std::uint32_t left;
+        std::uint32_t right;
+    };
+
+    template <typename Lookup>
+    Complex eval_node(ExpressionId id, const Lookup& lookup) const;
+
+    void write(ExpressionId id, std::string& out) const;
+
+    std::vector<Node> nodes;
+    std::vector<Complex> constants;
+    std::deque<std::string> names;
+    // Views into names, whose strings keep their addresses when the deque grows or moves.
+    std::unordered_map<std::string_view, std::uint32_t> name_ids;
+};
+
+#endif  // EXPRESSIONS_EXPRESSION_STORE_HPP
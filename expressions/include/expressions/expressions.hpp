@@ -1,19 +1,99 @@
+#ifndef EXPRESSIONS_EXPRESSIONS_HPP
+#define EXPRESSIONS_EXPRESSIONS_HPP
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <span>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
 
 #include "complex/complex.hpp"
 
+// Maps every variable name to its index in the values span passed to eval.
+using VariableSlots = std::unordered_map<std::string, std::size_t>;
+
+enum class Operation : std::uint8_t {
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    Negate,
+    Conjugate,
+    Exp,
+    Log,
+    Sqrt,
+    Sin,
+    Cos,
+    Power,
+    ComplexPower
+};
+
+// Tag of the leaves in flattened copies of an expression, all other nodes store their
+// Operation, so new operations need no extra node kinds.
+enum class Leaf : std::uint8_t {
+    None,
+    Const,
+    Variable
+};
+
+// Text of the operation in Expression::str: the operator of binary operations, the
+// prefix of Negate and Conjugate and the name of the elementary functions.
+std::string_view operation_sign(Operation operation);
+
+// Name of the operation, the same as the name of its expression class.
+std::string_view operation_name(Operation operation);
+
+// Number of expression operands, 1 for Power whose exponent is not an expression.
+std::size_t operation_arity(Operation operation);
+
+// Receives the nodes of an expression in post-order. Every call returns the id the
+// visitor assigned to the node, operands are passed as ids returned earlier. Integer
+// powers arrive through visit_power with their exponent, complex powers are binary.
+class ExpressionVisitor {
+public:
+    virtual std::uint32_t visit_const(const Complex& value)                                          = 0;
+    virtual std::uint32_t visit_variable(const std::string& name)                                    = 0;
+    virtual std::uint32_t visit_unary(Operation operation, std::uint32_t operand)                    = 0;
+    virtual std::uint32_t visit_binary(Operation operation, std::uint32_t left, std::uint32_t right) = 0;
+    virtual std::uint32_t visit_power(std::uint32_t base, std::int32_t exponent)                     = 0;
+
+    virtual ~ExpressionVisitor() = default;
+};
+
 class Expression {
 public:
     Expression()                             = default;
     Expression(const Expression& expr)       = default;
     Expression& operator=(Expression&& expr) = default;
 
-    virtual Complex eval(const std::unordered_map<std::string, Complex> values) const = 0;
-    virtual Expression* clone() const                                                 = 0;
-    virtual std::string str() const                                                   = 0;
+    virtual Complex eval(const std::unordered_map<std::string, Complex>& values) const = 0;
+    virtual Complex eval(std::span<const Complex> values) const                        = 0;
+    virtual Expression* clone() const                                                  = 0;
+
+    // Text form of the expression such as "((x + (1; 0)) * (-y))", written by write_to.
+    std::string str() const;
+
+    // Appends the text of str in one pass, without building it for every subexpression.
+    virtual void write_to(std::string& out) const  = 0;
+    virtual void write_to(std::ostream& out) const = 0;
+
+    // Same as clone, but moves the operands out of this expression instead of sharing them.
+    virtual Expression* move_clone() = 0;
+
+    // Returns a copy of the expression with every variable resolved to its slot,
+    // ownership over the pointer belongs to the caller. Only a bound expression
+    // can be evaluated over a span of slot values, a span without one of its slots
+    // throws std::out_of_range.
+    virtual Expression* bind(const VariableSlots& slots) const = 0;
+
+    // Walks the expression in post-order and returns the id of the root.
+    virtual std::uint32_t accept(ExpressionVisitor& visitor) const = 0;
 
     virtual ~Expression() = default;
 };
@@ -21,14 +101,22 @@ public:
 class BinaryOperation: public Expression {
 public:
     BinaryOperation(const Expression& left_operand, const Expression& right_operand);
+    // Shares the operands, expressions are immutable after construction.
+    BinaryOperation(std::shared_ptr<Expression> left_operand, std::shared_ptr<Expression> right_operand);
 
-    Complex eval(const std::unordered_map<std::string, Complex> values) const;
+    Complex eval(const std::unordered_map<std::string, Complex>& values) const;
+    Complex eval(std::span<const Complex> values) const;
 
-    std::string str() const;
+    void write_to(std::string& out) const;
+    void write_to(std::ostream& out) const;
+
+    Expression* bind(const VariableSlots& slots) const;
+
+    std::uint32_t accept(ExpressionVisitor& visitor) const;
 
 protected:
     virtual Complex compute_operation(const Complex& left_operand_value, const Complex& right_operand_value) const = 0;
-    virtual std::string operation_sign() const                                                                     = 0;
+    virtual Operation operation() const                                                                            = 0;
 
 private:
     std::shared_ptr<Expression> left_operand;
@@ -38,100 +126,247 @@ private:
 class UnaryOperation: public Expression {
 public:
     UnaryOperation(const Expression& operand);
+    UnaryOperation(std::shared_ptr<Expression> operand);
 
-    Complex eval(const std::unordered_map<std::string, Complex> values) const;
+    Complex eval(const std::unordered_map<std::string, Complex>& values) const;
+    Complex eval(std::span<const Complex> values) const;
 
-    std::string str() const;
+    void write_to(std::string& out) const;
+    void write_to(std::ostream& out) const;
+
+    Expression* bind(const VariableSlots& slots) const;
+
+    std::uint32_t accept(ExpressionVisitor& visitor) const;
 
 protected:
     virtual Complex compute_operation(const Complex& operand_value) const = 0;
-    virtual std::string operation_sign() const                            = 0;
+    virtual Operation operation() const                                   = 0;
+
+    const Expression& operand_expression() const;
 
 private:
     std::shared_ptr<Expression> operand;
 };
 
+// Unary operation written in function call form such as "exp(x)", the operation_sign of
+// its operation is the function name. Evaluates on the principal branch with the accurate functions of
+// complex/complex_math.hpp.
+class ElementaryFunction: public UnaryOperation {
+public:
+    using UnaryOperation::UnaryOperation;
+
+    void write_to(std::string& out) const;
+    void write_to(std::ostream& out) const;
+};
+
 class Add: public BinaryOperation {
 public:
     Add(const Expression& left_operand, const Expression& right_operand);
+    Add(std::shared_ptr<Expression> left_operand, std::shared_ptr<Expression> right_operand);
 
     Expression* clone() const;
+    Expression* move_clone();
 
 private:
     Complex compute_operation(const Complex& left_operand_value, const Complex& right_operand_value) const;
 
-    std::string operation_sign() const;
+    Operation operation() const;
 };
 
 class Subtract: public BinaryOperation {
 public:
     Subtract(const Expression& left_operand, const Expression& right_operand);
+    Subtract(std::shared_ptr<Expression> left_operand, std::shared_ptr<Expression> right_operand);
 
     Expression* clone() const;
+    Expression* move_clone();
 
 private:
     Complex compute_operation(const Complex& left_operand_value, const Complex& right_operand_value) const;
 
-    std::string operation_sign() const;
+    Operation operation() const;
 };
 
 class Multiply: public BinaryOperation {
 public:
     Multiply(const Expression& left_operand, const Expression& right_operand);
+    Multiply(std::shared_ptr<Expression> left_operand, std::shared_ptr<Expression> right_operand);
 
     Expression* clone() const;
+    Expression* move_clone();
 
 private:
     Complex compute_operation(const Complex& left_operand_value, const Complex& right_operand_value) const;
 
-    std::string operation_sign() const;
+    Operation operation() const;
 };
 
 class Divide: public BinaryOperation {
 public:
     Divide(const Expression& left_operand, const Expression& right_operand);
+    Divide(std::shared_ptr<Expression> left_operand, std::shared_ptr<Expression> right_operand);
 
     Expression* clone() const;
+    Expression* move_clone();
 
 private:
     Complex compute_operation(const Complex& left_operand_value, const Complex& right_operand_value) const;
 
-    std::string operation_sign() const;
+    Operation operation() const;
+};
+
+// Complex power "(x ^ y)" on the principal branch, see pow in complex/complex_math.hpp.
+class ComplexPower: public BinaryOperation {
+public:
+    ComplexPower(const Expression& left_operand, const Expression& right_operand);
+    ComplexPower(std::shared_ptr<Expression> left_operand, std::shared_ptr<Expression> right_operand);
+
+    Expression* clone() const;
+    Expression* move_clone();
+
+private:
+    Complex compute_operation(const Complex& left_operand_value, const Complex& right_operand_value) const;
+
+    Operation operation() const;
 };
 
 class Conjugate: public UnaryOperation {
 public:
     Conjugate(const Expression& operand);
+    Conjugate(std::shared_ptr<Expression> operand);
 
     Expression* clone() const;
+    Expression* move_clone();
 
 private:
     Complex compute_operation(const Complex& operand_value) const;
 
-    std::string operation_sign() const;
+    Operation operation() const;
 };
 
 class Negate: public UnaryOperation {
 public:
     Negate(const Expression& operand);
+    Negate(std::shared_ptr<Expression> operand);
+
+    Expression* clone() const;
+    Expression* move_clone();
+
+private:
+    Complex compute_operation(const Complex& operand_value) const;
+
+    Operation operation() const;
+};
+
+class Exp: public ElementaryFunction {
+public:
+    Exp(const Expression& operand);
+    Exp(std::shared_ptr<Expression> operand);
 
     Expression* clone() const;
+    Expression* move_clone();
 
 private:
     Complex compute_operation(const Complex& operand_value) const;
 
-    std::string operation_sign() const;
+    Operation operation() const;
+};
+
+class Log: public ElementaryFunction {
+public:
+    Log(const Expression& operand);
+    Log(std::shared_ptr<Expression> operand);
+
+    Expression* clone() const;
+    Expression* move_clone();
+
+private:
+    Complex compute_operation(const Complex& operand_value) const;
+
+    Operation operation() const;
+};
+
+class Sqrt: public ElementaryFunction {
+public:
+    Sqrt(const Expression& operand);
+    Sqrt(std::shared_ptr<Expression> operand);
+
+    Expression* clone() const;
+    Expression* move_clone();
+
+private:
+    Complex compute_operation(const Complex& operand_value) const;
+
+    Operation operation() const;
+};
+
+class Sin: public ElementaryFunction {
+public:
+    Sin(const Expression& operand);
+    Sin(std::shared_ptr<Expression> operand);
+
+    Expression* clone() const;
+    Expression* move_clone();
+
+private:
+    Complex compute_operation(const Complex& operand_value) const;
+
+    Operation operation() const;
+};
+
+class Cos: public ElementaryFunction {
+public:
+    Cos(const Expression& operand);
+    Cos(std::shared_ptr<Expression> operand);
+
+    Expression* clone() const;
+    Expression* move_clone();
+
+private:
+    Complex compute_operation(const Complex& operand_value) const;
+
+    Operation operation() const;
+};
+
+// Integer power written as "(x ^ 3)", computed by squaring in O(log |n|) multiplications.
+// Negative exponents raise the inverse of the operand.
+class Power: public UnaryOperation {
+public:
+    Power(const Expression& operand, std::int32_t exponent);
+    Power(std::shared_ptr<Expression> operand, std::int32_t exponent);
+
+    Expression* clone() const;
+    Expression* move_clone();
+
+    void write_to(std::string& out) const;
+    void write_to(std::ostream& out) const;
+
+    std::uint32_t accept(ExpressionVisitor& visitor) const;
+
+private:
+    Complex compute_operation(const Complex& operand_value) const;
+
+    Operation operation() const;
+
+    std::int32_t exponent;
 };
 
 class Const: public Expression {
 public:
     Const(const Complex& const_value);
 
-    Complex eval(const std::unordered_map<std::string, Complex> values) const;
+    Complex eval(const std::unordered_map<std::string, Complex>& values) const;
+    Complex eval(std::span<const Complex> values) const;
 
     Expression* clone() const;
+    Expression* move_clone();
 
-    std::string str() const;
+    void write_to(std::string& out) const;
+    void write_to(std::ostream& out) const;
+
+    Expression* bind(const VariableSlots& slots) const;
+
+    std::uint32_t accept(ExpressionVisitor& visitor) const;
 
 private:
     Complex const_value;
@@ -141,19 +376,78 @@ class Variable: public Expression {
 public:
     Variable(std::string&& variable_name);
 
-    Complex eval(const std::unordered_map<std::string, Complex> values) const;
+    Complex eval(const std::unordered_map<std::string, Complex>& values) const;
+    Complex eval(std::span<const Complex> values) const;
 
     Expression* clone() const;
+    Expression* move_clone();
 
-    std::string str() const;
+    void write_to(std::string& out) const;
+    void write_to(std::ostream& out) const;
+
+    Expression* bind(const VariableSlots& slots) const;
+
+    std::uint32_t accept(ExpressionVisitor& visitor) const;
 
 private:
+    static constexpr std::size_t UNBOUND = std::numeric_limits<std::size_t>::max();
+
     std::string variable_name;
+    std::size_t variable_slot = UNBOUND;
 };
 
-Add operator+(const Expression& left, const Expression& right);
-Subtract operator-(const Expression& left, const Expression& right);
-Multiply operator*(const Expression& left, const Expression& right);
-Divide operator/(const Expression& left, const Expression& right);
-
-std::ostream& operator<<(std::ostream& out, const Expression& expr);
\ No newline at end of file
+// Takes over a temporary expression or shares the operands of an existing one,
+// neither copies more than the top node.
+std::shared_ptr<Expression> to_shared(const Expression& expr);
+std::shared_ptr<Expression> to_shared(Expression&& expr);
+
+// Builder functions, operands are shared instead of copied, so building an expression
+// of n nodes costs n allocations.
+std::shared_ptr<Expression> make_const(const Complex& value);
+std::shared_ptr<Expression> make_variable(std::string name);
+std::shared_ptr<Expression> make_add(std::shared_ptr<Expression> left, std::shared_ptr<Expression> right);
+std::shared_ptr<Expression> make_subtract(std::shared_ptr<Expression> left, std::shared_ptr<Expression> right);
+std::shared_ptr<Expression> make_multiply(std::shared_ptr<Expression> left, std::shared_ptr<Expression> right);
+std::shared_ptr<Expression> make_divide(std::shared_ptr<Expression> left, std::shared_ptr<Expression> right);
+std::shared_ptr<Expression> make_negate(std::shared_ptr<Expression> operand);
+std::shared_ptr<Expression> make_conjugate(std::shared_ptr<Expression> operand);
+std::shared_ptr<Expression> make_exp(std::shared_ptr<Expression> operand);
+std::shared_ptr<Expression> make_log(std::shared_ptr<Expression> operand);
+std::shared_ptr<Expression> make_sqrt(std::shared_ptr<Expression> operand);
+std::shared_ptr<Expression> make_sin(std::shared_ptr<Expression> operand);
+std::shared_ptr<Expression> make_cos(std::shared_ptr<Expression> operand);
+std::shared_ptr<Expression> make_power(std::shared_ptr<Expression> operand, std::int32_t exponent);
+std::shared_ptr<Expression> make_complex_power(std::shared_ptr<Expression> base, std::shared_ptr<Expression> exponent);
+
+// Left-associated chains (((t0 + t1) + t2) + ...), terms must not be empty.
+std::shared_ptr<Expression> make_sum(std::span<const std::shared_ptr<Expression>> terms);
+std::shared_ptr<Expression> make_product(std::span<const std::shared_ptr<Expression>> factors);
+
+template <typename T>
+concept ExpressionOperand = std::derived_from<std::remove_cvref_t<T>, Expression>;
+
+// Temporaries are moved into the result, named expressions are shared.
+template <ExpressionOperand Left, ExpressionOperand Right>
+Add operator+(Left&& left, Right&& right) {
+    return Add(to_shared(std::forward<Left>(left)), to_shared(std::forward<Right>(right)));
+}
+
+template <ExpressionOperand Left, ExpressionOperand Right>
+Subtract operator-(Left&& left, Right&& right) {
+    return Subtract(to_shared(std::forward<Left>(left)), to_shared(std::forward<Right>(right)));
+}
+
+template <ExpressionOperand Left, ExpressionOperand Right>
+Multiply operator*(Left&& left, Right&& right) {
+    return Multiply(to_shared(std::forward<Left>(left)), to_shared(std::forward<Right>(right)));
+}
+
+template <ExpressionOperand Left, ExpressionOperand Right>
+Divide operator/(Left&& left, Right&& right) {
+    return Divide(to_shared(std::forward<Left>(left)), to_shared(std::forward<Right>(right)));
+}
+
+// Streams the expression through write_to.
+std::ostream& operator<<(std::ostream& out, const Expression& expr);
+
+#endif  // EXPRESSIONS_EXPRESSIONS_HPP
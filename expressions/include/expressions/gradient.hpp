@@ -0,0 +1,73 @@
+#ifndef EXPRESSIONS_GRADIENT_HPP
+#define EXPRESSIONS_GRADIENT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "complex/complex.hpp"
+#include "expressions/compiled_expression.hpp"
+#include "expressions/expressions.hpp"
+
+// Reverse-mode differentiation of an expression. Conjugate is not holomorphic, so the
+// tape computes both Wirtinger derivatives of f with respect to every variable z:
+// df/dz holds conj(z) constant and df/dconj(z) holds z constant. For an expression
+// without Conjugate df/dconj(z) is zero and df/dz is the complex derivative. A change
+// dz of one variable changes f by df/dz * dz + df/dconj(z) * conj(dz). The elementary
+// functions are holomorphic away from the branch cuts of log and sqrt, on a cut the
+// derivative of the principal branch is used. The same holds for complex powers, which
+// have the cut of log in their base and no derivative at a zero base.
+//
+// One gradient costs a forward sweep over the nodes and a backward sweep propagating
+// the pair of adjoints (df/du, df/dconj(u)) of every node u to its operands.
+class GradientTape {
+public:
+    GradientTape(const Expression& expr, const VariableSlots& slots);
+
+    // Returns f(values) and writes the derivatives with respect to every slot into the
+    // first slot_count() elements of d_dz and d_dconj. Values are indexed by slot. Throws
+    // std::invalid_argument if any of the spans is shorter than slot_count().
+    Complex gradient(std::span<const Complex> values, std::span<Complex> d_dz, std::span<Complex> d_dconj) const;
+
+    // Same for rows [0, rows) of the columns. d_dz and d_dconj hold one output column
+    // per slot, any of the output columns may be null to skip it. Throws
+    // std::invalid_argument for fewer than slot_count() input or output columns.
+    void gradient_batch(std::span<const ComplexColumn> columns, std::size_t rows, MutableComplexColumn out,
+                        std::span<const MutableComplexColumn> d_dz,
+                        std::span<const MutableComplexColumn> d_dconj) const;
+
+    // One more than the largest slot the tape was built with.
+    std::size_t slot_count() const;
+
+    std::size_t node_count() const;
+
+private:
+    class Builder;
+
+    struct Node {
+        Leaf leaf;
+        // Operation of the nodes that are not leaves.
+        Operation operation;
+        // Operand nodes, or the constant index for Const and the variable slot for Variable.
+        // The right operand of Power is the bit pattern of its exponent.
+        std::uint32_t left;
+        std::uint32_t right;
+    };
+
+    // Scratch space of one gradient: node values and both adjoints of every node.
+    struct Sweep {
+        std::vector<Complex> values;
+        std::vector<Complex> d_du;
+        std::vector<Complex> d_dconj_u;
+    };
+
+    template <typename Load>
+    Complex run(Sweep& sweep, const Load& load, std::span<Complex> d_dz, std::span<Complex> d_dconj) const;
+
+    std::vector<Node> nodes;
+    std::vector<Complex> constants;
+    std::size_t slots = 0;
+};
+
+#endif  // EXPRESSIONS_GRADIENT_HPP
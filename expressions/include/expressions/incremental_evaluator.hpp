@@ -0,0 +1,59 @@
+#ifndef EXPRESSIONS_INCREMENTAL_EVALUATOR_HPP
+#define EXPRESSIONS_INCREMENTAL_EVALUATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "complex/complex.hpp"
+#include "expressions/expressions.hpp"
+
+// Keeps the value of every node of an expression and recomputes only what depends on
+// changed variables. Each node knows its parent, so an update marks the path from the
+// variable to the root and value recomputes the marked nodes, children before parents.
+class IncrementalEvaluator {
+public:
+    // Evaluates the expression once, values has to contain every variable of it.
+    IncrementalEvaluator(const Expression& expr, const std::unordered_map<std::string, Complex>& values);
+
+    // Changes a variable, throws std::out_of_range for names the expression does not use.
+    // Several updates between two calls of value are combined.
+    void update(const std::string& name, const Complex& value);
+
+    // Same as Expression::eval with the current variable values.
+    Complex value();
+
+    std::size_t node_count() const;
+
+    // Number of nodes the last call of value had to recompute.
+    std::size_t recomputed_nodes() const;
+
+private:
+    class Builder;
+
+    static constexpr std::uint32_t NO_PARENT = UINT32_MAX;
+
+    struct Node {
+        Leaf leaf;
+        // Operation of the nodes that are not leaves.
+        Operation operation;
+        std::uint32_t left;
+        // Bit pattern of the exponent for Power.
+        std::uint32_t right;
+        std::uint32_t parent;
+    };
+
+    void compute(std::uint32_t id);
+
+    std::vector<Node> nodes;
+    std::vector<Complex> values;
+    std::vector<bool> dirty;
+    std::vector<std::uint32_t> dirty_nodes;
+    // Leaf nodes of every variable.
+    std::unordered_map<std::string, std::vector<std::uint32_t>> variable_nodes;
+    std::size_t last_recomputed = 0;
+};
+
+#endif  // EXPRESSIONS_INCREMENTAL_EVALUATOR_HPP
@@ -0,0 +1,74 @@
+#ifndef EXPRESSIONS_NATIVE_EXPRESSION_HPP
+#define EXPRESSIONS_NATIVE_EXPRESSION_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+
+#include "complex/complex.hpp"
+#include "expressions/compiled_expression.hpp"
+#include "expressions/expressions.hpp"
+
+struct NativeOptions {
+    std::string compiler = "c++";
+    // No FMA contraction, so the generated code rounds exactly like Expression::eval.
+    std::string flags = "-std=c++20 -O2 -ffp-contract=off -fPIC -shared";
+    // Directory with complex/complex.hpp, which the generated code includes. Empty means
+    // the headers this library was built with.
+    std::filesystem::path include_directory;
+    // Created with mode 0700 if missing. Empty means expressions-native in $XDG_CACHE_HOME,
+    // in ~/.cache without it, and expressions-native-<uid> in the temporary directory
+    // without a home.
+    std::filesystem::path cache_directory;
+};
+
+// Expression compiled to machine code: the tree is emitted as a C++ function over
+// Complex, built as a shared library by the system compiler and loaded with dlopen.
+// Libraries are cached in cache_directory under a hash of the source, the compiler
+// command, its --version output and the included headers, so each distinct expression
+// is compiled once per user. Only libraries and directories that belong to the current
+// user and that no one else can write are loaded. When compiling or loading fails the
+// expression is evaluated by CompiledExpression instead.
+// Both paths give the same bits as Expression::eval.
+class NativeExpression {
+public:
+    NativeExpression(const Expression& expr, const VariableSlots& slots, const NativeOptions& options = {});
+
+    NativeExpression(const NativeExpression&)            = delete;
+    NativeExpression& operator=(const NativeExpression&) = delete;
+
+    ~NativeExpression();
+
+    // Values are indexed by slot, throws std::out_of_range for fewer than slot_count().
+    Complex eval(std::span<const Complex> values) const;
+
+    // Evaluates rows [0, rows) of the columns, indexed by slot, into out. Throws
+    // std::out_of_range for fewer than slot_count() columns.
+    void eval_batch(std::span<const ComplexColumn> columns, std::size_t rows, MutableComplexColumn out) const;
+
+    // One past the highest slot the expression reads.
+    std::size_t slot_count() const;
+
+    // False if the expression fell back to the interpreter.
+    bool is_native() const;
+
+    // C++ source of the functions loaded from the library.
+    static std::string generate_source(const Expression& expr, const VariableSlots& slots);
+
+private:
+    using ScalarFunction = void (*)(const Complex* values, Complex* result);
+    using BatchFunction  = void (*)(const double* const* real, const double* const* imag, std::size_t rows,
+                                   double* out_real, double* out_imag);
+
+    bool load(const std::filesystem::path& library);
+
+    void* handle           = nullptr;
+    ScalarFunction scalar  = nullptr;
+    BatchFunction batch    = nullptr;
+    std::size_t read_slots = 0;
+    std::optional<CompiledExpression> fallback;
+};
+
+#endif  // EXPRESSIONS_NATIVE_EXPRESSION_HPP
@@ -0,0 +1,43 @@
+#ifndef EXPRESSIONS_PARSER_HPP
+#define EXPRESSIONS_PARSER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "expressions/expressions.hpp"
+
+class ParseError: public std::runtime_error {
+public:
+    ParseError(const std::string& message, std::size_t position);
+
+    // Offset of the offending character in the parsed text.
+    std::size_t position() const;
+
+private:
+    std::size_t error_position;
+};
+
+// Deepest nesting of operands parse_expression accepts, deeper input throws ParseError
+// instead of exhausting the stack.
+inline constexpr std::size_t MAX_PARSE_DEPTH = 1000;
+
+// Reads the format written by Expression::str: constants "(re; im)", variable names,
+// "(-x)", "(~x)", "(x op y)" with op one of + - * / ^ and the calls "exp(x)", "log(x)",
+// "sqrt(x)", "sin(x)" and "cos(x)". An exponent that is an integer literal such as
+// "(x ^ -3)" makes a Power, any other exponent a ComplexPower. Spaces are optional except
+// after a variable name, which runs until a space, bracket or ';', and between a function
+// name and its bracket, where they are not allowed. Throws ParseError on malformed input,
+// constant parts that overflow or underflow a double, trailing characters and operands
+// nested deeper than MAX_PARSE_DEPTH.
+std::shared_ptr<Expression> parse_expression(std::string_view text);
+
+// Same, but passes the nodes to the visitor in the order Expression::accept would instead
+// of building an Expression, and returns the id of the root. On ParseError the visitor
+// has already received the nodes read up to the error.
+std::uint32_t parse_expression(std::string_view text, ExpressionVisitor& visitor);
+
+#endif  // EXPRESSIONS_PARSER_HPP
@@ -0,0 +1,16 @@
+#ifndef EXPRESSIONS_POLYNOMIAL_EXPANSION_HPP
+#define EXPRESSIONS_POLYNOMIAL_EXPANSION_HPP
+
+#include <string>
+
+#include "complex/polynomial.hpp"
+#include "expressions/expressions.hpp"
+
+// Expands an expression in the single variable into its coefficients. Sums, differences,
+// products and negations of polynomials expand, as do non-negative integer powers and
+// divisions by constants. Every other operation has to have constant operands and is
+// folded like eval does. Throws std::invalid_argument for any other variable and for
+// expressions that are not polynomials in the variable, such as x / x or exp(x).
+Polynomial expand_polynomial(const Expression& expr, const std::string& variable);
+
+#endif  // EXPRESSIONS_POLYNOMIAL_EXPANSION_HPP
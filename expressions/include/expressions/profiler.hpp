@@ -0,0 +1,83 @@
+#ifndef EXPRESSIONS_PROFILER_HPP
+#define EXPRESSIONS_PROFILER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "complex/complex.hpp"
+#include "expressions/expressions.hpp"
+
+struct ProfilerOptions {
+    // Divisions by a denominator with a smaller absolute value are counted as near zero.
+    double near_zero = 1e-12;
+};
+
+struct NodeProfile {
+    std::uint64_t calls = 0;
+    // Time spent in the node including its operands.
+    std::uint64_t nanoseconds         = 0;
+    std::uint64_t near_zero_divisions = 0;
+    // Results with an infinite or NaN part.
+    std::uint64_t non_finite_results = 0;
+};
+
+// Instrumented copy of an expression that records, per node, how often it was evaluated
+// and how long it took, measured with std::chrono::steady_clock. Profiling is opt-in by
+// evaluating through the profiler instead of the expression, so Expression::eval
+// itself carries no instrumentation.
+class ExpressionProfiler {
+public:
+    explicit ExpressionProfiler(const Expression& expr, const ProfilerOptions& options = {});
+
+    // Same result as Expression::eval, counters of every node are updated.
+    Complex eval(const std::unordered_map<std::string, Complex>& values);
+
+    // Counters of the nodes in post-order, the root is the last one.
+    const std::vector<NodeProfile>& profiles() const;
+
+    void reset();
+
+    // Text of Expression::str with the counters of every subexpression appended to it,
+    // e.g. "(x[calls=2 ns=40] + (1; 0)[calls=2 ns=30])[calls=2 ns=210]". Division and
+    // non-finite counters are only shown when they are not zero.
+    std::string annotated() const;
+
+    // One "root;child;...;node self_nanoseconds" line per node, the folded stack format
+    // read by flamegraph tools. Frames are operation names, variable names or "const".
+    std::string folded_stacks() const;
+
+private:
+    class Builder;
+
+    struct Node {
+        Leaf leaf;
+        // Operation of the nodes that are not leaves.
+        Operation operation;
+        // Constant or name index for leaves, operand nodes otherwise. The right operand of
+        // Power is the bit pattern of its exponent.
+        std::uint32_t left;
+        std::uint32_t right;
+    };
+
+    Complex eval_node(std::uint32_t id, const std::unordered_map<std::string, Complex>& values);
+
+    void write_annotated(std::uint32_t id, std::string& out) const;
+
+    void write_folded(std::uint32_t id, std::string& stack, std::string& out) const;
+
+    std::string frame(std::uint32_t id) const;
+
+    static std::size_t arity(const Node& node);
+
+    ProfilerOptions options;
+    std::vector<Node> nodes;
+    std::vector<Complex> constants;
+    std::vector<std::string> names;
+    std::vector<NodeProfile> counters;
+};
+
+#endif  // EXPRESSIONS_PROFILER_HPP
@@ -0,0 +1,29 @@
+#ifndef EXPRESSIONS_SIMPLIFY_HPP
+#define EXPRESSIONS_SIMPLIFY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "expressions/expressions.hpp"
+
+struct SimplifyOptions {
+    // Also removes x * (1; 0), x / (1; 0) and x + (0; 0), which are exact only for finite
+    // operands and up to the sign of zero. Without it only exact rewrites are applied.
+    bool assume_finite = false;
+    // Rewrites products of at least this many equal factors, x * x * x * x in any
+    // association, into the integer power (x ^ 4). Squaring rounds differently from the
+    // product from four factors on, so 0 disables the rewrite.
+    std::int32_t min_power_factors = 0;
+};
+
+struct SimplifyResult {
+    std::shared_ptr<Expression> expression;
+    std::size_t removed_nodes;
+};
+
+// Returns an equivalent expression with constant subtrees folded through the Complex
+// operators and identity operations removed: x - (0; 0), x + (-0; -0), -(-x), ~(~x), (x ^ 1).
+SimplifyResult simplify(const Expression& expr, const SimplifyOptions& options = {});
+
+#endif  // EXPRESSIONS_SIMPLIFY_HPP
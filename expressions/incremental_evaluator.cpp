@@ -0,0 +1,141 @@
+#include "expressions/incremental_evaluator.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include "complex/complex_math.hpp"
+
+class IncrementalEvaluator::Builder: public ExpressionVisitor {
+public:
+    Builder(IncrementalEvaluator& evaluator, const std::unordered_map<std::string, Complex>& variables)
+        : evaluator(evaluator), variables(variables) {}
+
+    std::uint32_t visit_const(const Complex& value) {
+        return add({Leaf::Const, {}, 0, 0, NO_PARENT}, value);
+    }
+
+    std::uint32_t visit_variable(const std::string& name) {
+        const std::uint32_t id = add({Leaf::Variable, {}, 0, 0, NO_PARENT}, variables.at(name));
+        evaluator.variable_nodes[name].push_back(id);
+        return id;
+    }
+
+    std::uint32_t visit_unary(Operation operation, std::uint32_t operand) {
+        return add_operation({Leaf::None, operation, operand, 0, NO_PARENT}, 1);
+    }
+
+    std::uint32_t visit_binary(Operation operation, std::uint32_t left, std::uint32_t right) {
+        return add_operation({Leaf::None, operation, left, right, NO_PARENT}, 2);
+    }
+
+    std::uint32_t visit_power(std::uint32_t base, std::int32_t exponent) {
+        const std::uint32_t bits = std::bit_cast<std::uint32_t>(exponent);
+        return add_operation({Leaf::None, Operation::Power, base, bits, NO_PARENT}, 1);
+    }
+
+private:
+    std::uint32_t add(const Node& node, const Complex& value) {
+        evaluator.nodes.push_back(node);
+        evaluator.values.push_back(value);
+        return static_cast<std::uint32_t>(evaluator.nodes.size() - 1);
+    }
+
+    std::uint32_t add_operation(const Node& node, int arity) {
+        const std::uint32_t id = add(node, Complex());
+        evaluator.nodes[node.left].parent = id;
+        if (arity == 2) {
+            evaluator.nodes[node.right].parent = id;
+        }
+        evaluator.compute(id);
+        return id;
+    }
+
+    IncrementalEvaluator& evaluator;
+    const std::unordered_map<std::string, Complex>& variables;
+};
+
+IncrementalEvaluator::IncrementalEvaluator(const Expression& expr,
+                                           const std::unordered_map<std::string, Complex>& values) {
+    Builder builder(*this, values);
+    expr.accept(builder);
+    dirty.assign(nodes.size(), false);
+}
+
+void IncrementalEvaluator::update(const std::string& name, const Complex& value) {
+    for (const std::uint32_t leaf : variable_nodes.at(name)) {
+        values[leaf] = value;
+        // Stops at the first marked node, everything above it is marked already.
+        for (std::uint32_t id = nodes[leaf].parent; id != NO_PARENT && !dirty[id]; id = nodes[id].parent) {
+            dirty[id] = true;
+            dirty_nodes.push_back(id);
+        }
+    }
+}
+
+Complex IncrementalEvaluator::value() {
+    // Nodes are stored in post-order, so ascending ids recompute operands first.
+    std::sort(dirty_nodes.begin(), dirty_nodes.end());
+    for (const std::uint32_t id : dirty_nodes) {
+        compute(id);
+        dirty[id] = false;
+    }
+    last_recomputed = dirty_nodes.size();
+    dirty_nodes.clear();
+    return values.back();
+}
+
+std::size_t IncrementalEvaluator::node_count() const {
+    return nodes.size();
+}
+
+std::size_t IncrementalEvaluator::recomputed_nodes() const {
+    return last_recomputed;
+}
+
+void IncrementalEvaluator::compute(std::uint32_t id) {
+    const Node& node = nodes[id];
+    if (node.leaf != Leaf::None) {
+        return;
+    }
+    switch (node.operation) {
+    case Operation::Add:
+        values[id] = values[node.left] + values[node.right];
+        return;
+    case Operation::Subtract:
+        values[id] = values[node.left] - values[node.right];
+        return;
+    case Operation::Multiply:
+        values[id] = values[node.left] * values[node.right];
+        return;
+    case Operation::Divide:
+        values[id] = values[node.left] / values[node.right];
+        return;
+    case Operation::Negate:
+        values[id] = -values[node.left];
+        return;
+    case Operation::Conjugate:
+        values[id] = ~values[node.left];
+        return;
+    case Operation::Exp:
+        values[id] = exp(values[node.left]);
+        return;
+    case Operation::Log:
+        values[id] = log(values[node.left]);
+        return;
+    case Operation::Sqrt:
+        values[id] = sqrt(values[node.left]);
+        return;
+    case Operation::Sin:
+        values[id] = sin(values[node.left]);
+        return;
+    case Operation::Cos:
+        values[id] = cos(values[node.left]);
+        return;
+    case Operation::Power:
+        values[id] = pow(values[node.left], std::bit_cast<std::int32_t>(node.right));
+        return;
+    case Operation::ComplexPower:
+        values[id] = pow(values[node.left], values[node.right]);
+        return;
+    }
+}
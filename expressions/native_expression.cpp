@@ -0,0 +1,368 @@
+#include "expressions/native_expression.hpp"
+
+#include <dlfcn.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace {
+
+// Emits one const Complex per node in post-order, constants are written as bit patterns
+// so that they survive the round trip through the source exactly.
+class SourceWriter: public ExpressionVisitor {
+public:
+    explicit SourceWriter(const VariableSlots& slots) : slots(slots) {}
+
+    std::uint32_t visit_const(const Complex& value) {
+        return add("Complex(" + bits(value.real()) + ", " + bits(value.imag()) + ")");
+    }
+
+    std::uint32_t visit_variable(const std::string& name) {
+        const std::size_t slot = slots.at(name);
+        read_slots             = std::max(read_slots, slot + 1);
+        return add("load(" + std::to_string(slot) + ")");
+    }
+
+    std::uint32_t visit_unary(Operation operation, std::uint32_t operand) {
+        return add(std::string(prefix(operation)) + "(n" + std::to_string(operand) + ')');
+    }
+
+    std::uint32_t visit_binary(Operation operation, std::uint32_t left, std::uint32_t right) {
+        if (operation == Operation::ComplexPower) {
+            return add("pow(n" + std::to_string(left) + ", n" + std::to_string(right) + ')');
+        }
+        return add('n' + std::to_string(left) + ' ' + sign(operation) + " n" + std::to_string(right));
+    }
+
+    std::uint32_t visit_power(std::uint32_t base, std::int32_t exponent) {
+        return add("pow(n" + std::to_string(base) + ", INT32_C(" + std::to_string(exponent) + "))");
+    }
+
+    const std::string& body() const {
+        return text;
+    }
+
+    // One past the highest slot the generated code loads.
+    std::size_t slot_count() const {
+        return read_slots;
+    }
+
+private:
+    std::uint32_t add(const std::string& value) {
+        text += "    const Complex n" + std::to_string(nodes) + " = " + value + ";\n";
+        return nodes++;
+    }
+
+    static std::string bits(double value) {
+        char buffer[16];
+        char* end = std::to_chars(buffer, buffer + sizeof(buffer), std::bit_cast<std::uint64_t>(value), 16).ptr;
+        return "std::bit_cast<double>(UINT64_C(0x" + std::string(buffer, end) + "))";
+    }
+
+    // Operator or function applied to the operand, the functions of complex_math.hpp are
+    // found by argument-dependent lookup.
+    static std::string_view prefix(Operation operation) {
+        switch (operation) {
+        case Operation::Negate:
+            return "-";
+        case Operation::Conjugate:
+            return "~";
+        case Operation::Exp:
+            return "exp";
+        case Operation::Log:
+            return "log";
+        case Operation::Sqrt:
+            return "sqrt";
+        case Operation::Sin:
+            return "sin";
+        case Operation::Cos:
+            return "cos";
+        default:
+            throw std::invalid_argument("not a unary operation");
+        }
+    }
+
+    static char sign(Operation operation) {
+        switch (operation) {
+        case Operation::Add:
+            return '+';
+        case Operation::Subtract:
+            return '-';
+        case Operation::Multiply:
+            return '*';
+        case Operation::Divide:
+            return '/';
+        default:
+            throw std::invalid_argument("not a binary operation");
+        }
+    }
+
+    const VariableSlots& slots;
+    std::string text;
+    std::uint32_t nodes    = 0;
+    std::size_t read_slots = 0;
+};
+
+// Translation unit with the C entry points around the nodes the writer emits for expr.
+std::string write_source(const Expression& expr, SourceWriter& writer) {
+    const std::uint32_t root = expr.accept(writer);
+    return "#include <bit>\n"
+           "#include <cstddef>\n"
+           "#include <cstdint>\n"
+           "\n"
+           "#include \"complex/complex.hpp\"\n"
+           "#include \"complex/complex_math.hpp\"\n"
+           "\n"
+           "template <typename Load>\n"
+           "static inline Complex evaluate(const Load& load) {\n" +
+           writer.body() + "    return n" + std::to_string(root) +
+           ";\n"
+           "}\n"
+           "\n"
+           "extern \"C\" void expression_eval(const Complex* values, Complex* result) {\n"
+           "    *result = evaluate([values](std::size_t slot) { return values[slot]; });\n"
+           "}\n"
+           "\n"
+           "extern \"C\" void expression_eval_batch(const double* const* real, const double* const* imag, "
+           "std::size_t rows, double* out_real, double* out_imag) {\n"
+           "    for (std::size_t row = 0; row < rows; ++row) {\n"
+           "        const Complex value = evaluate([&](std::size_t slot) { return Complex(real[slot][row], "
+           "imag[slot][row]); });\n"
+           "        out_real[row] = value.real();\n"
+           "        out_imag[row] = value.imag();\n"
+           "    }\n"
+           "}\n";
+}
+
+std::uint64_t fnv1a(const std::string& text, std::uint64_t hash = 14695981039346656037ULL) {
+    for (const char symbol : text) {
+        hash = (hash ^ static_cast<unsigned char>(symbol)) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+std::uint64_t hash_file(const std::filesystem::path& path, std::uint64_t hash) {
+    std::ifstream in(path, std::ios::binary);
+    return fnv1a(std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()), hash);
+}
+
+// Hashes the names and contents of every header the generated source can reach, in a
+// fixed order, so edits to any of them select a new library.
+std::uint64_t hash_headers(const std::filesystem::path& include_directory, std::uint64_t hash) {
+    std::vector<std::filesystem::path> headers;
+    std::error_code error;
+    for (std::filesystem::recursive_directory_iterator entry(include_directory / "complex", error), end;
+         !error && entry != end; entry.increment(error)) {
+        if (entry->is_regular_file(error)) {
+            headers.push_back(entry->path());
+        }
+    }
+    std::sort(headers.begin(), headers.end());
+    for (const std::filesystem::path& header : headers) {
+        hash = hash_file(header, fnv1a(header.string(), hash));
+    }
+    return hash;
+}
+
+std::string quote(const std::string& argument) {
+    std::string quoted = "'";
+    for (const char symbol : argument) {
+        quoted += symbol == '\'' ? std::string("'\\''") : std::string(1, symbol);
+    }
+    return quoted + '\'';
+}
+
+// Output of compiler --version, which identifies the compiler behind a name like c++.
+// It is run once per compiler and process.
+std::string compiler_version(const std::string& compiler) {
+    static std::mutex mutex;
+    static std::map<std::string, std::string> versions;
+    const std::lock_guard lock(mutex);
+    const auto found = versions.find(compiler);
+    if (found != versions.end()) {
+        return found->second;
+    }
+    std::string version;
+    if (FILE* pipe = ::popen((quote(compiler) + " --version 2>&1").c_str(), "r")) {
+        char buffer[256];
+        for (std::size_t read; (read = std::fread(buffer, 1, sizeof(buffer), pipe)) > 0;) {
+            version.append(buffer, read);
+        }
+        ::pclose(pipe);
+    }
+    return versions.emplace(compiler, version).first->second;
+}
+
+std::filesystem::path default_cache_directory() {
+    if (const char* cache = std::getenv("XDG_CACHE_HOME"); cache != nullptr && *cache == '/') {
+        return std::filesystem::path(cache) / "expressions-native";
+    }
+    if (const char* home = std::getenv("HOME"); home != nullptr && *home == '/') {
+        return std::filesystem::path(home) / ".cache" / "expressions-native";
+    }
+    return std::filesystem::temp_directory_path() / ("expressions-native-" + std::to_string(::getuid()));
+}
+
+// True if path itself, not a link to it, has the given type, belongs to the current
+// user and cannot be written by the group or others. Anyone else who can replace the
+// library could run code in this process.
+bool is_private(const std::filesystem::path& path, mode_t type) {
+    struct stat status = {};
+    return ::lstat(path.c_str(), &status) == 0 && (status.st_mode & S_IFMT) == type && status.st_uid == ::geteuid() &&
+           (status.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+}
+
+// Creates the directory and missing parents, the directory itself only for its owner.
+bool create_private_directory(const std::filesystem::path& directory) {
+    std::error_code error;
+    std::filesystem::create_directories(directory.parent_path(), error);
+    if (::mkdir(directory.c_str(), 0700) != 0 && errno != EEXIST) {
+        return false;
+    }
+    return is_private(directory, S_IFDIR);
+}
+
+// Writes the source and compiles it next to the cache entry, then moves the library into
+// place, so concurrent builds of the same expression never see a half-written file.
+bool build(const std::string& source, const std::filesystem::path& library, const std::string& command) {
+    const std::string unique                 = library.stem().string() + '-' + std::to_string(std::random_device()());
+    const std::filesystem::path directory    = library.parent_path();
+    const std::filesystem::path source_path  = directory / (unique + ".cpp");
+    const std::filesystem::path partial_path = directory / (unique + ".so");
+    {
+        std::ofstream out(source_path);
+        out << source;
+        if (!out) {
+            return false;
+        }
+    }
+    const int status = std::system((command + ' ' + quote(source_path.string()) + " -o " +
+                                    quote(partial_path.string()) + " > /dev/null 2>&1")
+                                       .c_str());
+    std::error_code error;
+    std::filesystem::remove(source_path, error);
+    if (status != 0) {
+        std::filesystem::remove(partial_path, error);
+        return false;
+    }
+    // The compiler applies the umask, which may leave the library group-writable.
+    std::filesystem::permissions(partial_path, std::filesystem::perms::owner_all, error);
+    if (!error) {
+        std::filesystem::rename(partial_path, library, error);
+    }
+    if (error) {
+        std::filesystem::remove(partial_path, error);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+NativeExpression::NativeExpression(const Expression& expr, const VariableSlots& slots, const NativeOptions& options) {
+    SourceWriter writer(slots);
+    const std::string source = write_source(expr, writer);
+    read_slots               = writer.slot_count();
+    const std::filesystem::path include_directory =
+        options.include_directory.empty() ? std::filesystem::path(COMPLEX_INCLUDE_DIR) : options.include_directory;
+    const std::string command = options.compiler + ' ' + options.flags + " -I" + quote(include_directory.string());
+    const std::filesystem::path cache_directory =
+        options.cache_directory.empty() ? default_cache_directory() : options.cache_directory;
+
+    const std::uint64_t key =
+        hash_headers(include_directory, fnv1a(compiler_version(options.compiler), fnv1a(command, fnv1a(source))));
+    char hash[17] = {};
+    std::to_chars(hash, hash + 16, key, 16);
+    const std::filesystem::path library = cache_directory / ("expression-" + std::string(hash) + ".so");
+
+    std::error_code error;
+    if (create_private_directory(cache_directory) &&
+        (std::filesystem::exists(library, error) || build(source, library, command)) &&
+        is_private(library, S_IFREG) && load(library)) {
+        return;
+    }
+    fallback.emplace(expr, slots);
+}
+
+NativeExpression::~NativeExpression() {
+    if (handle != nullptr) {
+        ::dlclose(handle);
+    }
+}
+
+Complex NativeExpression::eval(std::span<const Complex> values) const {
+    // The generated code indexes values without checks.
+    if (values.size() < read_slots) {
+        throw std::out_of_range("not enough variable values");
+    }
+    if (fallback) {
+        return fallback->eval(values);
+    }
+    Complex result;
+    scalar(values.data(), &result);
+    return result;
+}
+
+void NativeExpression::eval_batch(std::span<const ComplexColumn> columns, std::size_t rows,
+                                  MutableComplexColumn out) const {
+    if (columns.size() < read_slots) {
+        throw std::out_of_range("not enough variable columns");
+    }
+    if (fallback) {
+        fallback->eval_batch(columns, rows, out);
+        return;
+    }
+    std::vector<const double*> real;
+    std::vector<const double*> imag;
+    real.reserve(columns.size());
+    imag.reserve(columns.size());
+    for (const ComplexColumn& column : columns) {
+        real.push_back(column.real);
+        imag.push_back(column.imag);
+    }
+    batch(real.data(), imag.data(), rows, out.real, out.imag);
+}
+
+std::size_t NativeExpression::slot_count() const {
+    return read_slots;
+}
+
+bool NativeExpression::is_native() const {
+    return !fallback;
+}
+
+std::string NativeExpression::generate_source(const Expression& expr, const VariableSlots& slots) {
+    SourceWriter writer(slots);
+    return write_source(expr, writer);
+}
+
+bool NativeExpression::load(const std::filesystem::path& library) {
+    handle = ::dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (handle == nullptr) {
+        return false;
+    }
+    scalar = reinterpret_cast<ScalarFunction>(::dlsym(handle, "expression_eval"));
+    batch  = reinterpret_cast<BatchFunction>(::dlsym(handle, "expression_eval_batch"));
+    if (scalar == nullptr || batch == nullptr) {
+        ::dlclose(handle);
+        handle = nullptr;
+        return false;
+    }
+    return true;
+}
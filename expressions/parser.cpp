@@ -0,0 +1,302 @@
+#include "expressions/parser.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <iterator>
+#include <system_error>
+#include <utility>
+
+namespace {
+
+constexpr Operation FUNCTIONS[] = {Operation::Exp, Operation::Log, Operation::Sqrt, Operation::Sin, Operation::Cos};
+
+// Builds the parsed nodes as a tree of Expression objects.
+class TreeBuilder {
+public:
+    using Node = std::shared_ptr<Expression>;
+
+    Node constant(const Complex& value) {
+        return make_const(value);
+    }
+
+    Node variable(std::string_view name) {
+        return make_variable(std::string(name));
+    }
+
+    Node unary(Operation operation, Node operand) {
+        switch (operation) {
+        case Operation::Negate:
+            return make_negate(std::move(operand));
+        case Operation::Conjugate:
+            return make_conjugate(std::move(operand));
+        case Operation::Exp:
+            return make_exp(std::move(operand));
+        case Operation::Log:
+            return make_log(std::move(operand));
+        case Operation::Sqrt:
+            return make_sqrt(std::move(operand));
+        case Operation::Sin:
+            return make_sin(std::move(operand));
+        default:
+            return make_cos(std::move(operand));
+        }
+    }
+
+    Node binary(Operation operation, Node left, Node right) {
+        switch (operation) {
+        case Operation::Add:
+            return make_add(std::move(left), std::move(right));
+        case Operation::Subtract:
+            return make_subtract(std::move(left), std::move(right));
+        case Operation::Multiply:
+            return make_multiply(std::move(left), std::move(right));
+        case Operation::Divide:
+            return make_divide(std::move(left), std::move(right));
+        default:
+            return make_complex_power(std::move(left), std::move(right));
+        }
+    }
+
+    Node power(Node base, std::int32_t exponent) {
+        return make_power(std::move(base), exponent);
+    }
+};
+
+// Passes the parsed nodes to a visitor in post-order, the same calls Expression::accept makes.
+class VisitorBuilder {
+public:
+    using Node = std::uint32_t;
+
+    explicit VisitorBuilder(ExpressionVisitor& visitor) : visitor(visitor) {}
+
+    Node constant(const Complex& value) {
+        return visitor.visit_const(value);
+    }
+
+    Node variable(std::string_view name) {
+        return visitor.visit_variable(std::string(name));
+    }
+
+    Node unary(Operation operation, Node operand) {
+        return visitor.visit_unary(operation, operand);
+    }
+
+    Node binary(Operation operation, Node left, Node right) {
+        return visitor.visit_binary(operation, left, right);
+    }
+
+    Node power(Node base, std::int32_t exponent) {
+        return visitor.visit_power(base, exponent);
+    }
+
+private:
+    ExpressionVisitor& visitor;
+};
+
+template <typename Builder>
+class Parser {
+public:
+    using Node = typename Builder::Node;
+
+    Parser(std::string_view text, Builder& builder) : text(text), builder(builder) {}
+
+    Node parse() {
+        Node expr = parse_operand();
+        skip_spaces();
+        if (position != text.size()) {
+            fail("unexpected trailing characters");
+        }
+        return expr;
+    }
+
+private:
+    // Every nested operand is one level of recursion, the limit keeps hostile input from
+    // overflowing the stack.
+    Node parse_operand() {
+        skip_spaces();
+        if (++depth > MAX_PARSE_DEPTH) {
+            fail("expression nested too deeply");
+        }
+        Node operand = parse_nested();
+        --depth;
+        return operand;
+    }
+
+    Node parse_nested() {
+        if (position == text.size()) {
+            fail("unexpected end of input");
+        }
+        if (text[position] != '(') {
+            const std::size_t start     = position;
+            const std::string_view name = parse_name();
+            if (position < text.size() && text[position] == '(') {
+                return parse_call(name, start);
+            }
+            return builder.variable(name);
+        }
+        ++position;
+        skip_spaces();
+
+        // "(-1; 0)" and "(-x)" share a prefix, a number followed by ';' decides.
+        double real             = 0;
+        const auto [end, error] = std::from_chars(text.data() + position, text.data() + text.size(), real);
+        if (error == std::errc() || error == std::errc::result_out_of_range) {
+            const std::size_t after = end - text.data();
+            std::size_t separator   = after;
+            while (separator < text.size() && text[separator] == ' ') {
+                ++separator;
+            }
+            if (separator < text.size() && text[separator] == ';') {
+                if (error == std::errc::result_out_of_range) {
+                    fail("number out of range");
+                }
+                position = separator + 1;
+                return builder.constant(Complex(real, parse_number()));
+            }
+        }
+
+        if (text[position] == '-' || text[position] == '~') {
+            const char sign = text[position++];
+            Node operand    = parse_operand();
+            expect(')');
+            return builder.unary(sign == '-' ? Operation::Negate : Operation::Conjugate, std::move(operand));
+        }
+
+        Node left = parse_operand();
+        skip_spaces();
+        if (position == text.size()) {
+            fail("expected an operator");
+        }
+        Operation operation = Operation::Add;
+        switch (text[position]) {
+        case '+':
+            break;
+        case '-':
+            operation = Operation::Subtract;
+            break;
+        case '*':
+            operation = Operation::Multiply;
+            break;
+        case '/':
+            operation = Operation::Divide;
+            break;
+        case '^':
+            ++position;
+            return parse_power(std::move(left));
+        default:
+            fail("expected an operator");
+        }
+        ++position;
+        Node right = parse_operand();
+        expect(')');
+        return builder.binary(operation, std::move(left), std::move(right));
+    }
+
+    // The exponent with the closing bracket of "(x ^ n)". A name that reads as an int32 up to
+    // its end is an integer exponent.
+    Node parse_power(Node base) {
+        skip_spaces();
+        std::int32_t exponent   = 0;
+        const auto [end, error] = std::from_chars(text.data() + position, text.data() + text.size(), exponent);
+        const std::size_t after = end - text.data();
+        if (error != std::errc::invalid_argument && (after == text.size() || is_delimiter(text[after]))) {
+            if (error == std::errc::result_out_of_range) {
+                fail("exponent out of range");
+            }
+            position = after;
+            expect(')');
+            return builder.power(std::move(base), exponent);
+        }
+        Node power = parse_operand();
+        expect(')');
+        return builder.binary(Operation::ComplexPower, std::move(base), std::move(power));
+    }
+
+    // "name(x)" with the name already read, start is its position for the error message.
+    Node parse_call(std::string_view name, std::size_t start) {
+        const auto matches        = [&](Operation operation) { return operation_sign(operation) == name; };
+        const Operation* function = std::find_if(std::begin(FUNCTIONS), std::end(FUNCTIONS), matches);
+        if (function == std::end(FUNCTIONS)) {
+            position = start;
+            fail("unknown function " + std::string(name));
+        }
+        ++position;
+        Node operand = parse_operand();
+        expect(')');
+        return builder.unary(*function, std::move(operand));
+    }
+
+    // The imaginary part with the closing bracket of a constant.
+    double parse_number() {
+        skip_spaces();
+        double value            = 0;
+        const auto [end, error] = std::from_chars(text.data() + position, text.data() + text.size(), value);
+        if (error == std::errc::invalid_argument) {
+            fail("expected a number");
+        }
+        if (error == std::errc::result_out_of_range) {
+            fail("number out of range");
+        }
+        position = end - text.data();
+        expect(')');
+        return value;
+    }
+
+    std::string_view parse_name() {
+        const std::size_t start = position;
+        while (position < text.size() && !is_delimiter(text[position])) {
+            ++position;
+        }
+        if (position == start) {
+            fail("expected a variable name");
+        }
+        return text.substr(start, position - start);
+    }
+
+    void expect(char symbol) {
+        skip_spaces();
+        if (position == text.size() || text[position] != symbol) {
+            fail(std::string("expected '") + symbol + '\'');
+        }
+        ++position;
+    }
+
+    void skip_spaces() {
+        while (position < text.size() && text[position] == ' ') {
+            ++position;
+        }
+    }
+
+    static bool is_delimiter(char symbol) {
+        return symbol == ' ' || symbol == '(' || symbol == ')' || symbol == ';';
+    }
+
+    [[noreturn]] void fail(const std::string& message) const {
+        throw ParseError(message, position);
+    }
+
+    std::string_view text;
+    Builder& builder;
+    std::size_t position = 0;
+    std::size_t depth    = 0;
+};
+
+}  // namespace
+
+ParseError::ParseError(const std::string& message, std::size_t position)
+    : std::runtime_error(message + " at position " + std::to_string(position)), error_position(position) {}
+
+std::size_t ParseError::position() const {
+    return error_position;
+}
+
+std::shared_ptr<Expression> parse_expression(std::string_view text) {
+    TreeBuilder builder;
+    return Parser(text, builder).parse();
+}
+
+std::uint32_t parse_expression(std::string_view text, ExpressionVisitor& visitor) {
+    VisitorBuilder builder(visitor);
+    return Parser(text, builder).parse();
+}
@@ -0,0 +1,122 @@
+#include "expressions/polynomial_expansion.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "complex/complex_math.hpp"
+
+namespace {
+
+class Expander: public ExpressionVisitor {
+public:
+    explicit Expander(const std::string& variable) : variable(variable) {}
+
+    std::uint32_t visit_const(const Complex& value) {
+        return add(Polynomial({value}));
+    }
+
+    std::uint32_t visit_variable(const std::string& name) {
+        if (name != variable) {
+            throw std::invalid_argument("expression has variable " + name + " besides " + variable);
+        }
+        return add(Polynomial({Complex(0), Complex(1)}));
+    }
+
+    std::uint32_t visit_unary(Operation operation, std::uint32_t operand) {
+        if (operation == Operation::Negate) {
+            return add(-polynomials[operand]);
+        }
+        const Complex value = constant(operand);
+        switch (operation) {
+        case Operation::Conjugate:
+            return add(Polynomial({~value}));
+        case Operation::Exp:
+            return add(Polynomial({exp(value)}));
+        case Operation::Log:
+            return add(Polynomial({log(value)}));
+        case Operation::Sqrt:
+            return add(Polynomial({sqrt(value)}));
+        case Operation::Sin:
+            return add(Polynomial({sin(value)}));
+        case Operation::Cos:
+            return add(Polynomial({cos(value)}));
+        default:
+            break;
+        }
+        throw std::invalid_argument("unknown operation");
+    }
+
+    std::uint32_t visit_binary(Operation operation, std::uint32_t left, std::uint32_t right) {
+        switch (operation) {
+        case Operation::Add:
+            return add(polynomials[left] + polynomials[right]);
+        case Operation::Subtract:
+            return add(polynomials[left] - polynomials[right]);
+        case Operation::Multiply:
+            return add(polynomials[left] * polynomials[right]);
+        case Operation::Divide: {
+            const Complex divisor = constant(right);
+            std::vector<Complex> quotient;
+            for (const Complex& coefficient : polynomials[left].coefficients()) {
+                quotient.push_back(coefficient / divisor);
+            }
+            return add(Polynomial(std::move(quotient)));
+        }
+        case Operation::ComplexPower:
+            return add(Polynomial({pow(constant(left), constant(right))}));
+        default:
+            break;
+        }
+        throw std::invalid_argument("unknown operation");
+    }
+
+    std::uint32_t visit_power(std::uint32_t base, std::int32_t exponent) {
+        if (polynomials[base].is_constant() || exponent < 0) {
+            return add(Polynomial({pow(constant(base), exponent)}));
+        }
+        // Binary powering from the lowest bit of the exponent up: the result starts as the
+        // constant 1 and takes the current square for every set bit, so x ^ 0 expands to 1.
+        Polynomial square = polynomials[base];
+        Polynomial result({Complex(1)});
+        for (std::uint32_t bits = static_cast<std::uint32_t>(exponent); bits != 0; bits >>= 1) {
+            if ((bits & 1) != 0) {
+                result *= square;
+            }
+            if (bits > 1) {
+                square *= square;
+            }
+        }
+        return add(std::move(result));
+    }
+
+    Polynomial take(std::uint32_t node) {
+        return std::move(polynomials[node]);
+    }
+
+private:
+    std::uint32_t add(Polynomial polynomial) {
+        polynomials.push_back(std::move(polynomial));
+        return static_cast<std::uint32_t>(polynomials.size() - 1);
+    }
+
+    // Value of a constant node, which the zero polynomial represents without coefficients.
+    Complex constant(std::uint32_t node) const {
+        const Polynomial& polynomial = polynomials[node];
+        if (!polynomial.is_constant()) {
+            throw std::invalid_argument("expression is not a polynomial in " + variable);
+        }
+        return polynomial.coefficients().empty() ? Complex(0) : polynomial.coefficients()[0];
+    }
+
+    const std::string& variable;
+    std::vector<Polynomial> polynomials;
+};
+
+}  // namespace
+
+Polynomial expand_polynomial(const Expression& expr, const std::string& variable) {
+    Expander expander(variable);
+    return expander.take(expr.accept(expander));
+}
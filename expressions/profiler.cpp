@@ -0,0 +1,223 @@
+#include "expressions/profiler.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+
+#include "complex/complex_math.hpp"
+
+class ExpressionProfiler::Builder: public ExpressionVisitor {
+public:
+    explicit Builder(ExpressionProfiler& profiler) : profiler(profiler) {}
+
+    std::uint32_t visit_const(const Complex& value) {
+        profiler.constants.push_back(value);
+        return add({Leaf::Const, {}, static_cast<std::uint32_t>(profiler.constants.size() - 1), 0});
+    }
+
+    std::uint32_t visit_variable(const std::string& name) {
+        profiler.names.push_back(name);
+        return add({Leaf::Variable, {}, static_cast<std::uint32_t>(profiler.names.size() - 1), 0});
+    }
+
+    std::uint32_t visit_unary(Operation operation, std::uint32_t operand) {
+        return add({Leaf::None, operation, operand, 0});
+    }
+
+    std::uint32_t visit_binary(Operation operation, std::uint32_t left, std::uint32_t right) {
+        return add({Leaf::None, operation, left, right});
+    }
+
+    std::uint32_t visit_power(std::uint32_t base, std::int32_t exponent) {
+        return add({Leaf::None, Operation::Power, base, std::bit_cast<std::uint32_t>(exponent)});
+    }
+
+private:
+    std::uint32_t add(const Node& node) {
+        profiler.nodes.push_back(node);
+        return static_cast<std::uint32_t>(profiler.nodes.size() - 1);
+    }
+
+    ExpressionProfiler& profiler;
+};
+
+ExpressionProfiler::ExpressionProfiler(const Expression& expr, const ProfilerOptions& options) : options(options) {
+    Builder builder(*this);
+    expr.accept(builder);
+    counters.resize(nodes.size());
+}
+
+Complex ExpressionProfiler::eval(const std::unordered_map<std::string, Complex>& values) {
+    return eval_node(static_cast<std::uint32_t>(nodes.size() - 1), values);
+}
+
+const std::vector<NodeProfile>& ExpressionProfiler::profiles() const {
+    return counters;
+}
+
+void ExpressionProfiler::reset() {
+    counters.assign(nodes.size(), NodeProfile());
+}
+
+std::string ExpressionProfiler::annotated() const {
+    std::string out;
+    write_annotated(static_cast<std::uint32_t>(nodes.size() - 1), out);
+    return out;
+}
+
+std::string ExpressionProfiler::folded_stacks() const {
+    std::string stack;
+    std::string out;
+    write_folded(static_cast<std::uint32_t>(nodes.size() - 1), stack, out);
+    return out;
+}
+
+Complex ExpressionProfiler::eval_node(std::uint32_t id, const std::unordered_map<std::string, Complex>& values) {
+    const auto start = std::chrono::steady_clock::now();
+    const Node& node = nodes[id];
+    Complex result;
+    if (node.leaf == Leaf::Const) {
+        result = constants[node.left];
+    } else if (node.leaf == Leaf::Variable) {
+        result = values.at(names[node.left]);
+    } else {
+        switch (node.operation) {
+        case Operation::Add:
+            result = eval_node(node.left, values) + eval_node(node.right, values);
+            break;
+        case Operation::Subtract:
+            result = eval_node(node.left, values) - eval_node(node.right, values);
+            break;
+        case Operation::Multiply:
+            result = eval_node(node.left, values) * eval_node(node.right, values);
+            break;
+        case Operation::Divide: {
+            const Complex numerator   = eval_node(node.left, values);
+            const Complex denominator = eval_node(node.right, values);
+            if (denominator.abs() < options.near_zero) {
+                ++counters[id].near_zero_divisions;
+            }
+            result = numerator / denominator;
+            break;
+        }
+        case Operation::Negate:
+            result = -eval_node(node.left, values);
+            break;
+        case Operation::Conjugate:
+            result = ~eval_node(node.left, values);
+            break;
+        case Operation::Exp:
+            result = exp(eval_node(node.left, values));
+            break;
+        case Operation::Log:
+            result = log(eval_node(node.left, values));
+            break;
+        case Operation::Sqrt:
+            result = sqrt(eval_node(node.left, values));
+            break;
+        case Operation::Sin:
+            result = sin(eval_node(node.left, values));
+            break;
+        case Operation::Cos:
+            result = cos(eval_node(node.left, values));
+            break;
+        case Operation::Power:
+            result = pow(eval_node(node.left, values), std::bit_cast<std::int32_t>(node.right));
+            break;
+        case Operation::ComplexPower:
+            result = pow(eval_node(node.left, values), eval_node(node.right, values));
+            break;
+        }
+    }
+    const auto elapsed   = std::chrono::steady_clock::now() - start;
+    NodeProfile& profile = counters[id];
+    if (!std::isfinite(result.real()) || !std::isfinite(result.imag())) {
+        ++profile.non_finite_results;
+    }
+    ++profile.calls;
+    profile.nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    return result;
+}
+
+void ExpressionProfiler::write_annotated(std::uint32_t id, std::string& out) const {
+    // Same text as Expression::write_to, with the spelling of every operation taken from
+    // operation_sign.
+    const Node& node = nodes[id];
+    if (node.leaf != Leaf::None) {
+        out += node.leaf == Leaf::Const ? constants[node.left].str() : names[node.left];
+    } else if (node.operation == Operation::Power) {
+        out += '(';
+        write_annotated(node.left, out);
+        out += ' ';
+        out += operation_sign(node.operation);
+        out += ' ' + std::to_string(std::bit_cast<std::int32_t>(node.right)) + ')';
+    } else if (arity(node) == 2) {
+        out += '(';
+        write_annotated(node.left, out);
+        out += ' ';
+        out += operation_sign(node.operation);
+        out += ' ';
+        write_annotated(node.right, out);
+        out += ')';
+    } else if (node.operation == Operation::Negate || node.operation == Operation::Conjugate) {
+        out += '(';
+        out += operation_sign(node.operation);
+        write_annotated(node.left, out);
+        out += ')';
+    } else {
+        out += operation_sign(node.operation);
+        out += '(';
+        write_annotated(node.left, out);
+        out += ')';
+    }
+
+    const NodeProfile& profile = counters[id];
+    out += "[calls=" + std::to_string(profile.calls) + " ns=" + std::to_string(profile.nanoseconds);
+    if (profile.near_zero_divisions != 0) {
+        out += " near_zero=" + std::to_string(profile.near_zero_divisions);
+    }
+    if (profile.non_finite_results != 0) {
+        out += " non_finite=" + std::to_string(profile.non_finite_results);
+    }
+    out += ']';
+}
+
+void ExpressionProfiler::write_folded(std::uint32_t id, std::string& stack, std::string& out) const {
+    const std::size_t length = stack.size();
+    if (length != 0) {
+        stack += ';';
+    }
+    stack += frame(id);
+
+    // Self time: the operands are reported in their own frames.
+    const Node& node          = nodes[id];
+    std::uint64_t nanoseconds = counters[id].nanoseconds;
+    for (std::size_t k = 0; k < arity(node); ++k) {
+        const std::uint64_t operand = counters[k == 0 ? node.left : node.right].nanoseconds;
+        nanoseconds -= std::min(nanoseconds, operand);
+    }
+    out += stack + ' ' + std::to_string(nanoseconds) + '\n';
+
+    for (std::size_t k = 0; k < arity(node); ++k) {
+        write_folded(k == 0 ? node.left : node.right, stack, out);
+    }
+    stack.resize(length);
+}
+
+std::string ExpressionProfiler::frame(std::uint32_t id) const {
+    const Node& node = nodes[id];
+    switch (node.leaf) {
+    case Leaf::Const:
+        return "const";
+    case Leaf::Variable:
+        return names[node.left];
+    case Leaf::None:
+        break;
+    }
+    return std::string(operation_name(node.operation));
+}
+
+std::size_t ExpressionProfiler::arity(const Node& node) {
+    return node.leaf == Leaf::None ? operation_arity(node.operation) : 0;
+}
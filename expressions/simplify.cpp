@@ -0,0 +1,246 @@
+#include "expressions/simplify.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+bool is_exact(const std::optional<Complex>& value, double real, double imag) {
+    return value && std::bit_cast<std::uint64_t>(value->real()) == std::bit_cast<std::uint64_t>(real) &&
+           std::bit_cast<std::uint64_t>(value->imag()) == std::bit_cast<std::uint64_t>(imag);
+}
+
+std::shared_ptr<Expression> make_unary(Operation operation, const std::shared_ptr<Expression>& operand) {
+    switch (operation) {
+    case Operation::Negate:
+        return make_negate(operand);
+    case Operation::Conjugate:
+        return make_conjugate(operand);
+    case Operation::Exp:
+        return make_exp(operand);
+    case Operation::Log:
+        return make_log(operand);
+    case Operation::Sqrt:
+        return make_sqrt(operand);
+    case Operation::Sin:
+        return make_sin(operand);
+    case Operation::Cos:
+        return make_cos(operand);
+    default:
+        throw std::invalid_argument("not a unary operation");
+    }
+}
+
+std::shared_ptr<Expression> make_binary(Operation operation, const std::shared_ptr<Expression>& left,
+                                        const std::shared_ptr<Expression>& right) {
+    switch (operation) {
+    case Operation::Add:
+        return make_add(left, right);
+    case Operation::Subtract:
+        return make_subtract(left, right);
+    case Operation::Multiply:
+        return make_multiply(left, right);
+    case Operation::Divide:
+        return make_divide(left, right);
+    case Operation::ComplexPower:
+        return make_complex_power(left, right);
+    default:
+        throw std::invalid_argument("not a binary operation");
+    }
+}
+
+// Rebuilds the expression bottom-up, every visited node is already simplified. To find
+// equal factors, nodes are hash-consed on a key of their kind and the structures of their
+// operands, so that every structure is identified by the first node that has it.
+class Simplifier: public ExpressionVisitor {
+public:
+    explicit Simplifier(const SimplifyOptions& options) : options(options) {}
+
+    std::uint32_t visit_const(const Complex& value) {
+        ++original_size;
+        return add({make_const(value), 1, value});
+    }
+
+    std::uint32_t visit_variable(const std::string& name) {
+        ++original_size;
+        return add({make_variable(name), 1, std::nullopt}, key('v') + name);
+    }
+
+    std::uint32_t visit_unary(Operation operation, std::uint32_t operand) {
+        ++original_size;
+        const Node& inner = nodes[operand];
+        // -(-x) and ~(~x) are exact for every x.
+        const bool involution = operation == Operation::Negate || operation == Operation::Conjugate;
+        if (involution && inner.operation == operation) {
+            return inner.operand;
+        }
+        Node node = {make_unary(operation, inner.expr), inner.size + 1, std::nullopt, operation, operand};
+        return add(fold(std::move(node), inner.value.has_value()),
+                   key('u', {static_cast<std::int64_t>(operation), inner.structure}));
+    }
+
+    std::uint32_t visit_binary(Operation operation, std::uint32_t left, std::uint32_t right) {
+        ++original_size;
+        const Node& lhs = nodes[left];
+        const Node& rhs = nodes[right];
+        if (const std::optional<std::uint32_t> kept = identity(operation, left, right)) {
+            return *kept;
+        }
+        Node node = {make_binary(operation, lhs.expr, rhs.expr), lhs.size + rhs.size + 1, std::nullopt};
+        const std::string node_key = key('b', {static_cast<std::int64_t>(operation), lhs.structure, rhs.structure});
+        const bool constant        = lhs.value && rhs.value;
+        if (operation == Operation::Multiply && !constant && lhs.factor == rhs.factor) {
+            return add_power(std::move(node), node_key, lhs.factor, lhs.factor_count + rhs.factor_count);
+        }
+        return add(fold(std::move(node), constant), node_key);
+    }
+
+    std::uint32_t visit_power(std::uint32_t base, std::int32_t exponent) {
+        ++original_size;
+        const Node& inner = nodes[base];
+        // pow(z, 1) is z itself.
+        if (exponent == 1) {
+            return base;
+        }
+        Node node = {make_power(inner.expr, exponent), inner.size + 1, std::nullopt};
+        if (inner.value) {
+            return add(fold(std::move(node), true));
+        }
+        const std::string node_key = key('p', {inner.structure, exponent});
+        if (exponent > 0) {
+            return add_power(std::move(node), node_key, inner.factor, inner.factor_count * exponent);
+        }
+        return add(std::move(node), node_key);
+    }
+
+    SimplifyResult result(std::uint32_t root) const {
+        return {nodes[root].expr, original_size - nodes[root].size};
+    }
+
+private:
+    struct Node {
+        std::shared_ptr<Expression> expr;
+        std::size_t size;
+        std::optional<Complex> value;
+        std::optional<Operation> operation = std::nullopt;
+        std::uint32_t operand              = 0;
+        // With options.min_power_factors, the first node of the same structure, and the
+        // node is the product of factor_count factors equal to the node factor.
+        std::uint32_t structure   = 0;
+        std::uint32_t factor      = 0;
+        std::int64_t factor_count = 1;
+    };
+
+    // Structure key of a node from a tag and the structures or values it depends on, empty
+    // without options.min_power_factors.
+    std::string key(char tag, std::initializer_list<std::int64_t> parts = {}) const {
+        if (options.min_power_factors <= 0) {
+            return std::string();
+        }
+        std::string text(1, tag);
+        for (const std::int64_t part : parts) {
+            text += std::to_string(part);
+            text += ':';
+        }
+        return text;
+    }
+
+    std::uint32_t add(Node node, const std::string& node_key = std::string()) {
+        const auto id = static_cast<std::uint32_t>(nodes.size());
+        if (options.min_power_factors > 0) {
+            // Folded nodes are keyed by their value, whatever they were computed from.
+            const std::string& text =
+                node.value ? key('c', {std::bit_cast<std::int64_t>(node.value->real()),
+                                       std::bit_cast<std::int64_t>(node.value->imag())})
+                           : node_key;
+            node.structure = structures.try_emplace(text, id).first->second;
+            if (node.factor_count == 1) {
+                node.factor = node.structure;
+            }
+        }
+        nodes.push_back(std::move(node));
+        return id;
+    }
+
+    // Adds a node that is the product of factor_count factors, rewritten into a power of the
+    // factor once there are enough of them. Products too large for an exponent start over.
+    std::uint32_t add_power(Node node, std::string node_key, std::uint32_t factor, std::int64_t factor_count) {
+        if (options.min_power_factors <= 0 || factor_count > std::numeric_limits<std::int32_t>::max()) {
+            return add(std::move(node), node_key);
+        }
+        if (factor_count >= options.min_power_factors) {
+            const Node& base    = nodes[factor];
+            const auto exponent = static_cast<std::int32_t>(factor_count);
+            node                = {make_power(base.expr, exponent), base.size + 1, std::nullopt};
+            node_key            = key('p', {factor, exponent});
+        }
+        node.factor       = factor;
+        node.factor_count = factor_count;
+        return add(std::move(node), node_key);
+    }
+
+    // Replaces an operation over constants with its value, computed by the node itself.
+    static Node fold(Node node, bool constant_operands) {
+        if (!constant_operands) {
+            return node;
+        }
+        const Complex value = node.expr->eval(std::unordered_map<std::string, Complex>());
+        return {make_const(value), 1, value};
+    }
+
+    std::optional<std::uint32_t> identity(Operation operation, std::uint32_t left, std::uint32_t right) const {
+        const std::optional<Complex>& lhs = nodes[left].value;
+        const std::optional<Complex>& rhs = nodes[right].value;
+        switch (operation) {
+        case Operation::Add:
+            if (is_exact(rhs, -0.0, -0.0) || (options.assume_finite && is_exact(rhs, 0.0, 0.0))) {
+                return left;
+            }
+            if (is_exact(lhs, -0.0, -0.0) || (options.assume_finite && is_exact(lhs, 0.0, 0.0))) {
+                return right;
+            }
+            break;
+        case Operation::Subtract:
+            if (is_exact(rhs, 0.0, 0.0) || (options.assume_finite && is_exact(rhs, -0.0, -0.0))) {
+                return left;
+            }
+            break;
+        case Operation::Multiply:
+            if (options.assume_finite && is_exact(rhs, 1.0, 0.0)) {
+                return left;
+            }
+            if (options.assume_finite && is_exact(lhs, 1.0, 0.0)) {
+                return right;
+            }
+            break;
+        case Operation::Divide:
+            if (options.assume_finite && is_exact(rhs, 1.0, 0.0)) {
+                return left;
+            }
+            break;
+        default:
+            break;
+        }
+        return std::nullopt;
+    }
+
+    const SimplifyOptions& options;
+    std::vector<Node> nodes;
+    std::unordered_map<std::string, std::uint32_t> structures;
+    std::size_t original_size = 0;
+};
+
+}  // namespace
+
+SimplifyResult simplify(const Expression& expr, const SimplifyOptions& options) {
+    Simplifier simplifier(options);
+    const std::uint32_t root = expr.accept(simplifier);
+    return simplifier.result(root);
+}
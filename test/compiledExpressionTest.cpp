@@ -0,0 +1,224 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "expressions/compiled_expression.hpp"
+#include "expressions/expressions.hpp"
+#include "testHelpers.hpp"
+
+TEST_CASE("compiled eval matches tree eval") {
+    const VariableSlots slots         = {{"x", 0}, {"y", 1}, {"z", 2}};
+    const std::vector<Complex> values = {Complex(324.6546, -3), Complex(0.09832), Complex(0.09832, 6534)};
+    const std::unordered_map<std::string, Complex> named = {{"x", values[0]}, {"y", values[1]}, {"z", values[2]}};
+
+    SECTION("Mixed tree") {
+        auto expr = Multiply(Add(Const(Complex(0.8)), Const(Complex(12593))),
+                             Divide(Subtract(Variable("x"), Variable("y")), Negate(Conjugate(Variable("z")))));
+        const CompiledExpression compiled(expr, slots);
+
+        check_identical(compiled.eval(values), expr.eval(named));
+        REQUIRE(compiled.instruction_count() == 11);
+    }
+
+    SECTION("Single leaf") {
+        const CompiledExpression compiled(Variable("y"), slots);
+
+        check_identical(compiled.eval(values), values[1]);
+        REQUIRE(compiled.register_count() == 1);
+        REQUIRE(compiled.slot_count() == 2);
+    }
+
+    SECTION("Deep tree spills out of inline registers") {
+        std::unique_ptr<Expression> expr(Variable("x").clone());
+        for (int i = 0; i < 100; ++i) {
+            expr.reset(new Divide(Const(Complex(1.5, i)), Subtract(*expr, Variable("z"))));
+        }
+        const CompiledExpression compiled(*expr, slots);
+
+        REQUIRE(compiled.register_count() > 64);
+        check_identical(compiled.eval(values), expr->eval(named));
+    }
+
+    SECTION("Short spans throw") {
+        auto expr = Add(Variable("x"), Multiply(Variable("z"), Variable("z")));
+        const CompiledExpression compiled(expr, slots);
+        const std::span<const Complex> all(values);
+        std::vector<Complex> scratch(compiled.register_count());
+
+        REQUIRE(compiled.slot_count() == 3);
+        REQUIRE_THROWS_AS(compiled.eval(all.first(2)), std::out_of_range);
+        REQUIRE_THROWS_AS(compiled.eval(all.first(2), scratch), std::out_of_range);
+        REQUIRE_THROWS_AS(compiled.eval(all, std::span<Complex>(scratch).first(scratch.size() - 1)),
+                          std::out_of_range);
+        check_identical(compiled.eval(all, scratch), expr.eval(named));
+    }
+}
+
+TEST_CASE("batch eval matches tree eval") {
+    const VariableSlots slots = {{"x", 0}, {"y", 1}};
+    auto expr = Divide(Multiply(Subtract(Variable("x"), Const(Complex(2, -1))), Conjugate(Variable("y"))),
+                       Add(Negate(Variable("y")), Variable("x")));
+    const CompiledExpression compiled(expr, slots);
+
+    constexpr std::size_t ROWS = 1000;
+    std::vector<double> x_real(ROWS), x_imag(ROWS), y_real(ROWS), y_imag(ROWS);
+    for (std::size_t i = 0; i < ROWS; ++i) {
+        x_real[i] = 0.5 * i - 100;
+        x_imag[i] = 3.25 - 0.01 * i;
+        y_real[i] = (i % 7 == 0) ? 0 : 1e3 / (i + 1);
+        y_imag[i] = 0.75 * i;
+    }
+    const std::vector<ComplexColumn> columns = {{x_real.data(), x_imag.data()}, {y_real.data(), y_imag.data()}};
+
+    std::vector<double> out_real(ROWS), out_imag(ROWS);
+    compiled.eval_batch(columns, ROWS, {out_real.data(), out_imag.data()});
+
+    for (std::size_t i = 0; i < ROWS; ++i) {
+        const Complex ideal = expr.eval({{"x", Complex(x_real[i], x_imag[i])}, {"y", Complex(y_real[i], y_imag[i])}});
+        check_identical(Complex(out_real[i], out_imag[i]), ideal);
+    }
+
+    const std::span<const ComplexColumn> short_columns = std::span<const ComplexColumn>(columns).first(1);
+    REQUIRE_THROWS_AS(compiled.eval_batch(short_columns, ROWS, {out_real.data(), out_imag.data()}),
+                      std::out_of_range);
+    ThreadPool pool(2);
+    REQUIRE_THROWS_AS(compiled.eval_parallel(pool, short_columns, ROWS, {out_real.data(), out_imag.data()}),
+                      std::out_of_range);
+}
+
+TEST_CASE("parallel eval matches batch eval") {
+    const VariableSlots slots = {{"x", 0}};
+    auto expr = Divide(Add(Variable("x"), Const(Complex(1, 2))), Subtract(Variable("x"), Const(Complex(3))));
+    const CompiledExpression compiled(expr, slots);
+
+    constexpr std::size_t ROWS = 5000;
+    std::vector<double> x_real(ROWS), x_imag(ROWS);
+    for (std::size_t i = 0; i < ROWS; ++i) {
+        x_real[i] = 0.25 * i;
+        x_imag[i] = -0.5 * i;
+    }
+    const std::vector<ComplexColumn> columns = {{x_real.data(), x_imag.data()}};
+
+    std::vector<double> batch_real(ROWS), batch_imag(ROWS);
+    compiled.eval_batch(columns, ROWS, {batch_real.data(), batch_imag.data()});
+
+    ThreadPool pool(4);
+    const std::size_t chunk_rows = GENERATE(1, 300, 1000, 100000);
+    std::vector<double> out_real(ROWS), out_imag(ROWS);
+    compiled.eval_parallel(pool, columns, ROWS, {out_real.data(), out_imag.data()}, chunk_rows);
+
+    for (std::size_t i = 0; i < ROWS; ++i) {
+        check_identical(Complex(out_real[i], out_imag[i]), Complex(batch_real[i], batch_imag[i]));
+    }
+}
+
+TEST_CASE("batch eval of elementary functions") {
+    const VariableSlots slots = {{"x", 0}};
+    const auto x              = make_variable("x");
+    const auto expr = make_subtract(make_multiply(make_exp(x), make_sin(x)), make_divide(make_log(x), make_sqrt(x)));
+    const CompiledExpression accurate(*expr, slots);
+    const CompiledExpression fast(*expr, slots, {.batch_accuracy = MathAccuracy::Fast});
+
+    constexpr std::size_t ROWS = 1000;
+    std::vector<double> x_real(ROWS), x_imag(ROWS);
+    for (std::size_t i = 0; i < ROWS; ++i) {
+        x_real[i] = 0.01 * i - 4.995;
+        x_imag[i] = (i % 3 == 0) ? 0 : 2.5 - 0.005 * i;
+    }
+    const std::vector<ComplexColumn> columns = {{x_real.data(), x_imag.data()}};
+
+    std::vector<double> accurate_real(ROWS), accurate_imag(ROWS), fast_real(ROWS), fast_imag(ROWS);
+    accurate.eval_batch(columns, ROWS, {accurate_real.data(), accurate_imag.data()});
+    fast.eval_batch(columns, ROWS, {fast_real.data(), fast_imag.data()});
+
+    for (std::size_t i = 0; i < ROWS; ++i) {
+        const Complex value(x_real[i], x_imag[i]);
+        const Complex ideal = accurate.eval(std::vector<Complex>{value});
+        check_identical(Complex(accurate_real[i], accurate_imag[i]), ideal);
+        check_identical(fast.eval(std::vector<Complex>{value}), ideal);
+        REQUIRE((Complex(fast_real[i], fast_imag[i]) - ideal).abs() <= 1e-13 * (1 + ideal.abs()));
+    }
+}
+
+TEST_CASE("batch eval of powers") {
+    const VariableSlots slots = {{"x", 0}, {"y", 1}};
+    const auto x              = make_variable("x");
+    const auto expr = make_add(make_multiply(make_power(x, 7), make_power(make_variable("y"), -3)),
+                               make_complex_power(x, make_variable("y")));
+    const CompiledExpression compiled(*expr, slots);
+
+    constexpr std::size_t ROWS = 600;
+    std::vector<double> x_real(ROWS), x_imag(ROWS), y_real(ROWS), y_imag(ROWS);
+    for (std::size_t i = 0; i < ROWS; ++i) {
+        x_real[i] = 0.01 * i - 3;
+        x_imag[i] = 1.5 - 0.002 * i;
+        y_real[i] = (i % 5 == 0) ? 0 : 0.25 * (i % 9);
+        y_imag[i] = 0.5 - 0.001 * i;
+    }
+    const std::vector<ComplexColumn> columns = {{x_real.data(), x_imag.data()}, {y_real.data(), y_imag.data()}};
+
+    std::vector<double> out_real(ROWS), out_imag(ROWS);
+    compiled.eval_batch(columns, ROWS, {out_real.data(), out_imag.data()});
+
+    for (std::size_t i = 0; i < ROWS; ++i) {
+        const Complex x_value(x_real[i], x_imag[i]);
+        const Complex y_value(y_real[i], y_imag[i]);
+        const Complex ideal = expr->eval({{"x", x_value}, {"y", y_value}});
+        check_identical(compiled.eval(std::vector<Complex>{x_value, y_value}), ideal);
+        check_identical(Complex(out_real[i], out_imag[i]), ideal);
+    }
+}
+
+TEST_CASE("single precision pipeline") {
+    const VariableSlots slots = {{"x", 0}, {"y", 1}};
+    auto expr                 = Divide(Multiply(Variable("x"), Const(Complex(0.5, 0.25))), Negate(Variable("y")));
+    const CompiledExpression compiled(expr, slots);
+
+    const std::vector<BasicComplex<float>> values = {BasicComplex<float>(1.5F, -2.0F),
+                                                     BasicComplex<float>(4.0F, 1.0F)};
+    const BasicComplex<float> ideal = (values[0] * BasicComplex<float>(0.5F, 0.25F)) / -values[1];
+
+    const BasicComplex<float> single = compiled.eval(values);
+    REQUIRE(single.real() == ideal.real());
+    REQUIRE(single.imag() == ideal.imag());
+
+    const std::vector<float> x_real = {1.5F, 2.0F}, x_imag = {-2.0F, 0.0F};
+    const std::vector<float> y_real = {4.0F, 1.0F}, y_imag = {1.0F, -1.0F};
+    const std::vector<BasicComplexColumn<float>> columns = {{x_real.data(), x_imag.data()},
+                                                            {y_real.data(), y_imag.data()}};
+    std::vector<float> out_real(2), out_imag(2);
+    compiled.eval_batch(columns, 2, {out_real.data(), out_imag.data()});
+    REQUIRE(out_real[0] == ideal.real());
+    REQUIRE(out_imag[0] == ideal.imag());
+
+    const std::vector<BasicComplex<long double>> wide = {BasicComplex<long double>(1.5L, -2.0L),
+                                                         BasicComplex<long double>(4.0L, 1.0L)};
+    REQUIRE(BasicComplex<float>(compiled.eval(wide)) == ideal);
+}
+
+TEST_CASE("common subexpressions are computed once") {
+    const VariableSlots slots         = {{"x", 0}, {"y", 1}};
+    const std::vector<Complex> values = {Complex(1.25, -3), Complex(-0.5, 7)};
+
+    auto shared = Divide(Add(Variable("x"), Const(Complex(2, 1))), Conjugate(Variable("y")));
+    auto expr   = Subtract(Multiply(shared, shared), Add(shared, Multiply(Variable("x"), Variable("x"))));
+
+    const CompiledExpression plain(expr, slots, {.eliminate_common_subexpressions = false});
+    const CompiledExpression shared_tape(expr, slots);
+
+    REQUIRE(plain.instruction_count() == 24);
+    REQUIRE(shared_tape.instruction_count() == 10);
+    check_identical(shared_tape.eval(values), plain.eval(values));
+    check_identical(shared_tape.eval(values), expr.eval({{"x", values[0]}, {"y", values[1]}}));
+
+    SECTION("Signed zeros and NaNs stay distinct constants") {
+        auto zeros = Add(Divide(Variable("x"), Const(Complex(0.0))), Divide(Variable("x"), Const(Complex(-0.0))));
+        const CompiledExpression zeros_tape(zeros, slots);
+
+        check_identical(zeros_tape.eval(values), zeros.eval({{"x", values[0]}}));
+    }
+}
@@ -0,0 +1,55 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/generators/catch_generators_adapters.hpp>
+#include <catch2/generators/catch_generators_random.hpp>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "complex/complex_array.hpp"
+#include "testHelpers.hpp"
+
+TEST_CASE("ComplexArray storage") {
+    ComplexArray zeros(5);
+    REQUIRE(zeros.size() == 5);
+    check_identical(zeros[4], Complex(0, 0));
+
+    const std::vector<Complex> values = {Complex(1, 2), Complex(-3, 4.5)};
+    ComplexArray array(values);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(array.real_data()) % ComplexArray::ALIGNMENT == 0);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(array.imag_data()) % ComplexArray::ALIGNMENT == 0);
+
+    ComplexArray copy = array;
+    copy.set(1, Complex(7, 8));
+    check_identical(array[1], values[1]);
+    check_identical(copy[1], Complex(7, 8));
+    REQUIRE(copy.to_vector().size() == 2);
+
+    REQUIRE_THROWS_AS(zeros + array, std::invalid_argument);
+}
+
+TEST_CASE("ComplexArray operations match scalar Complex") {
+    const std::size_t size           = GENERATE(0, 1, 7, 64, 1001);
+    const std::vector<Complex> left  = random_values(size, 1e50, 1);
+    const std::vector<Complex> right = random_values(size, 1e50, 2);
+    const ComplexArray left_array(left);
+    const ComplexArray right_array(right);
+
+    const ComplexArray sum        = left_array + right_array;
+    const ComplexArray difference = left_array - right_array;
+    const ComplexArray product    = left_array * right_array;
+    const ComplexArray quotient   = left_array / right_array;
+    const ComplexArray negated    = -left_array;
+    const ComplexArray conjugated = ~left_array;
+    const std::vector<double> abs = left_array.abs();
+
+    for (std::size_t i = 0; i < size; ++i) {
+        check_identical(sum[i], left[i] + right[i]);
+        check_identical(difference[i], left[i] - right[i]);
+        check_identical(product[i], left[i] * right[i]);
+        check_identical(quotient[i], left[i] / right[i]);
+        check_identical(negated[i], -left[i]);
+        check_identical(conjugated[i], ~left[i]);
+        REQUIRE(abs[i] == left[i].abs());
+    }
+}
@@ -0,0 +1,130 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "complex/complex.hpp"
+#include "complex/complex_array.hpp"
+#include "complex/complex_format.hpp"
+
+static std::vector<Complex> random_bits(std::size_t size, std::uint32_t seed) {
+    std::mt19937_64 generator(seed);
+    std::vector<Complex> values;
+    while (values.size() < size) {
+        const double real = std::bit_cast<double>(generator());
+        const double imag = std::bit_cast<double>(generator());
+        if (std::isfinite(real) && std::isfinite(imag)) {
+            values.emplace_back(real, imag);
+        }
+    }
+    return values;
+}
+
+static void check_bits(Complex test, Complex ideal) {
+    REQUIRE(std::bit_cast<std::uint64_t>(test.real()) == std::bit_cast<std::uint64_t>(ideal.real()));
+    REQUIRE(std::bit_cast<std::uint64_t>(test.imag()) == std::bit_cast<std::uint64_t>(ideal.imag()));
+}
+
+TEST_CASE("str matches stream formatting") {
+    const double inf = std::numeric_limits<double>::infinity();
+    const std::vector<Complex> values = {Complex(),           Complex(0.8),        Complex(12593.8, -1),
+                                         Complex(1e10, 3e-7), Complex(-0.0, 1e300), Complex(inf, -inf),
+                                         Complex(123456789, 0.1 + 0.2)};
+    for (const Complex& value : values) {
+        std::ostringstream ideal;
+        ideal << "(" << value.real() << "; " << value.imag() << ")";
+        REQUIRE_THAT(value.str(), Catch::Matchers::Equals(ideal.str()));
+
+        std::ostringstream streamed;
+        streamed << value;
+        REQUIRE_THAT(streamed.str(), Catch::Matchers::Equals(ideal.str()));
+    }
+    REQUIRE_THAT(BasicComplex<float>(1.5F, -2).str(), Catch::Matchers::Equals("(1.5; -2)"));
+    REQUIRE_THAT(BasicComplex<long double>(1e-4000L, 2).str(), Catch::Matchers::Equals("(1e-4000; 2)"));
+}
+
+TEST_CASE("to_chars round trips") {
+    char buffer[COMPLEX_CHARS_MAX<double>];
+    for (const Complex& value : random_bits(10000, 7)) {
+        const std::to_chars_result written = to_chars(buffer, buffer + sizeof(buffer), value);
+        REQUIRE(written.ec == std::errc());
+
+        Complex parsed;
+        const std::from_chars_result read = from_chars(buffer, written.ptr, parsed);
+        REQUIRE(read.ec == std::errc());
+        REQUIRE(read.ptr == written.ptr);
+        check_bits(parsed, value);
+    }
+
+    const Complex value(-0.1, 2.5e-300);
+    const std::to_chars_result written = to_chars(buffer, buffer + sizeof(buffer), value);
+    REQUIRE(std::string(buffer, written.ptr) == "(-0.1; 2.5e-300)");
+    REQUIRE(to_chars(buffer, buffer + 10, value).ec == std::errc::value_too_large);
+
+    const std::to_chars_result fixed = to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, 2);
+    REQUIRE(std::string(buffer, fixed.ptr) == "(-0.10; 0.00)");
+
+    BasicComplex<long double> precise;
+    const std::string text = "(0.1; -3e-4000)";
+    REQUIRE(from_chars(text.data(), text.data() + text.size(), precise).ec == std::errc());
+    REQUIRE(precise.real() == 0.1L);
+    REQUIRE(precise.imag() == -3e-4000L);
+}
+
+TEST_CASE("from_chars rejects malformed text") {
+    const Complex original(1, 2);
+    for (const std::string text : {"", "1; 2)", "(1 2)", "(1; 2", "(x; 2)", "(1; )", " (1; 2)"}) {
+        Complex value                       = original;
+        const std::from_chars_result result = from_chars(text.data(), text.data() + text.size(), value);
+        REQUIRE(result.ec == std::errc::invalid_argument);
+        REQUIRE(result.ptr == text.data());
+        check_bits(value, original);
+    }
+
+    Complex value;
+    const std::string spaced = "( 1 ;2 ) tail";
+    const std::from_chars_result result = from_chars(spaced.data(), spaced.data() + spaced.size(), value);
+    REQUIRE(result.ec == std::errc());
+    REQUIRE(result.ptr == spaced.data() + 8);
+    check_bits(value, Complex(1, 2));
+
+    BasicComplex<float> small;
+    const std::string huge = "(1e300; 0)";
+    REQUIRE(from_chars(huge.data(), huge.data() + huge.size(), small).ec == std::errc::result_out_of_range);
+}
+
+TEST_CASE("bulk formatting round trips") {
+    const std::vector<Complex> values = random_bits(1000, 11);
+
+    std::string text = "header\n";
+    format_complex(values, text);
+    REQUIRE(text.starts_with("header\n("));
+    REQUIRE(text.back() == '\n');
+
+    const std::vector<Complex> parsed = parse_complex(std::string_view(text).substr(7));
+    REQUIRE(parsed.size() == values.size());
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        check_bits(parsed[i], values[i]);
+    }
+
+    const ComplexArray array(values);
+    std::string array_text;
+    format_complex(array, array_text);
+    REQUIRE(array_text == text.substr(7));
+
+    const ComplexArray parsed_array = parse_complex_array(" \t" + array_text + "\r\n");
+    REQUIRE(parsed_array.size() == values.size());
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        check_bits(parsed_array[i], values[i]);
+    }
+
+    REQUIRE(parse_complex("").empty());
+    REQUIRE_THROWS_WITH(parse_complex("(1; 2)\n(3; four)"), "malformed complex number at position 7");
+}
@@ -0,0 +1,194 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "complex/complex_math.hpp"
+#include "testHelpers.hpp"
+
+// Normwise error in units of the unit roundoff, relative to max(|exact|, floor).
+static long double error_units(Complex test, Reference exact, long double floor = 0) {
+    const long double scale = std::max(std::abs(exact), floor);
+    return std::abs(reference(test) - exact) / scale / UNIT_ROUNDOFF;
+}
+
+// Magnitudes spread log-uniformly over [1e-100, 1e100] at every angle.
+static std::vector<Complex> random_polar_values(std::size_t size, std::uint32_t seed) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> exponent(-100, 100);
+    std::uniform_real_distribution<double> angle(-3.14159, 3.14159);
+    std::vector<Complex> values;
+    for (std::size_t i = 0; i < size; ++i) {
+        const double magnitude = std::pow(10.0, exponent(generator));
+        const double phase     = angle(generator);
+        values.emplace_back(magnitude * std::cos(phase), magnitude * std::sin(phase));
+    }
+    return values;
+}
+
+TEST_CASE("Elementary functions of special values") {
+    check_identical(exp(Complex(0, 0)), Complex(1, 0));
+    check_identical(exp(Complex(1000, 0)), Complex(std::numeric_limits<double>::infinity(), 0));
+    check_identical(log(Complex(1, 0)), Complex(0, 0));
+    check_identical(sqrt(Complex(-4, 0)), Complex(0, 2));
+    check_identical(sqrt(Complex(-4, -0.0)), Complex(0, -2));
+    check_identical(sqrt(Complex(0, -0.0)), Complex(0, -0.0));
+    check_identical(sin(Complex(0, 0)), Complex(0, 0));
+    check_identical(cos(Complex(0, 0)), Complex(1, -0.0));
+    check_identical(pow(Complex(0), Complex(0)), Complex(1));
+    check_identical(pow(Complex(0), Complex(2, 5)), Complex(0));
+    REQUIRE(log(Complex(-1, 0)).imag() == std::atan2(0.0, -1.0));
+    REQUIRE(log(Complex(-1, -0.0)).imag() == -std::atan2(0.0, -1.0));
+    REQUIRE(std::abs(pow(Complex(0, 1), Complex(2)).real() + 1) < 1e-15);
+}
+
+TEST_CASE("Elementary functions meet their error bounds") {
+    const MathAccuracy accuracy = GENERATE(MathAccuracy::Accurate, MathAccuracy::Fast);
+    const bool fast             = accuracy == MathAccuracy::Fast;
+
+    // The ranges of complex_math.hpp, half of the values with the other part within [-20, 20].
+    std::vector<Complex> exp_values  = random_values(5000, 700, 1e6, 1);
+    std::vector<Complex> trig_values = random_values(5000, 1e6, 700, 2);
+    for (const Complex& value : random_values(5000, 700, 20, 3)) {
+        exp_values.push_back(value);
+    }
+    for (const Complex& value : random_values(5000, 20, 700, 4)) {
+        trig_values.push_back(value);
+    }
+    const std::vector<Complex> polar_values = random_polar_values(10000, 5);
+
+    const std::vector<Complex> exps    = exp(ComplexArray(exp_values), accuracy).to_vector();
+    const std::vector<Complex> sines   = sin(ComplexArray(trig_values), accuracy).to_vector();
+    const std::vector<Complex> cosines = cos(ComplexArray(trig_values), accuracy).to_vector();
+    const std::vector<Complex> logs    = log(ComplexArray(polar_values), accuracy).to_vector();
+    const std::vector<Complex> roots   = sqrt(ComplexArray(polar_values), accuracy).to_vector();
+
+    for (std::size_t i = 0; i < exp_values.size(); ++i) {
+        const Reference z(exp_values[i].real(), exp_values[i].imag());
+        REQUIRE(error_units(exps[i], std::exp(z)) <= (fast ? 4 : 3));
+    }
+    for (std::size_t i = 0; i < trig_values.size(); ++i) {
+        const Reference z(trig_values[i].real(), trig_values[i].imag());
+        REQUIRE(error_units(sines[i], std::sin(z)) <= 4);
+        REQUIRE(error_units(cosines[i], std::cos(z)) <= 4);
+    }
+    for (std::size_t i = 0; i < polar_values.size(); ++i) {
+        const Reference z(polar_values[i].real(), polar_values[i].imag());
+        REQUIRE(error_units(logs[i], std::log(z), 1) <= (fast ? 3 : 2));
+        REQUIRE(error_units(roots[i], std::sqrt(z)) <= 3);
+    }
+}
+
+TEST_CASE("Fast elementary functions fall back outside of their domain") {
+    const double infinity = std::numeric_limits<double>::infinity();
+    const double nan      = std::numeric_limits<double>::quiet_NaN();
+    const auto check      = [](const std::vector<Complex>& values, const auto& function) {
+        const std::vector<Complex> results = function(ComplexArray(values), MathAccuracy::Fast).to_vector();
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            check_identical(results[i], function(values[i]));
+        }
+    };
+
+    const std::vector<Complex> exp_values  = {Complex(800, 1), Complex(-800, 1), Complex(1, 1e7),
+                                              Complex(infinity, 0), Complex(nan, 1)};
+    const std::vector<Complex> norm_values = {Complex(0, 0), Complex(1e-200, 0), Complex(1e200, -1),
+                                              Complex(-infinity, 0), Complex(nan, 1)};
+    const std::vector<Complex> trig_values = {Complex(1e7, 1), Complex(1, 800), Complex(infinity, 0), Complex(nan, 1)};
+    check(exp_values, [](const auto& value, auto... accuracy) { return exp(value, accuracy...); });
+    check(norm_values, [](const auto& value, auto... accuracy) { return log(value, accuracy...); });
+    check(norm_values, [](const auto& value, auto... accuracy) { return sqrt(value, accuracy...); });
+    check(trig_values, [](const auto& value, auto... accuracy) { return sin(value, accuracy...); });
+    check(trig_values, [](const auto& value, auto... accuracy) { return cos(value, accuracy...); });
+
+    // The output may alias the operand.
+    ComplexArray array(exp_values);
+    exp_planes(array.size(), array.real_data(), array.imag_data(), array.real_data(), array.imag_data(),
+               MathAccuracy::Fast);
+    check_identical(array[0], exp(exp_values[0]));
+    check_identical(array[2], exp(exp_values[2]));
+}
+
+TEST_CASE("pow of arrays") {
+    const std::vector<Complex> bases     = {Complex(0), Complex(0), Complex(2, 1), Complex(-1, 0), Complex(3, -4)};
+    const std::vector<Complex> exponents = {Complex(0), Complex(1.5, 2), Complex(0.5, -1), Complex(0.5), Complex(2)};
+    const MathAccuracy accuracy          = GENERATE(MathAccuracy::Accurate, MathAccuracy::Fast);
+
+    const std::vector<Complex> powers = pow(ComplexArray(bases), ComplexArray(exponents), accuracy).to_vector();
+    check_identical(powers[0], Complex(1));
+    check_identical(powers[1], Complex(0));
+    for (std::size_t i = 2; i < bases.size(); ++i) {
+        const Reference exact = std::pow(reference(bases[i]),
+                                         reference(exponents[i]));
+        REQUIRE(error_units(powers[i], exact) <= 16);
+    }
+
+    REQUIRE_THROWS_AS(pow(ComplexArray(2), ComplexArray(3)), std::invalid_argument);
+}
+
+TEST_CASE("Integer powers") {
+    const double infinity = std::numeric_limits<double>::infinity();
+    const Complex base(1.25, -0.5);
+    for (std::int32_t exponent = 1; exponent <= 40; ++exponent) {
+        const Reference exact = std::pow(reference(base), exponent);
+        REQUIRE(error_units(pow(base, exponent), exact) <= 4 * exponent);
+        REQUIRE(error_units(pow(base, -exponent), Reference(1) / exact) <= 4 * exponent + 4);
+    }
+    check_identical(pow(base, 1), base);
+    check_identical(pow(base, 2), base * base);
+    check_identical(pow(base, 3), base * base * base);
+    check_identical(pow(base, -1), base.inverse());
+
+    check_identical(pow(Complex(std::nan(""), 1), 0), Complex(1));
+    check_identical(pow(Complex(infinity, 0), 2), Complex(infinity, std::nan("")));
+    check_identical(pow(Complex(2, 0), 1100), Complex(infinity, std::nan("")));
+    check_identical(pow(Complex(1, 0), std::numeric_limits<std::int32_t>::min()), Complex(1, -0.0));
+    check_identical(pow(Complex(0, 1), std::numeric_limits<std::int32_t>::max()), Complex(-0.0, -1));
+}
+
+TEST_CASE("Integer powers of planes round like the scalar pow") {
+    const std::vector<Complex> values = random_values(1000, 3, 3, 6);
+    const std::int32_t exponent       = GENERATE(0, 1, 2, 7, 64, -1, -13);
+    const std::vector<Complex> powers = pow(ComplexArray(values), exponent).to_vector();
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        check_identical(powers[i], pow(values[i], exponent));
+    }
+
+    const std::vector<float> real = {0.5F, -2.0F, 3.0F};
+    const std::vector<float> imag = {1.0F, 0.25F, -7.0F};
+    std::vector<float> float_real(3);
+    std::vector<float> float_imag(3);
+    pow_planes(3, real.data(), imag.data(), exponent, float_real.data(), float_imag.data());
+    for (std::size_t i = 0; i < 3; ++i) {
+        check_identical(Complex(float_real[i], float_imag[i]), pow(BasicComplex<float>(real[i], imag[i]), exponent));
+    }
+}
+
+TEST_CASE("Elementary functions of float and long double planes") {
+    const std::vector<float> real = {0.5F, -2.0F, 3.0F};
+    const std::vector<float> imag = {1.0F, 0.25F, -7.0F};
+    std::vector<float> fast_real(3);
+    std::vector<float> fast_imag(3);
+    std::vector<float> accurate_real(3);
+    std::vector<float> accurate_imag(3);
+    sin_planes(3, real.data(), imag.data(), fast_real.data(), fast_imag.data(), MathAccuracy::Fast);
+    sin_planes(3, real.data(), imag.data(), accurate_real.data(), accurate_imag.data());
+    for (std::size_t i = 0; i < 3; ++i) {
+        const BasicComplex<float> exact = BasicComplex<float>(sin(Complex(real[i], imag[i])));
+        REQUIRE(BasicComplex<float>(fast_real[i], fast_imag[i]) == exact);
+        REQUIRE(BasicComplex<float>(accurate_real[i], accurate_imag[i]) == exact);
+    }
+
+    const long double operand_real = 1.25L;
+    const long double operand_imag = -0.5L;
+    long double result_real        = 0;
+    long double result_imag        = 0;
+    log_planes(1, &operand_real, &operand_imag, &result_real, &result_imag, MathAccuracy::Fast);
+    const BasicComplex<long double> expected = log(BasicComplex<long double>(operand_real, operand_imag));
+    REQUIRE(result_real == expected.real());
+    REQUIRE(result_imag == expected.imag());
+}
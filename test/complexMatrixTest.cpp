@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "complex/complex_matrix.hpp"
+#include "testHelpers.hpp"
+
+static ComplexMatrix random_matrix(std::size_t rows, std::size_t columns, std::uint32_t seed) {
+    return ComplexMatrix(rows, columns, random_values(rows * columns, seed));
+}
+
+// Requires every entry of test within a few units of k u times the sum of
+// (|re| + |im|)(|re| + |im|) over its products, the bound of both product methods.
+static void check_product(const ComplexMatrix& test, const ComplexMatrix& left, const ComplexMatrix& right) {
+    const std::size_t k = left.columns();
+    for (std::size_t i = 0; i < test.rows(); ++i) {
+        for (std::size_t j = 0; j < test.columns(); ++j) {
+            Reference exact;
+            long double magnitude = 0;
+            for (std::size_t p = 0; p < k; ++p) {
+                const Complex a = left(i, p);
+                const Complex b = right(p, j);
+                exact += reference(a) * reference(b);
+                magnitude += (std::abs(a.real()) + std::abs(a.imag())) * (std::abs(b.real()) + std::abs(b.imag()));
+            }
+            REQUIRE(std::abs(reference(test(i, j)) - exact) <= 2 * (k + 4) * UNIT_ROUNDOFF * magnitude);
+        }
+    }
+}
+
+TEST_CASE("Matrix product matches the naive loops") {
+    // Partial register tiles, several cache blocks in each dimension and empty products.
+    const auto [m, n, k] = GENERATE(table<std::size_t, std::size_t, std::size_t>(
+        {{1, 1, 1}, {5, 7, 3}, {4, 8, 16}, {65, 130, 257}, {130, 600, 300}, {3, 4, 0}, {0, 4, 3}}));
+    const MathAccuracy accuracy = GENERATE(MathAccuracy::Accurate, MathAccuracy::Fast);
+    const ComplexMatrix left    = random_matrix(m, k, 1);
+    const ComplexMatrix right   = random_matrix(k, n, 2);
+
+    const ComplexMatrix product = multiply(left, right, accuracy);
+    REQUIRE(product.rows() == m);
+    REQUIRE(product.columns() == n);
+    check_product(product, left, right);
+
+    ThreadPool pool(3);
+    const ComplexMatrix parallel = multiply(pool, left, right, accuracy);
+    for (std::size_t i = 0; i < m; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            check_identical(parallel(i, j), product(i, j));
+        }
+    }
+}
+
+TEST_CASE("Matrix product accuracy") {
+    // The exact imaginary part 1 * -2^-30 + 2^-30 * 1 cancels to zero. The four
+    // multiplications get it exactly, the 3M method only up to the rounding of
+    // (1 + 2^-30)(1 - 2^-30).
+    const ComplexMatrix left(1, 1, std::vector<Complex>{Complex(1, 0x1p-30)});
+    const ComplexMatrix right(1, 1, std::vector<Complex>{Complex(1, -0x1p-30)});
+    check_identical(multiply(left, right)(0, 0), Complex(1 + 0x1p-60, 0));
+    const Complex fast = multiply(left, right, MathAccuracy::Fast)(0, 0);
+    REQUIRE(fast.imag() != 0);
+    REQUIRE(std::abs(fast.imag()) <= 0x1p-52);
+
+    const ComplexMatrix identity = ComplexMatrix::identity(37);
+    const ComplexMatrix values   = random_matrix(37, 37, 3);
+    REQUIRE((identity * values).to_vector() == values.to_vector());
+    REQUIRE(multiply(values, identity).to_vector() == values.to_vector());
+}
+
+TEST_CASE("Matrix product adds to strided blocks") {
+    const ComplexMatrix left  = random_matrix(9, 20, 4);
+    const ComplexMatrix right = random_matrix(20, 11, 5);
+    ComplexMatrix out         = random_matrix(12, 15, 6);
+    const ComplexMatrix start = out;
+
+    // out[2:7, 3:13] -= left[1:6, 4:14] * right[5:15, 1:11]
+    multiply_add_planes(5, 10, 10, -1, left.real_data() + 24, left.imag_data() + 24, 20, right.real_data() + 56,
+                        right.imag_data() + 56, 11, out.real_data() + 33, out.imag_data() + 33, 15);
+    for (std::size_t i = 0; i < out.rows(); ++i) {
+        for (std::size_t j = 0; j < out.columns(); ++j) {
+            if (i < 2 || i >= 7 || j < 3 || j >= 13) {
+                check_identical(out(i, j), start(i, j));
+                continue;
+            }
+            Reference exact = reference(start(i, j));
+            for (std::size_t p = 0; p < 10; ++p) {
+                exact -= reference(left(i - 1, p + 4)) * reference(right(p + 5, j - 2));
+            }
+            REQUIRE(std::abs(reference(out(i, j)) - exact) <= 100 * UNIT_ROUNDOFF);
+        }
+    }
+}
+
+TEST_CASE("Matrix vector product matches the naive loops") {
+    const std::size_t rows     = GENERATE(1, 7, 64, 300);
+    const std::size_t columns  = GENERATE(1, 9, 16, 333);
+    const ComplexMatrix matrix = random_matrix(rows, columns, 7);
+    const ComplexArray vector  = ComplexArray(random_values(columns, 8));
+
+    const ComplexArray product = matrix * vector;
+    REQUIRE(product.size() == rows);
+    for (std::size_t i = 0; i < rows; ++i) {
+        Reference exact;
+        for (std::size_t j = 0; j < columns; ++j) {
+            exact += reference(matrix(i, j)) * reference(vector[j]);
+        }
+        REQUIRE(std::abs(reference(product[i]) - exact) <= 4 * (columns + 2) * UNIT_ROUNDOFF);
+    }
+
+    ThreadPool pool(3);
+    const ComplexArray parallel = multiply(pool, matrix, vector);
+    for (std::size_t i = 0; i < rows; ++i) {
+        check_identical(parallel[i], product[i]);
+    }
+}
+
+TEST_CASE("LU decomposition solves linear systems") {
+    // One panel, a partial panel and several blocked steps.
+    const std::size_t size     = GENERATE(1, 3, 64, 65, 150, 200);
+    const ComplexMatrix matrix = random_matrix(size, size, 9);
+    const LuDecomposition lu(matrix);
+    REQUIRE(lu.size() == size);
+    REQUIRE(!lu.is_singular());
+
+    // P A = L U.
+    const std::vector<std::size_t> rows = lu.permutation();
+    const ComplexMatrix& factors        = lu.factors();
+    for (std::size_t i = 0; i < size; ++i) {
+        for (std::size_t j = 0; j < size; ++j) {
+            Reference product = i <= j ? reference(factors(i, j)) : 0;
+            for (std::size_t p = 0; p < std::min(i, j + 1); ++p) {
+                product += reference(factors(i, p)) * reference(factors(p, j));
+            }
+            REQUIRE(std::abs(product - reference(matrix(rows[i], j))) <= 8 * size * UNIT_ROUNDOFF);
+        }
+    }
+
+    // Small residuals relative to the size of A x.
+    const ComplexArray right_side = ComplexArray(random_values(size, 10));
+    const ComplexArray solution   = lu.solve(right_side);
+    const ComplexArray residual   = matrix * solution - right_side;
+    long double largest           = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        largest = std::max(largest, std::abs(reference(solution[i])));
+    }
+    for (std::size_t i = 0; i < size; ++i) {
+        REQUIRE(std::abs(reference(residual[i])) <= 16 * size * size * UNIT_ROUNDOFF * largest);
+    }
+
+    // Every column of a matrix right side solves like a vector.
+    const ComplexMatrix right_sides = random_matrix(size, 3, 11);
+    const ComplexMatrix solutions   = lu.solve(right_sides);
+    for (std::size_t column = 0; column < 3; ++column) {
+        ComplexArray single(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            single.set(i, right_sides(i, column));
+        }
+        const ComplexArray expected = lu.solve(single);
+        for (std::size_t i = 0; i < size; ++i) {
+            check_identical(solutions(i, column), expected[i]);
+        }
+    }
+
+    ThreadPool pool(3);
+    const LuDecomposition parallel(pool, matrix);
+    REQUIRE(parallel.factors().to_vector() == factors.to_vector());
+}
+
+TEST_CASE("LU decomposition determinant and singular matrices") {
+    const ComplexMatrix swap(2, 2, std::vector<Complex>{Complex(0), Complex(1), Complex(1), Complex(0)});
+    const LuDecomposition swapped(swap);
+    check_identical(swapped.determinant(), Complex(-1, -0.0));
+    REQUIRE(swapped.permutation() == std::vector<std::size_t>{1, 0});
+    const ComplexArray solution = swapped.solve(ComplexArray(std::vector<Complex>{Complex(2, 1), Complex(3)}));
+    check_identical(solution[0], Complex(3));
+    check_identical(solution[1], Complex(2, 1));
+
+    const ComplexMatrix triangular(3, 3,
+                                   std::vector<Complex>{Complex(2), Complex(5), Complex(7), Complex(0), Complex(0, 1),
+                                                        Complex(3), Complex(0), Complex(0), Complex(1, 1)});
+    check_identical(LuDecomposition(triangular).determinant(), Complex(-2, 2));
+
+    const ComplexMatrix dependent(2, 2, std::vector<Complex>{Complex(1), Complex(2), Complex(2), Complex(4)});
+    const LuDecomposition singular(dependent);
+    REQUIRE(singular.is_singular());
+    check_identical(singular.determinant(), Complex(0, -0.0));
+    REQUIRE_THROWS_AS(singular.solve(ComplexArray(2)), std::domain_error);
+    REQUIRE(LuDecomposition(ComplexMatrix(70, 70)).is_singular());
+}
+
+TEST_CASE("Matrix argument errors") {
+    REQUIRE_THROWS_AS(ComplexMatrix(2, 3, random_values(5, 12)), std::invalid_argument);
+    REQUIRE_THROWS_AS(multiply(ComplexMatrix(2, 3), ComplexMatrix(2, 3)), std::invalid_argument);
+    REQUIRE_THROWS_AS(ComplexMatrix(2, 3) * ComplexArray(2), std::invalid_argument);
+    REQUIRE_THROWS_AS(LuDecomposition(ComplexMatrix(2, 3)), std::invalid_argument);
+
+    const LuDecomposition lu(ComplexMatrix::identity(3));
+    REQUIRE_THROWS_AS(lu.solve(ComplexArray(2)), std::invalid_argument);
+    REQUIRE_THROWS_AS(lu.solve(ComplexMatrix(4, 1)), std::invalid_argument);
+}
@@ -6,6 +6,7 @@
 #include <complex>
 #include <iostream>
 #include <random>
+#include <type_traits>
 
 #include "complex/complex.hpp"
 
@@ -393,4 +394,49 @@ TEST_CASE("== and !=") {
 
         REQUIRE(ideal != test);
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Constant expressions") {
+    constexpr Complex left(3, -4);
+    constexpr Complex right(0.5, 2);
+
+    static_assert((left + right).real() == 3.5);
+    static_assert((left - right).imag() == -6);
+    static_assert(left * right == Complex(9.5, 4));
+    static_assert(-~left == Complex(-3, -4));
+    static_assert((left / right) * right == left);
+    static_assert(left.inverse() * left == Complex(1));
+    static_assert(std::is_trivially_copyable_v<Complex>);
+
+    Complex self(2, 3);
+    self *= self;
+    check_complex_equality(std::complex<double>(2, 3) * std::complex<double>(2, 3), self);
+    self = Complex(2, 3);
+    self /= self;
+    check_complex_equality(std::complex<double>(1, 0), self);
+}
+
+TEST_CASE("Other precisions") {
+    SECTION("float") {
+        constexpr BasicComplex<float> left(3.0F, -4.0F);
+        static_assert(std::is_same_v<decltype(left.real()), float>);
+        static_assert(left * left.inverse() == BasicComplex<float>(1.0F));
+        static_assert(BasicComplex<float>(1.0F, 0.0F) == BasicComplex<float>(1.00001F, 0.0F));
+        REQUIRE_THAT(left.abs(), Catch::Matchers::WithinRel(5.0F));
+    }
+
+    SECTION("long double") {
+        constexpr BasicComplex<long double> left(3.0L, -4.0L);
+        static_assert(left / left == BasicComplex<long double>(1.0L));
+        static_assert(BasicComplex<long double>(1.0L) != BasicComplex<long double>(1.0L + 1e-8L));
+        REQUIRE_THAT(static_cast<double>(left.abs()), Catch::Matchers::WithinRel(5.0));
+    }
+
+    SECTION("Conversions") {
+        constexpr BasicComplex<float> narrow(1.5F, 2.5F);
+        constexpr Complex wide = narrow;
+        static_assert(wide.real() == 1.5 && wide.imag() == 2.5);
+        static_assert(BasicComplex<float>(wide) == narrow);
+        static_assert(!std::is_convertible_v<Complex, BasicComplex<float>>);
+    }
+}
@@ -0,0 +1,189 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+#include "expressions/expression_file.hpp"
+#include "expressions/expressions.hpp"
+
+static void write_bytes(const std::string& path, const std::string& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+TEST_CASE("mapped expression evaluates in place") {
+    const std::string path = (std::filesystem::temp_directory_path() / "expressionFileTest.cxexpr").string();
+
+    auto expr = Multiply(Add(Const(Complex(0.8, -1e300)), Variable("x")),
+                         Divide(Subtract(Variable("x"), Variable("some_rather_long_variable_name")),
+                                Negate(static_cast<const Expression&>(Conjugate(Variable("z"))))));
+    save_expression(expr, path);
+
+    MappedExpression mapped(path);
+    REQUIRE(mapped.node_count() == 11);
+    REQUIRE(mapped.variable_count() == 3);
+    REQUIRE(mapped.variable_name(0) == "x");
+    REQUIRE(mapped.variable_name(1) == "some_rather_long_variable_name");
+    REQUIRE(mapped.variable_name(2) == "z");
+    REQUIRE_THROWS_AS(mapped.variable_name(3), std::out_of_range);
+
+    const std::unordered_map<std::string, Complex> values = {
+        {"x", Complex(324.6546, 1)}, {"some_rather_long_variable_name", Complex(-7, 3)}, {"z", Complex(0.09832, 6534)}};
+    const Complex ideal = expr.eval(values);
+    REQUIRE(mapped.eval(values).real() == ideal.real());
+    REQUIRE(mapped.eval(values).imag() == ideal.imag());
+
+    const std::vector<Complex> slots = {values.at("x"), values.at("some_rather_long_variable_name"), values.at("z")};
+    MappedExpression moved = std::move(mapped);
+    REQUIRE(moved.eval(slots).real() == ideal.real());
+    REQUIRE(moved.eval(slots).imag() == ideal.imag());
+    REQUIRE_THROWS_AS(moved.eval(std::span<const Complex>(slots).first(2)), std::invalid_argument);
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("mapped expression evaluates powers") {
+    const std::string path = (std::filesystem::temp_directory_path() / "expressionFilePowerTest.cxexpr").string();
+
+    auto expr = Subtract(Power(Variable("x"), 6), ComplexPower(Const(Complex(2, 1)), Power(Variable("x"), -1)));
+    save_expression(expr, path);
+
+    const MappedExpression mapped(path);
+    const std::vector<Complex> slots = {Complex(0.75, 1.5)};
+    const Complex ideal              = expr.eval({{"x", slots[0]}});
+    REQUIRE(mapped.eval(slots).real() == ideal.real());
+    REQUIRE(mapped.eval(slots).imag() == ideal.imag());
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("mapped expression rejects corrupt files") {
+    const std::string path  = (std::filesystem::temp_directory_path() / "expressionFileTest.corrupt").string();
+    const std::string bytes = serialize_expression(Add(Variable("x"), Const(Complex(1, 2))));
+
+    // Loading does not read the body, only verify notices a flipped bit in it.
+    std::string flipped = bytes;
+    flipped[40] ^= 1;
+    write_bytes(path, flipped);
+    const MappedExpression unverified(path);
+    REQUIRE(unverified.eval({{"x", Complex(1)}}).real() == 2);
+    REQUIRE_THROWS_AS(unverified.verify(), std::runtime_error);
+
+    // Nodes are x, 1 + 2i and their sum, evaluation rejects indices it cannot follow.
+    std::string cyclic = bytes;
+    cyclic[60]         = 2;
+    write_bytes(path, cyclic);
+    REQUIRE_THROWS_AS(MappedExpression(path).eval({{"x", Complex(1)}}), std::runtime_error);
+    REQUIRE_THROWS_AS(MappedExpression(path).verify(), std::runtime_error);
+
+    std::string constant = bytes;
+    constant[48]         = 1;
+    write_bytes(path, constant);
+    REQUIRE_THROWS_AS(MappedExpression(path).eval({{"x", Complex(1)}}), std::runtime_error);
+
+    write_bytes(path, bytes.substr(0, bytes.size() - 1));
+    REQUIRE_THROWS_AS(MappedExpression(path), std::runtime_error);
+
+    write_bytes(path, "not an expression file at all, but long enough");
+    REQUIRE_THROWS_AS(MappedExpression(path), std::runtime_error);
+
+    write_bytes(path, bytes);
+    REQUIRE(MappedExpression(path).eval({{"x", Complex(1)}}).real() == 2);
+    MappedExpression(path).verify();
+
+    std::remove(path.c_str());
+    REQUIRE_THROWS_AS(MappedExpression(path), std::system_error);
+}
+
+static void append_u32(std::string& out, std::uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out += static_cast<char>((value >> shift) & 0xFF);
+    }
+}
+
+TEST_CASE("expression view evaluates shared nodes once") {
+    // Hand-written file of x and 199 nodes that each add the previous node to itself, a tree
+    // walk would take 2^199 steps. Kind 1 is Variable and kind 2 is Add.
+    const std::uint32_t count = 200;
+    std::string bytes("CXEXPR\0\0", 8);
+    for (const std::uint32_t value : {ExpressionView::VERSION, count, 0U, 1U, 1U, 0U}) {
+        append_u32(bytes, value);
+    }
+    for (std::uint32_t id = 0; id < count; ++id) {
+        append_u32(bytes, id == 0 ? 1 : 2);
+        append_u32(bytes, id == 0 ? 0 : id - 1);
+        append_u32(bytes, id == 0 ? 0 : id - 1);
+    }
+    bytes.resize((bytes.size() + 7) / 8 * 8);
+    append_u32(bytes, 1);
+    bytes += 'x';
+
+    const ExpressionView view(reinterpret_cast<const unsigned char*>(bytes.data()), bytes.size());
+    const std::vector<Complex> slots = {Complex(1, -1)};
+    REQUIRE(view.eval(slots).real() == std::ldexp(1.0, 199));
+    REQUIRE(view.eval(slots).imag() == -std::ldexp(1.0, 199));
+}
+
+TEST_CASE("saving reports the error of the failed call") {
+    const std::string path = (std::filesystem::temp_directory_path() / "missingDirectory" / "expr.cxexpr").string();
+    try {
+        save_expression(Variable("x"), path);
+        FAIL("saving into a missing directory succeeded");
+    } catch (const std::system_error& error) {
+        REQUIRE(error.code() == std::errc::no_such_file_or_directory);
+    }
+}
+
+TEST_CASE("mapped archive holds many expressions") {
+    const std::string path = (std::filesystem::temp_directory_path() / "expressionFileTest.cxarchive").string();
+
+    const std::vector<std::shared_ptr<Expression>> expressions = {
+        std::make_shared<Add>(Variable("x"), Const(Complex(1, 2))),
+        std::make_shared<Multiply>(Variable("y"), Power(Variable("x"), 3)),
+        std::make_shared<Const>(Complex(-4, 0.5)),
+    };
+    save_archive(expressions, path);
+
+    const MappedArchive archive(path);
+    REQUIRE(archive.size() == 3);
+    archive.verify();
+    const std::unordered_map<std::string, Complex> values = {{"x", Complex(0.5, -2)}, {"y", Complex(3, 7)}};
+    for (std::size_t i = 0; i < archive.size(); ++i) {
+        const ExpressionView view = archive[i];
+        const Complex ideal       = expressions[i]->eval(values);
+        REQUIRE(view.eval(values).real() == ideal.real());
+        REQUIRE(view.eval(values).imag() == ideal.imag());
+    }
+    REQUIRE(archive[1].variable_name(1) == "x");
+    REQUIRE(archive[2].variable_count() == 0);
+    REQUIRE_THROWS_AS(archive[3], std::out_of_range);
+
+    // A 16 byte header and table entries of an offset and a size put the first
+    // expression at 64, flip the unused operand of its first node.
+    const std::string bytes = serialize_archive(expressions);
+    std::string body        = bytes;
+    body[64 + 40] ^= 1;
+    write_bytes(path, body);
+    MappedArchive flipped(path);
+    REQUIRE(flipped[0].eval(values).real() == expressions[0]->eval(values).real());
+    REQUIRE_THROWS_AS(flipped.verify(), std::runtime_error);
+
+    std::string offsets = bytes;
+    offsets[40] ^= 1;
+    write_bytes(path, offsets);
+    REQUIRE_THROWS_AS(MappedArchive(path)[1], std::runtime_error);
+
+    write_bytes(path, bytes.substr(0, 40));
+    REQUIRE_THROWS_AS(MappedArchive(path), std::runtime_error);
+    REQUIRE_THROWS_AS(MappedArchive(path + ".missing"), std::system_error);
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,106 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "expressions/expression_store.hpp"
+#include "expressions/expressions.hpp"
+#include "expressions/parser.hpp"
+
+TEST_CASE("ExpressionStore matches the class hierarchy") {
+    auto first = Multiply(Add(Const(Complex(0.8)), Const(Complex(12593))),
+                          Divide(Subtract(Variable("x"), Variable("y")), Negate(Conjugate(Variable("z")))));
+    auto second = Subtract(Variable("some_rather_long_variable_name"), Multiply(Variable("x"), Const(Complex(2, -1))));
+
+    ExpressionStore store;
+    const ExpressionId first_id  = store.add(first);
+    const ExpressionId second_id = store.add(second);
+
+    REQUIRE(store.node_count() == 16);
+    REQUIRE(store.variable_names().size() == 4);
+    REQUIRE_THAT(store.str(first_id), Catch::Matchers::Equals(first.str()));
+    REQUIRE_THAT(store.str(second_id), Catch::Matchers::Equals(second.str()));
+
+    const std::unordered_map<std::string, Complex> values = {{"x", Complex(324.6546, 1)},
+                                                             {"y", Complex(0.09832)},
+                                                             {"z", Complex(0.09832, 6534)},
+                                                             {"some_rather_long_variable_name", Complex(-7, 3)}};
+    const Complex ideal = first.eval(values);
+    REQUIRE(store.eval(first_id, values).real() == ideal.real());
+    REQUIRE(store.eval(first_id, values).imag() == ideal.imag());
+
+    std::vector<Complex> slots(store.variable_names().size());
+    for (const auto& [name, value] : values) {
+        slots[store.variable_id(name)] = value;
+    }
+    const Complex second_ideal = second.eval(values);
+    REQUIRE(store.eval(second_id, slots).real() == second_ideal.real());
+    REQUIRE(store.eval(second_id, slots).imag() == second_ideal.imag());
+
+    // The first expression reads ids 0 to 2, the second the long name with id 3.
+    const std::span<const Complex> short_slots = std::span<const Complex>(slots).first(3);
+    REQUIRE(store.eval(first_id, short_slots).real() == ideal.real());
+    REQUIRE_THROWS_AS(store.eval(second_id, short_slots), std::out_of_range);
+
+    store.clear();
+    REQUIRE(store.node_count() == 0);
+    REQUIRE_THROWS_AS(store.variable_id("x"), std::out_of_range);
+}
+
+TEST_CASE("ExpressionStore keeps powers") {
+    auto expr = Add(Power(Variable("x"), -3), ComplexPower(Variable("x"), Const(Complex(0.5, 2))));
+    ExpressionStore store;
+    const ExpressionId id = store.add(expr);
+
+    REQUIRE_THAT(store.str(id), Catch::Matchers::Equals("((x ^ -3) + (x ^ (0.5; 2)))"));
+    const std::unordered_map<std::string, Complex> values = {{"x", Complex(1.5, -0.25)}};
+    const Complex ideal                                   = expr.eval(values);
+    REQUIRE(store.eval(id, values).real() == ideal.real());
+    REQUIRE(store.eval(id, values).imag() == ideal.imag());
+}
+
+TEST_CASE("ExpressionStore copies outlive their source") {
+    auto expr = Add(Variable("some_rather_long_variable_name"), Multiply(Variable("x"), Const(Complex(2, -1))));
+
+    auto source           = std::make_unique<ExpressionStore>();
+    const ExpressionId id = source->add(expr);
+
+    ExpressionStore copy(*source);
+    ExpressionStore assigned;
+    assigned.add(Variable("y"));
+    assigned = *source;
+    source.reset();
+
+    for (const ExpressionStore* store : {&copy, &assigned}) {
+        REQUIRE(store->variable_id("some_rather_long_variable_name") == 0);
+        REQUIRE(store->variable_id("x") == 1);
+        REQUIRE_THROWS_AS(store->variable_id("y"), std::out_of_range);
+        REQUIRE_THAT(store->str(id), Catch::Matchers::Equals(expr.str()));
+    }
+}
+
+TEST_CASE("ExpressionStore parses text") {
+    const std::string text = "((exp((x * (2; -1))) - (y ^ -2)) / (cos((~x)) ^ (0.5; 0)))";
+    ExpressionStore store;
+    const ExpressionId id = store.parse(text);
+    REQUIRE_THAT(store.str(id), Catch::Matchers::Equals(text));
+    REQUIRE(store.variable_names().size() == 2);
+
+    const std::unordered_map<std::string, Complex> values = {{"x", Complex(0.5, -1.25)}, {"y", Complex(2, 3)}};
+    const Complex ideal                                   = parse_expression(text)->eval(values);
+    REQUIRE(store.eval(id, values).real() == ideal.real());
+    REQUIRE(store.eval(id, values).imag() == ideal.imag());
+
+    // A failed parse drops the nodes, constants and names it had added.
+    const std::size_t nodes = store.node_count();
+    REQUIRE_THROWS_AS(store.parse("((z + (1; 2)) * (x +"), ParseError);
+    REQUIRE(store.node_count() == nodes);
+    REQUIRE(store.variable_names().size() == 2);
+    REQUIRE_THROWS_AS(store.variable_id("z"), std::out_of_range);
+    REQUIRE_THAT(store.str(store.parse("(z + (1; 2))")), Catch::Matchers::Equals("(z + (1; 2))"));
+    REQUIRE(store.variable_id("z") == 2);
+}
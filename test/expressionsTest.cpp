@@ -1,8 +1,14 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
+#include <memory>
+#include <span>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
+#include "complex/complex_math.hpp"
 #include "expressions/expressions.hpp"
 
 void check_complex_equality(Complex test, Complex ideal) {
@@ -55,4 +61,97 @@ TEST_CASE("eval") {
     check_complex_equality(
         expr.eval({{"x", Complex(324.6546)}, {"y", Complex(0.09832)}, {"z", Complex(0.09832, 6534)}}),
         ((Complex(0.8) + Complex(12593)) * ((Complex(324.6546) - Complex(0.09832)) / (-(~Complex(0.09832, 6534))))));
-}
\ No newline at end of file
+}
+
+TEST_CASE("bound eval") {
+    auto expr = Multiply(Add(Const(Complex(0.8)), Variable("x")),
+                         Divide(Subtract(Variable("x"), Variable("y")), Negate(Conjugate(Variable("z")))));
+
+    const std::unique_ptr<Expression> bound(expr.bind({{"x", 0}, {"y", 1}, {"z", 2}}));
+    const std::vector<Complex> values = {Complex(324.6546), Complex(0.09832), Complex(0.09832, 6534)};
+
+    check_complex_equality(bound->eval(std::span<const Complex>(values)),
+                           expr.eval({{"x", values[0]}, {"y", values[1]}, {"z", values[2]}}));
+    REQUIRE_THAT(bound->str(), Catch::Matchers::Equals(expr.str()));
+
+    REQUIRE_THROWS_AS(expr.eval(std::span<const Complex>(values)), std::logic_error);
+    REQUIRE_THROWS_AS(bound->eval(std::span<const Complex>(values).first(2)), std::out_of_range);
+    REQUIRE_THROWS_AS(expr.bind({{"x", 0}}), std::out_of_range);
+}
+
+TEST_CASE("builders") {
+    const std::shared_ptr<Expression> x = make_variable("x");
+    std::vector<std::shared_ptr<Expression>> terms;
+    for (int i = 0; i < 4; ++i) {
+        terms.push_back(make_multiply(make_const(Complex(i, 1)), x));
+    }
+    const std::shared_ptr<Expression> sum = make_sum(terms);
+
+    REQUIRE_THAT(sum->str(), Catch::Matchers::Equals("(((((0; 1) * x) + ((1; 1) * x)) + ((2; 1) * x)) + ((3; 1) * x))"));
+    check_complex_equality(sum->eval({{"x", Complex(2, 3)}}), Complex(6, 4) * Complex(2, 3));
+    REQUIRE(x.use_count() == 5);
+
+    auto expr = (Variable("x") + Const(Complex(1))) * Negate(Variable("y"));
+    check_complex_equality(expr.eval({{"x", Complex(2)}, {"y", Complex(0, 1)}}), Complex(0, -3));
+    REQUIRE_THAT(expr.str(), Catch::Matchers::Equals("((x + (1; 0)) * (-y))"));
+}
+
+TEST_CASE("elementary functions") {
+    const std::shared_ptr<Expression> x = make_variable("x");
+    const std::shared_ptr<Expression> expr =
+        make_add(make_multiply(make_exp(x), make_log(x)), make_divide(make_sin(make_sqrt(x)), make_cos(x)));
+    REQUIRE_THAT(expr->str(), Catch::Matchers::Equals("((exp(x) * log(x)) + (sin(sqrt(x)) / cos(x)))"));
+
+    const Complex value(0.75, -2);
+    check_complex_equality(expr->eval({{"x", value}}), exp(value) * log(value) + sin(sqrt(value)) / cos(value));
+
+    std::ostringstream stream;
+    make_exp(make_add(x, make_const(Complex(1))))->write_to(stream);
+    REQUIRE_THAT(stream.str(), Catch::Matchers::Equals("exp((x + (1; 0)))"));
+}
+
+TEST_CASE("powers") {
+    const std::shared_ptr<Expression> x = make_variable("x");
+    const std::shared_ptr<Expression> expr =
+        make_add(make_power(x, 5), make_complex_power(make_power(x, -2), make_variable("y")));
+    REQUIRE_THAT(expr->str(), Catch::Matchers::Equals("((x ^ 5) + ((x ^ -2) ^ y))"));
+
+    const Complex value(0.75, -2);
+    const Complex exponent(0.5, 1);
+    check_complex_equality(expr->eval({{"x", value}, {"y", exponent}}),
+                           value * value * value * value * value + pow((value * value).inverse(), exponent));
+
+    const std::unique_ptr<Expression> bound(make_power(x, 3)->bind({{"x", 0}}));
+    const std::vector<Complex> values = {value};
+    check_complex_equality(bound->eval(std::span<const Complex>(values)), value * value * value);
+
+    std::ostringstream stream;
+    stream << *expr;
+    REQUIRE_THAT(stream.str(), Catch::Matchers::Equals(expr->str()));
+
+    std::ostringstream formatted;
+    formatted << std::showpos << std::hex;
+    make_power(x, 10)->write_to(formatted);
+    REQUIRE_THAT(formatted.str(), Catch::Matchers::Equals("(x ^ 10)"));
+}
+
+TEST_CASE("write_to") {
+    auto expr = Multiply(Add(Const(Complex(0.8)), Const(Complex(12593))),
+                         Divide(Subtract(Variable("x"), Variable("y")), Negate(Conjugate(Variable("z")))));
+    const std::string text = "(((0.8; 0) + (12593; 0)) * ((x - y) / (-(~z))))";
+    REQUIRE_THAT(expr.str(), Catch::Matchers::Equals(text));
+
+    std::string out = "expr = ";
+    expr.write_to(out);
+    REQUIRE_THAT(out, Catch::Matchers::Equals("expr = " + text));
+
+    std::ostringstream stream;
+    stream << expr << ';';
+    REQUIRE_THAT(stream.str(), Catch::Matchers::Equals(text + ';'));
+
+    std::shared_ptr<Expression> deep = make_variable("x");
+    for (int i = 0; i < 1000; ++i) {
+        deep = make_add(make_const(Complex(i)), std::move(deep));
+    }
+    REQUIRE(deep->str().size() == 12891);
+}
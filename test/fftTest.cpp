@@ -0,0 +1,166 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "complex/fft.hpp"
+#include "testHelpers.hpp"
+
+static std::vector<Reference> naive_dft(const std::vector<Complex>& values, FftDirection direction) {
+    const std::size_t n    = values.size();
+    const long double pi   = std::acos(-1.0L);
+    const long double sign = direction == FftDirection::Forward ? -1 : 1;
+    std::vector<Reference> result(n);
+    for (std::size_t k = 0; k < n; ++k) {
+        for (std::size_t j = 0; j < n; ++j) {
+            const long double angle = sign * 2 * pi * static_cast<long double>(j * k % n) / n;
+            result[k] += reference(values[j]) * std::polar(1.0L, angle);
+        }
+        if (direction == FftDirection::Inverse) {
+            result[k] /= static_cast<long double>(n);
+        }
+    }
+    return result;
+}
+
+// Normwise error in units of the unit roundoff.
+static long double error_units(const std::vector<Complex>& test, const std::vector<Reference>& exact) {
+    long double error = 0;
+    long double norm  = 0;
+    for (std::size_t i = 0; i < test.size(); ++i) {
+        error += std::norm(reference(test[i]) - exact[i]);
+        norm += std::norm(exact[i]);
+    }
+    return std::sqrt(error / norm) / UNIT_ROUNDOFF;
+}
+
+TEST_CASE("FFT matches the DFT") {
+    // Powers of two, mixed radices, direct odd radices and Bluestein sizes.
+    const std::size_t size = GENERATE(1, 2, 3, 4, 5, 6, 7, 8, 9, 12, 15, 16, 17, 25, 31, 37, 60, 64, 97, 128, 210,
+                                      243, 256, 462, 1000, 1009, 1024, 2048, 4096);
+    const std::vector<Complex> values = random_values(size, static_cast<std::uint32_t>(size));
+    const long double bound           = 2 * (std::log2(static_cast<long double>(size)) + 1);
+
+    const std::vector<Complex> forward = fft(values);
+    const std::vector<Complex> inverse = inverse_fft(values);
+    REQUIRE(forward.size() == size);
+    REQUIRE(error_units(forward, naive_dft(values, FftDirection::Forward)) <= bound);
+    REQUIRE(error_units(inverse, naive_dft(values, FftDirection::Inverse)) <= bound);
+
+    const std::vector<Complex> round_trip = inverse_fft(forward);
+    std::vector<Reference> exact;
+    for (const Complex& value : values) {
+        exact.emplace_back(value.real(), value.imag());
+    }
+    REQUIRE(error_units(round_trip, exact) <= 2 * bound);
+}
+
+TEST_CASE("FFT of special sequences") {
+    std::vector<Complex> impulse(8, Complex(0));
+    impulse[0] = Complex(1);
+    for (const Complex& value : fft(impulse)) {
+        check_identical(value, Complex(1));
+    }
+
+    const std::vector<Complex> constant(16, Complex(2, -1));
+    const std::vector<Complex> spectrum = fft(constant);
+    check_identical(spectrum[0], Complex(32, -16));
+    for (std::size_t i = 1; i < spectrum.size(); ++i) {
+        REQUIRE(std::abs(spectrum[i].real()) < 1e-14);
+        REQUIRE(std::abs(spectrum[i].imag()) < 1e-14);
+    }
+
+    REQUIRE(fft(std::vector<Complex>()).empty());
+    REQUIRE(inverse_fft(ComplexArray()).size() == 0);
+}
+
+TEST_CASE("FFT in place matches out of place") {
+    // One and two passes, the generic radix and Bluestein.
+    const std::size_t size                    = GENERATE(1, 4, 8, 16, 35, 101, 360);
+    const FftDirection direction              = GENERATE(FftDirection::Forward, FftDirection::Inverse);
+    const ComplexArray values                 = ComplexArray(random_values(size, 7));
+    const std::shared_ptr<const FftPlan> plan = fft_plans().plan(size);
+
+    ComplexArray out_of_place(size);
+    plan->execute(values, out_of_place, direction);
+    ComplexArray in_place = values;
+    plan->execute(in_place, in_place, direction);
+    for (std::size_t i = 0; i < size; ++i) {
+        check_identical(in_place[i], out_of_place[i]);
+    }
+}
+
+TEST_CASE("Batched FFT matches single transforms") {
+    const std::size_t size       = GENERATE(16, 12, 53);
+    const FftDirection direction = GENERATE(FftDirection::Forward, FftDirection::Inverse);
+    const std::size_t count      = 37;
+    const ComplexArray values    = ComplexArray(random_values(size * count, 8));
+    const FftPlan plan(size);
+    ThreadPool pool(3);
+
+    ComplexArray batch(size * count);
+    plan.execute_batch(pool, values, batch, direction);
+    ComplexArray in_place = values;
+    plan.execute_batch(pool, in_place, in_place, direction);
+
+    std::vector<double> scratch(plan.scratch_size());
+    ComplexArray single(size);
+    for (std::size_t transform = 0; transform < count; ++transform) {
+        const std::size_t offset = transform * size;
+        plan.execute(values.real_data() + offset, values.imag_data() + offset, single.real_data(), single.imag_data(),
+                     direction, scratch);
+        for (std::size_t i = 0; i < size; ++i) {
+            check_identical(batch[offset + i], single[i]);
+            check_identical(in_place[offset + i], single[i]);
+        }
+    }
+}
+
+TEST_CASE("FFT plan cache shares plans") {
+    FftPlanCache cache;
+    const std::shared_ptr<const FftPlan> plan = cache.plan(64);
+    REQUIRE(plan->size() == 64);
+    REQUIRE(cache.plan(64) == plan);
+    REQUIRE(cache.size() == 1);
+
+    ThreadPool pool(4);
+    std::vector<std::shared_ptr<const FftPlan>> plans(64);
+    pool.parallel_for(plans.size(), [&](std::size_t i) { plans[i] = cache.plan(100 + i % 4); });
+    for (std::size_t i = 0; i < plans.size(); ++i) {
+        REQUIRE(plans[i] == plans[i % 4]);
+        REQUIRE(plans[i]->size() == 100 + i % 4);
+    }
+    REQUIRE(cache.size() == 5);
+
+    cache.clear();
+    REQUIRE(cache.size() == 0);
+    REQUIRE(cache.plan(64) != plan);
+    const std::vector<Complex> values = random_values(64, 9);
+    ComplexArray result(64);
+    plan->execute(ComplexArray(values), result);
+    REQUIRE(result.to_vector() == fft(values));
+}
+
+TEST_CASE("FFT argument errors") {
+    REQUIRE_THROWS_AS(FftPlan(0), std::invalid_argument);
+
+    const FftPlan plan(8);
+    ComplexArray values(8);
+    ComplexArray wrong(9);
+    REQUIRE_THROWS_AS(plan.execute(values, wrong), std::invalid_argument);
+    REQUIRE_THROWS_AS(plan.execute(wrong, values), std::invalid_argument);
+
+    std::vector<double> scratch(plan.scratch_size() - 1);
+    REQUIRE_THROWS_AS(plan.execute(values.real_data(), values.imag_data(), values.real_data(), values.imag_data(),
+                                   FftDirection::Forward, scratch),
+                      std::invalid_argument);
+
+    ThreadPool pool(2);
+    REQUIRE_THROWS_AS(plan.execute_batch(pool, ComplexArray(20), wrong), std::invalid_argument);
+    REQUIRE_THROWS_AS(plan.execute_batch(pool, ComplexArray(16), wrong), std::invalid_argument);
+}
@@ -0,0 +1,165 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "expressions/compiled_expression.hpp"
+#include "expressions/expressions.hpp"
+#include "expressions/gradient.hpp"
+
+static void check_close(Complex test, Complex ideal, double tolerance) {
+    REQUIRE(std::abs(test.real() - ideal.real()) <= tolerance * (1 + std::abs(ideal.real())));
+    REQUIRE(std::abs(test.imag() - ideal.imag()) <= tolerance * (1 + std::abs(ideal.imag())));
+}
+
+TEST_CASE("gradient of a known function") {
+    // f = x * y + conj(x) / z - (-y) * y
+    const auto x = make_variable("x");
+    const auto y = make_variable("y");
+    const auto z = make_variable("z");
+    const auto f = make_subtract(make_add(make_multiply(x, y), make_divide(make_conjugate(x), z)),
+                                 make_multiply(make_negate(y), y));
+
+    const GradientTape tape(*f, {{"x", 0}, {"y", 1}, {"z", 2}});
+    REQUIRE(tape.slot_count() == 3);
+    REQUIRE(tape.node_count() == 13);
+
+    const std::vector<Complex> values = {Complex(1, 2), Complex(-0.5, 3), Complex(2, -1)};
+    std::vector<Complex> d_dz(3);
+    std::vector<Complex> d_dconj(3);
+    const Complex value = tape.gradient(values, d_dz, d_dconj);
+
+    const Complex vx = values[0];
+    const Complex vy = values[1];
+    const Complex vz = values[2];
+    check_close(value, f->eval({{"x", vx}, {"y", vy}, {"z", vz}}), 1e-15);
+    check_close(d_dz[0], vy, 1e-15);
+    check_close(d_dconj[0], Complex(1) / vz, 1e-15);
+    check_close(d_dz[1], vx + Complex(2) * vy, 1e-15);
+    check_close(d_dconj[1], Complex(), 0);
+    check_close(d_dz[2], -(~vx) / (vz * vz), 1e-15);
+    check_close(d_dconj[2], Complex(), 0);
+
+    std::vector<Complex> short_span(2);
+    REQUIRE_THROWS_AS(tape.gradient(values, short_span, d_dconj), std::invalid_argument);
+    REQUIRE_THROWS_AS(tape.gradient(std::span<const Complex>(values).first(2), d_dz, d_dconj),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(GradientTape(*f, {{"x", 0}, {"y", 1}}), std::out_of_range);
+}
+
+TEST_CASE("gradient matches finite differences") {
+    std::mt19937 generator(5);
+    std::uniform_real_distribution<double> distribution(0.5, 2);
+    const auto random_complex = [&] { return Complex(distribution(generator), distribution(generator)); };
+
+    const auto a = make_variable("a");
+    const auto b = make_variable("b");
+    const auto f = make_divide(
+        make_multiply(make_conjugate(make_multiply(a, b)), make_add(a, make_const(Complex(1, 1)))),
+        make_subtract(make_negate(make_conjugate(b)), make_multiply(a, a)));
+    const GradientTape tape(*f, {{"a", 0}, {"b", 1}});
+
+    for (int sample = 0; sample < 20; ++sample) {
+        const std::vector<Complex> values = {random_complex(), random_complex()};
+        std::vector<Complex> d_dz(2);
+        std::vector<Complex> d_dconj(2);
+        tape.gradient(values, d_dz, d_dconj);
+
+        const double h = 1e-6;
+        for (std::size_t slot = 0; slot < 2; ++slot) {
+            const auto eval_shifted = [&](const Complex& shift) {
+                std::vector<Complex> shifted = values;
+                shifted[slot] += shift;
+                return f->eval({{"a", shifted[0]}, {"b", shifted[1]}});
+            };
+            // df = df/dz * dz + df/dconj(z) * conj(dz) along the real and the imaginary axis.
+            const Complex along_real = (eval_shifted(Complex(h)) - eval_shifted(Complex(-h))) / Complex(2 * h);
+            const Complex along_imag = (eval_shifted(Complex(0, h)) - eval_shifted(Complex(0, -h))) / Complex(2 * h);
+            check_close(d_dz[slot] + d_dconj[slot], along_real, 1e-6);
+            check_close((d_dz[slot] - d_dconj[slot]) * Complex(0, 1), along_imag, 1e-6);
+        }
+    }
+}
+
+TEST_CASE("gradient of elementary functions and powers matches finite differences") {
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> distribution(0.5, 2);
+    const auto random_complex = [&] { return Complex(distribution(generator), distribution(generator)); };
+
+    const auto a = make_variable("a");
+    const auto b = make_variable("b");
+    const auto f = make_add(make_multiply(make_exp(make_sin(a)), make_log(b)),
+                            make_divide(make_cos(make_multiply(a, b)), make_sqrt(make_conjugate(b))));
+    const auto g = make_subtract(make_power(make_add(a, b), 5), make_complex_power(a, make_power(b, -2)));
+    const auto function = GENERATE_COPY(f, g);
+    const GradientTape tape(*function, {{"a", 0}, {"b", 1}});
+
+    for (int sample = 0; sample < 20; ++sample) {
+        const std::vector<Complex> values = {random_complex(), random_complex()};
+        std::vector<Complex> d_dz(2);
+        std::vector<Complex> d_dconj(2);
+        tape.gradient(values, d_dz, d_dconj);
+
+        const double h = 1e-6;
+        for (std::size_t slot = 0; slot < 2; ++slot) {
+            const auto eval_shifted = [&](const Complex& shift) {
+                std::vector<Complex> shifted = values;
+                shifted[slot] += shift;
+                return function->eval({{"a", shifted[0]}, {"b", shifted[1]}});
+            };
+            const Complex along_real = (eval_shifted(Complex(h)) - eval_shifted(Complex(-h))) / Complex(2 * h);
+            const Complex along_imag = (eval_shifted(Complex(0, h)) - eval_shifted(Complex(0, -h))) / Complex(2 * h);
+            check_close(d_dz[slot] + d_dconj[slot], along_real, 1e-6);
+            check_close((d_dz[slot] - d_dconj[slot]) * Complex(0, 1), along_imag, 1e-6);
+        }
+    }
+}
+
+TEST_CASE("gradient batch") {
+    const auto x = make_variable("x");
+    const auto y = make_variable("y");
+    const auto f = make_multiply(make_conjugate(x), make_add(x, y));
+    const GradientTape tape(*f, {{"x", 0}, {"y", 1}});
+
+    const std::size_t rows = 100;
+    std::vector<double> input(4 * rows);
+    for (std::size_t i = 0; i < input.size(); ++i) {
+        input[i] = std::sin(static_cast<double>(i));
+    }
+    const std::vector<ComplexColumn> columns = {{input.data(), input.data() + rows},
+                                                {input.data() + 2 * rows, input.data() + 3 * rows}};
+
+    std::vector<double> output(10 * rows);
+    const MutableComplexColumn out = {output.data(), output.data() + rows};
+    const std::vector<MutableComplexColumn> d_dz = {{output.data() + 2 * rows, output.data() + 3 * rows},
+                                                    {output.data() + 4 * rows, output.data() + 5 * rows}};
+    const std::vector<MutableComplexColumn> d_dconj = {{output.data() + 6 * rows, output.data() + 7 * rows},
+                                                       {nullptr, nullptr}};
+    tape.gradient_batch(columns, rows, out, d_dz, d_dconj);
+
+    for (std::size_t row = 0; row < rows; ++row) {
+        const std::vector<Complex> values = {Complex(columns[0].real[row], columns[0].imag[row]),
+                                             Complex(columns[1].real[row], columns[1].imag[row])};
+        std::vector<Complex> row_d_dz(2);
+        std::vector<Complex> row_d_dconj(2);
+        const Complex value = tape.gradient(values, row_d_dz, row_d_dconj);
+        REQUIRE(out.real[row] == value.real());
+        REQUIRE(out.imag[row] == value.imag());
+        for (std::size_t slot = 0; slot < 2; ++slot) {
+            REQUIRE(d_dz[slot].real[row] == row_d_dz[slot].real());
+            REQUIRE(d_dz[slot].imag[row] == row_d_dz[slot].imag());
+        }
+        REQUIRE(d_dconj[0].real[row] == row_d_dconj[0].real());
+        REQUIRE(d_dconj[0].imag[row] == row_d_dconj[0].imag());
+        check_close(row_d_dz[0], ~values[0], 1e-15);
+        check_close(row_d_dconj[0], values[0] + values[1], 1e-15);
+    }
+
+    const std::span<const ComplexColumn> short_columns = std::span<const ComplexColumn>(columns).first(1);
+    REQUIRE_THROWS_AS(tape.gradient_batch(short_columns, rows, out, d_dz, d_dconj), std::invalid_argument);
+}
@@ -0,0 +1,80 @@
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "expressions/expressions.hpp"
+#include "expressions/incremental_evaluator.hpp"
+#include "testHelpers.hpp"
+
+TEST_CASE("incremental evaluator follows updates") {
+    auto expr = Multiply(Add(Const(Complex(0.8)), Variable("x")),
+                         Divide(Subtract(Variable("x"), Variable("y")), Negate(Conjugate(Variable("z")))));
+    std::unordered_map<std::string, Complex> values = {
+        {"x", Complex(324.6546)}, {"y", Complex(0.09832)}, {"z", Complex(0.09832, 6534)}};
+
+    IncrementalEvaluator evaluator(expr, values);
+    REQUIRE(evaluator.node_count() == 11);
+    check_identical(evaluator.value(), expr.eval(values));
+    REQUIRE(evaluator.recomputed_nodes() == 0);
+
+    values["y"] = Complex(-3, 2);
+    evaluator.update("y", values["y"]);
+    check_identical(evaluator.value(), expr.eval(values));
+    REQUIRE(evaluator.recomputed_nodes() == 3);
+
+    values["x"] = Complex(1, 1);
+    values["z"] = Complex(2, -5);
+    evaluator.update("x", values["x"]);
+    evaluator.update("z", values["z"]);
+    check_identical(evaluator.value(), expr.eval(values));
+    REQUIRE(evaluator.recomputed_nodes() == 6);
+
+    REQUIRE_THROWS_AS(evaluator.update("w", Complex(1)), std::out_of_range);
+    REQUIRE_THROWS_AS(IncrementalEvaluator(expr, {{"x", Complex(1)}}), std::out_of_range);
+}
+
+TEST_CASE("incremental evaluator recomputes powers") {
+    auto expr = Multiply(Power(Variable("x"), 9), ComplexPower(Variable("y"), Variable("x")));
+    std::unordered_map<std::string, Complex> values = {{"x", Complex(1.25, -0.5)}, {"y", Complex(2, 3)}};
+
+    IncrementalEvaluator evaluator(expr, values);
+    check_identical(evaluator.value(), expr.eval(values));
+
+    values["y"] = Complex(-1, 0.5);
+    evaluator.update("y", values["y"]);
+    check_identical(evaluator.value(), expr.eval(values));
+    REQUIRE(evaluator.recomputed_nodes() == 2);
+}
+
+TEST_CASE("incremental evaluator on a large expression") {
+    std::mt19937 generator(3);
+    std::uniform_real_distribution<double> distribution(-2, 2);
+
+    std::unordered_map<std::string, Complex> values;
+    std::vector<std::shared_ptr<Expression>> terms;
+    for (int i = 0; i < 64; ++i) {
+        const std::string name = "v" + std::to_string(i);
+        values[name]           = Complex(distribution(generator), distribution(generator));
+        terms.push_back(make_multiply(make_variable(name), make_const(Complex(i, 1))));
+    }
+    while (terms.size() > 1) {
+        std::vector<std::shared_ptr<Expression>> next;
+        for (std::size_t i = 0; i + 1 < terms.size(); i += 2) {
+            next.push_back(i % 4 == 0 ? make_add(terms[i], terms[i + 1]) : make_subtract(terms[i], terms[i + 1]));
+        }
+        terms = std::move(next);
+    }
+
+    IncrementalEvaluator evaluator(*terms[0], values);
+    for (int tick = 0; tick < 200; ++tick) {
+        const std::string name = "v" + std::to_string(generator() % 64);
+        values[name]           = Complex(distribution(generator), distribution(generator));
+        evaluator.update(name, values[name]);
+        check_identical(evaluator.value(), terms[0]->eval(values));
+        REQUIRE(evaluator.recomputed_nodes() == 7);
+    }
+}
@@ -0,0 +1,132 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "expressions/expressions.hpp"
+#include "expressions/native_expression.hpp"
+#include "testHelpers.hpp"
+
+// Both paths reject too few values the same way, the generated code does not check them.
+static void check_short_input(const NativeExpression& native) {
+    REQUIRE(native.slot_count() == 2);
+    const std::vector<double> parts(4);
+    const std::vector<ComplexColumn> columns = {{parts.data(), parts.data() + 2}};
+    std::vector<double> out(4);
+    REQUIRE_THROWS_AS(native.eval(std::vector<Complex>{Complex(1)}), std::out_of_range);
+    REQUIRE_THROWS_AS(native.eval_batch(columns, 2, {out.data(), out.data() + 2}), std::out_of_range);
+}
+
+static void check_expression(const NativeExpression& native, const Expression& expr) {
+    const std::vector<Complex> rows = {Complex(324.6546, 1), Complex(0.09832, -2), Complex(0.09832, 6534),
+                                       Complex(-7, 3),       Complex(1e-300, 1e300), Complex(),
+                                       Complex(std::numeric_limits<double>::infinity(), 1)};
+    std::vector<double> real(2 * rows.size());
+    std::vector<double> imag(2 * rows.size());
+    for (std::size_t row = 0; row < rows.size(); ++row) {
+        const Complex y         = rows[(row + 3) % rows.size()];
+        real[row]               = rows[row].real();
+        imag[row]               = rows[row].imag();
+        real[rows.size() + row] = y.real();
+        imag[rows.size() + row] = y.imag();
+    }
+    const std::vector<ComplexColumn> columns = {{real.data(), imag.data()},
+                                                {real.data() + rows.size(), imag.data() + rows.size()}};
+    std::vector<double> out_real(rows.size());
+    std::vector<double> out_imag(rows.size());
+    native.eval_batch(columns, rows.size(), {out_real.data(), out_imag.data()});
+
+    for (std::size_t row = 0; row < rows.size(); ++row) {
+        const std::vector<Complex> values = {rows[row], rows[(row + 3) % rows.size()]};
+        const Complex ideal               = expr.eval({{"x", values[0]}, {"y", values[1]}});
+        check_identical(native.eval(values), ideal);
+        check_identical(Complex(out_real[row], out_imag[row]), ideal);
+    }
+}
+
+TEST_CASE("native expression matches eval") {
+    const std::filesystem::path cache = std::filesystem::temp_directory_path() / "nativeExpressionTest";
+    std::filesystem::remove_all(cache);
+    NativeOptions options;
+    options.cache_directory = cache;
+
+    auto expr = Multiply(Add(Const(Complex(0.1, -1.0 / 3)), Variable("x")),
+                         Divide(Subtract(Variable("x"), Variable("y")), Negate(Conjugate(Variable("y")))));
+    const VariableSlots slots = {{"x", 0}, {"y", 1}};
+
+    const NativeExpression native(expr, slots, options);
+    REQUIRE(native.is_native());
+    check_expression(native, expr);
+    check_short_input(native);
+    REQUIRE(std::distance(std::filesystem::directory_iterator(cache), std::filesystem::directory_iterator()) == 1);
+
+    // The second instance loads the cached library.
+    const NativeExpression cached(expr, slots, options);
+    REQUIRE(cached.is_native());
+    check_expression(cached, expr);
+    REQUIRE(std::distance(std::filesystem::directory_iterator(cache), std::filesystem::directory_iterator()) == 1);
+    REQUIRE(std::filesystem::status(cache).permissions() == std::filesystem::perms::owner_all);
+
+    std::filesystem::remove_all(cache);
+}
+
+TEST_CASE("native expression only loads private libraries") {
+    const std::filesystem::path cache = std::filesystem::temp_directory_path() / "nativeExpressionTestPrivate";
+    std::filesystem::remove_all(cache);
+    NativeOptions options;
+    options.cache_directory = cache;
+
+    auto expr                 = Add(Variable("x"), Const(Complex(1, 2)));
+    const VariableSlots slots = {{"x", 0}};
+    REQUIRE(NativeExpression(expr, slots, options).is_native());
+    const std::filesystem::path library = std::filesystem::directory_iterator(cache)->path();
+
+    // Others could replace a group-writable library or any file in a shared directory.
+    std::filesystem::permissions(library, std::filesystem::perms::group_write, std::filesystem::perm_options::add);
+    const NativeExpression writable_library(expr, slots, options);
+    REQUIRE_FALSE(writable_library.is_native());
+    check_expression(writable_library, expr);
+
+    std::filesystem::permissions(library, std::filesystem::perms::owner_all, std::filesystem::perm_options::replace);
+    REQUIRE(NativeExpression(expr, slots, options).is_native());
+    std::filesystem::permissions(cache, std::filesystem::perms::all, std::filesystem::perm_options::replace);
+    REQUIRE_FALSE(NativeExpression(expr, slots, options).is_native());
+
+    std::filesystem::remove_all(cache);
+}
+
+TEST_CASE("native expression falls back without a compiler") {
+    NativeOptions options;
+    options.compiler        = "/nonexistent/compiler";
+    options.cache_directory = std::filesystem::temp_directory_path() / "nativeExpressionTestFallback";
+
+    auto expr = Divide(Variable("y"), Subtract(Variable("x"), Const(Complex(2, 2))));
+    const NativeExpression native(expr, {{"x", 0}, {"y", 1}}, options);
+    REQUIRE_FALSE(native.is_native());
+    check_expression(native, expr);
+    check_short_input(native);
+
+    std::filesystem::remove_all(options.cache_directory);
+}
+
+TEST_CASE("native source") {
+    const std::string source = NativeExpression::generate_source(Add(Variable("x"), Const(Complex(1))), {{"x", 3}});
+    REQUIRE_THAT(source, Catch::Matchers::Contains("const Complex n0 = load(3);"));
+    REQUIRE_THAT(source, Catch::Matchers::Contains(
+                             "const Complex n1 = Complex(std::bit_cast<double>(UINT64_C(0x3ff0000000000000)), "
+                             "std::bit_cast<double>(UINT64_C(0x0)));"));
+    REQUIRE_THAT(source, Catch::Matchers::Contains("const Complex n2 = n0 + n1;"));
+
+    const std::string functions = NativeExpression::generate_source(Exp(Negate(Variable("x"))), {{"x", 0}});
+    REQUIRE_THAT(functions, Catch::Matchers::Contains("const Complex n1 = -(n0);"));
+    REQUIRE_THAT(functions, Catch::Matchers::Contains("const Complex n2 = exp(n1);"));
+
+    const std::string powers =
+        NativeExpression::generate_source(ComplexPower(Power(Variable("x"), -3), Variable("x")), {{"x", 0}});
+    REQUIRE_THAT(powers, Catch::Matchers::Contains("const Complex n1 = pow(n0, INT32_C(-3));"));
+    REQUIRE_THAT(powers, Catch::Matchers::Contains("const Complex n3 = pow(n1, n2);"));
+}
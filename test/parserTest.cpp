@@ -0,0 +1,94 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+
+#include "expressions/expressions.hpp"
+#include "expressions/parser.hpp"
+
+TEST_CASE("parse round trips str") {
+    auto expr = Multiply(Add(Const(Complex(0.8)), Const(Complex(12593))),
+                         Divide(Subtract(Variable("x"), Variable("y")),
+                                Negate(static_cast<const Expression&>(Conjugate(Variable("z"))))));
+    const std::string text = expr.str();
+    REQUIRE_THAT(text, Catch::Matchers::Equals("(((0.8; 0) + (12593; 0)) * ((x - y) / (-(~z))))"));
+
+    const std::shared_ptr<Expression> parsed = parse_expression(text);
+    REQUIRE_THAT(parsed->str(), Catch::Matchers::Equals(text));
+
+    const std::unordered_map<std::string, Complex> values = {
+        {"x", Complex(324.6546)}, {"y", Complex(0.09832)}, {"z", Complex(0.09832, 6534)}};
+    REQUIRE(parsed->eval(values).real() == expr.eval(values).real());
+    REQUIRE(parsed->eval(values).imag() == expr.eval(values).imag());
+
+    const std::string others[] = {"x",
+                                  "(-1; -2.5)",
+                                  "(-(-1; 0))",
+                                  "(-x)",
+                                  "((-1e+10; 3e-07) - some_rather_long_variable_name)",
+                                  "((inf; -inf) * (~(x / (2; 0))))",
+                                  "(2 - y)",
+                                  "exp((log(x) * sqrt((-1; 0))))",
+                                  "(sin(x) / cos((~y)))",
+                                  "((x ^ 3) - (x ^ -2147483648))",
+                                  "(x ^ (0.5; 0))",
+                                  "((x ^ y) ^ 3x)"};
+    for (const std::string& other : others) {
+        REQUIRE_THAT(parse_expression(other)->str(), Catch::Matchers::Equals(other));
+    }
+    REQUIRE_THAT(parse_expression(" ( x  +(1;2) ) ")->str(), Catch::Matchers::Equals("(x + (1; 2))"));
+    REQUIRE(std::isnan(parse_expression("(nan; 0)")->eval(std::span<const Complex>()).real()));
+}
+
+TEST_CASE("parse reports error positions") {
+    const auto position = [](const std::string& text) -> std::size_t {
+        try {
+            parse_expression(text);
+        } catch (const ParseError& error) {
+            return error.position();
+        }
+        return std::numeric_limits<std::size_t>::max();
+    };
+
+    REQUIRE(position("") == 0);
+    REQUIRE(position("(x + y") == 6);
+    REQUIRE(position("(x % y)") == 3);
+    REQUIRE(position("(1; z)") == 4);
+    REQUIRE(position("(x + y))") == 7);
+    REQUIRE(position("()") == 1);
+    REQUIRE(position("(1 + tan(x))") == 5);
+    REQUIRE(position("exp(x y)") == 6);
+    REQUIRE(position("(x ^ 2147483648)") == 5);
+    REQUIRE(position("(x ^ 2 3)") == 7);
+    REQUIRE(position("(1e400; 1e-400)") == 1);
+    REQUIRE(position("(1; -1e-400)") == 4);
+    REQUIRE_THROWS_WITH(parse_expression("tan(x)"), "unknown function tan at position 0");
+    REQUIRE_THROWS_WITH(parse_expression("(x + y"), "expected ')' at position 6");
+    REQUIRE_THROWS_WITH(parse_expression("(1e400; 0)"), "number out of range at position 1");
+}
+
+TEST_CASE("parse limits the nesting depth") {
+    const auto nested = [](std::size_t depth) {
+        return std::string(depth - 1, '(') + "x" + std::string(depth - 1, ')');
+    };
+    const auto negated = [](std::size_t depth) {
+        std::string text;
+        for (std::size_t i = 1; i < depth; ++i) {
+            text += "(-";
+        }
+        return text + "x" + std::string(depth - 1, ')');
+    };
+
+    // An odd number of negations around x.
+    const std::unordered_map<std::string, Complex> values = {{"x", Complex(2, 1)}};
+    REQUIRE(parse_expression(negated(MAX_PARSE_DEPTH))->eval(values).real() == -2);
+    REQUIRE_THROWS_WITH(parse_expression(negated(MAX_PARSE_DEPTH + 1)),
+                        "expression nested too deeply at position " + std::to_string(2 * MAX_PARSE_DEPTH));
+    // Brackets around a single operand are not valid, but would recurse just as deep.
+    REQUIRE_THROWS_WITH(parse_expression(nested(100000)),
+                        "expression nested too deeply at position " + std::to_string(MAX_PARSE_DEPTH));
+}
@@ -0,0 +1,45 @@
+#include <catch2/catch_test_macros.hpp>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "expressions/expressions.hpp"
+#include "expressions/parser.hpp"
+#include "expressions/polynomial_expansion.hpp"
+#include "testHelpers.hpp"
+
+TEST_CASE("expand_polynomial multiplies out sums and products") {
+    const Polynomial polynomial = expand_polynomial(*parse_expression("(((x + (1; 0)) * (x - (2; 1))) ^ 2)"), "x");
+    const Polynomial factor({Complex(1), Complex(1)});
+    const Polynomial other({Complex(-2, -1), Complex(1)});
+    REQUIRE(polynomial.coefficients() == (factor * other * factor * other).coefficients());
+    REQUIRE(polynomial.degree() == 4);
+
+    const auto expr = parse_expression("((((-x) * (3; 0)) / (2; 0)) + ((x ^ 3) - (x * x)))");
+
+    const Polynomial expanded                             = expand_polynomial(*expr, "x");
+    const std::unordered_map<std::string, Complex> values = {{"x", Complex(0.5, -1.5)}};
+    REQUIRE(expanded.coefficients() == std::vector<Complex>{Complex(0), Complex(-1.5), Complex(-1), Complex(1)});
+    check_identical(expanded(Complex(0.5, -1.5)), expr->eval(values));
+}
+
+TEST_CASE("expand_polynomial folds constant subexpressions") {
+    const auto x = make_variable("x");
+    const auto c = make_add(make_exp(make_const(Complex(1))), make_power(make_const(Complex(2)), -1));
+    const Polynomial polynomial = expand_polynomial(*make_multiply(x, c), "x");
+    REQUIRE(polynomial.coefficients().size() == 2);
+    check_identical(polynomial.coefficients()[1], c->eval(std::unordered_map<std::string, Complex>()));
+    REQUIRE(expand_polynomial(*make_subtract(x, x), "x").coefficients().empty());
+    REQUIRE(expand_polynomial(*make_power(x, 0), "x").coefficients() == std::vector<Complex>{Complex(1)});
+}
+
+TEST_CASE("expand_polynomial rejects other expressions") {
+    const auto x = make_variable("x");
+    REQUIRE_THROWS_AS(expand_polynomial(*make_add(x, make_variable("y")), "x"), std::invalid_argument);
+    REQUIRE_THROWS_AS(expand_polynomial(*make_divide(make_const(Complex(1)), x), "x"), std::invalid_argument);
+    REQUIRE_THROWS_AS(expand_polynomial(*make_exp(x), "x"), std::invalid_argument);
+    REQUIRE_THROWS_AS(expand_polynomial(*make_conjugate(x), "x"), std::invalid_argument);
+    REQUIRE_THROWS_AS(expand_polynomial(*make_power(x, -2), "x"), std::invalid_argument);
+    REQUIRE_THROWS_AS(expand_polynomial(*make_complex_power(x, make_const(Complex(2))), "x"), std::invalid_argument);
+}
@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "complex/polynomial.hpp"
+#include "testHelpers.hpp"
+
+// sum |c_k| |z|^k, which bounds the rounding errors of evaluating p(z).
+static long double magnitude(const Polynomial& polynomial, Complex z) {
+    long double sum = 0;
+    for (std::size_t k = polynomial.coefficients().size(); k-- > 0;) {
+        sum = sum * z.abs() + polynomial.coefficients()[k].abs();
+    }
+    return sum;
+}
+
+// |p(z)| relative to the magnitude, in long double.
+static long double relative_residual(const Polynomial& polynomial, Complex z) {
+    const Reference point(z.real(), z.imag());
+    Reference value = 0;
+    for (std::size_t k = polynomial.coefficients().size(); k-- > 0;) {
+        const Complex coefficient = polynomial.coefficients()[k];
+        value                     = value * point + reference(coefficient);
+    }
+    return std::abs(value) / magnitude(polynomial, z);
+}
+
+// Product of (z - root) over the roots.
+static Polynomial from_roots(const std::vector<Complex>& roots) {
+    Polynomial product({Complex(1)});
+    for (const Complex& root : roots) {
+        product *= Polynomial({-root, Complex(1)});
+    }
+    return product;
+}
+
+static double distance_to_nearest(const std::vector<Complex>& points, Complex z) {
+    double distance = INFINITY;
+    for (const Complex& point : points) {
+        distance = std::min(distance, (point - z).abs());
+    }
+    return distance;
+}
+
+TEST_CASE("Polynomial coefficients and arithmetic") {
+    const Polynomial zero({Complex(0), Complex(0)});
+    REQUIRE(zero.coefficients().empty());
+    REQUIRE(zero.degree() == 0);
+    REQUIRE(zero.is_constant());
+    check_identical(zero(Complex(3, 4)), Complex(0));
+
+    const Polynomial x({Complex(0), Complex(1), Complex(0)});
+    REQUIRE(x.degree() == 1);
+    REQUIRE(!x.is_constant());
+
+    const Polynomial one({Complex(1)});
+    const Polynomial square = (x + one) * (x - one);
+    REQUIRE(square.coefficients() == std::vector<Complex>{Complex(-1), Complex(0), Complex(1)});
+    REQUIRE((square - x * x + one).coefficients().empty());
+    REQUIRE((-square).coefficients() == std::vector<Complex>{Complex(1), Complex(0), Complex(-1)});
+    REQUIRE((x * zero).coefficients().empty());
+
+    const Polynomial cubic({Complex(1, 1), Complex(2), Complex(0, -3), Complex(4)});
+    REQUIRE(cubic.derivative().coefficients() == std::vector<Complex>{Complex(2), Complex(0, -6), Complex(12)});
+    REQUIRE(one.derivative().coefficients().empty());
+    check_identical(cubic(Complex(0.5, -2)),
+                    ((Complex(4) * Complex(0.5, -2) + Complex(0, -3)) * Complex(0.5, -2) + Complex(2)) *
+                            Complex(0.5, -2) +
+                        Complex(1, 1));
+}
+
+TEST_CASE("Polynomial planes evaluate like the scalar Horner rule") {
+    const std::size_t count = GENERATE(1, 2, 3, 8, 37, 300);
+    const Polynomial polynomial(random_values(count, 1, static_cast<std::uint32_t>(count)));
+    const std::vector<Complex> points = random_values(1000, 1.2, 1);
+
+    const std::vector<Complex> horner = polynomial.eval(ComplexArray(points)).to_vector();
+    const std::vector<Complex> estrin = polynomial.eval(ComplexArray(points), PolynomialScheme::Estrin).to_vector();
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        check_identical(horner[i], polynomial(points[i]));
+        const Reference difference(horner[i].real() - estrin[i].real(), horner[i].imag() - estrin[i].imag());
+        REQUIRE(std::abs(difference) <= 8 * count * UNIT_ROUNDOFF * magnitude(polynomial, points[i]));
+    }
+
+    // The output may alias the points, the pool splits them into blocks.
+    ComplexArray in_place(points);
+    polynomial.eval_planes(in_place.size(), in_place.real_data(), in_place.imag_data(), in_place.real_data(),
+                           in_place.imag_data(), PolynomialScheme::Estrin);
+    ThreadPool pool(3);
+    const std::vector<Complex> parallel = polynomial.eval(pool, ComplexArray(random_values(9000, 1.2, 1))).to_vector();
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        check_identical(in_place[i], estrin[i]);
+        check_identical(parallel[i], horner[i]);
+    }
+}
+
+TEST_CASE("Polynomial roots of unity") {
+    const std::size_t degree = GENERATE(1, 2, 5, 64, 333);
+    std::vector<Complex> coefficients(degree + 1, Complex(0));
+    coefficients[0]      = Complex(-1);
+    coefficients[degree] = Complex(1);
+    const std::vector<Complex> roots = Polynomial(coefficients).roots();
+
+    REQUIRE(roots.size() == degree);
+    for (std::size_t k = 0; k < degree; ++k) {
+        const double angle = 2 * std::acos(-1.0) * static_cast<double>(k) / static_cast<double>(degree);
+        REQUIRE(distance_to_nearest(roots, Complex(std::cos(angle), std::sin(angle))) < 1e-13);
+    }
+}
+
+TEST_CASE("Polynomial roots of a product of linear factors") {
+    std::vector<Complex> exact;
+    for (int k = 0; k < 20; ++k) {
+        exact.push_back(Complex(std::cos(k), std::sin(k)) * (0.25 * (k + 1)));
+    }
+    exact.push_back(Complex(0));
+    exact.push_back(Complex(0));
+    exact.push_back(Complex(3, -1));
+    exact.push_back(Complex(3, -1));
+    const Polynomial polynomial = from_roots(exact);
+
+    const std::vector<Complex> roots = polynomial.roots();
+    REQUIRE(roots.size() == exact.size());
+    REQUIRE(std::count(roots.begin(), roots.end(), Complex(0)) == 2);
+    for (const Complex& root : exact) {
+        // The double root is only determined to about the square root of the rounding error.
+        REQUIRE(distance_to_nearest(roots, root) < (root == Complex(3, -1) ? 1e-6 : 1e-9));
+    }
+}
+
+TEST_CASE("Polynomial roots in parallel") {
+    const Polynomial polynomial(random_values(601, 1, 2));
+    ThreadPool pool(4);
+    const std::vector<Complex> parallel = polynomial.roots(pool);
+    const std::vector<Complex> serial   = polynomial.roots();
+
+    REQUIRE(parallel.size() == 600);
+    for (std::size_t i = 0; i < parallel.size(); ++i) {
+        check_identical(parallel[i], serial[i]);
+        REQUIRE(relative_residual(polynomial, parallel[i]) < 1e3L * UNIT_ROUNDOFF);
+    }
+
+    // Coefficients far apart in magnitude put the roots on several circles.
+    std::vector<Complex> coefficients = random_values(201, 1, 3);
+    for (std::size_t k = 0; k < coefficients.size(); ++k) {
+        coefficients[k] *= std::pow(10.0, k < 100 ? 50.0 : -50.0);
+    }
+    const Polynomial spread(coefficients);
+    for (const Complex& root : spread.roots(pool)) {
+        REQUIRE(relative_residual(spread, root) < 1e3L * UNIT_ROUNDOFF);
+    }
+}
+
+TEST_CASE("Polynomial roots errors") {
+    REQUIRE_THROWS_AS(Polynomial().roots(), std::invalid_argument);
+    REQUIRE(Polynomial({Complex(2)}).roots().empty());
+    const std::vector<Complex> roots = Polynomial({Complex(0), Complex(0), Complex(0, 2)}).roots();
+    REQUIRE(roots.size() == 2);
+    check_identical(roots[0], Complex(0));
+    check_identical(roots[1], Complex(0));
+}
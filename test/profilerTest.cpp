@@ -0,0 +1,73 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+#include <cmath>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+#include "expressions/expressions.hpp"
+#include "expressions/profiler.hpp"
+
+TEST_CASE("profiler counts calls and special values") {
+    auto expr = Add(Divide(Variable("x"), Subtract(Variable("y"), Const(Complex(1)))), Const(Complex(2, 1)));
+    ExpressionProfiler profiler(expr);
+
+    std::unordered_map<std::string, Complex> values = {{"x", Complex(3, 4)}, {"y", Complex(2)}};
+    const Complex ideal = expr.eval(values);
+    const Complex value = profiler.eval(values);
+    REQUIRE(value.real() == ideal.real());
+    REQUIRE(value.imag() == ideal.imag());
+
+    values["y"] = Complex(1);
+    profiler.eval(values);
+    values["y"] = Complex(1 + 1e-14);
+    profiler.eval(values);
+
+    const auto& profiles = profiler.profiles();
+    REQUIRE(profiles.size() == 7);
+    for (const NodeProfile& profile : profiles) {
+        REQUIRE(profile.calls == 3);
+    }
+    REQUIRE(profiles[4].near_zero_divisions == 2);
+    REQUIRE(profiles[4].non_finite_results == 1);
+    REQUIRE(profiles[6].non_finite_results == 1);
+    REQUIRE(profiles[6].nanoseconds >= profiles[4].nanoseconds);
+
+    // Numbers are replaced, the shape has to be the one of str.
+    const std::string annotated = std::regex_replace(profiler.annotated(), std::regex("ns=[0-9]+"), "ns=T");
+    REQUIRE_THAT(annotated, Catch::Matchers::Equals(
+                                "((x[calls=3 ns=T] / (y[calls=3 ns=T] - (1; 0)[calls=3 ns=T])[calls=3 ns=T])"
+                                "[calls=3 ns=T near_zero=2 non_finite=1] + (2; 1)[calls=3 ns=T])"
+                                "[calls=3 ns=T non_finite=1]"));
+
+    const std::string folded = std::regex_replace(profiler.folded_stacks(), std::regex(" [0-9]+\n"), "\n");
+    REQUIRE_THAT(folded, Catch::Matchers::Equals("Add\n"
+                                                 "Add;Divide\n"
+                                                 "Add;Divide;x\n"
+                                                 "Add;Divide;Subtract\n"
+                                                 "Add;Divide;Subtract;y\n"
+                                                 "Add;Divide;Subtract;const\n"
+                                                 "Add;const\n"));
+
+    profiler.reset();
+    REQUIRE(profiler.profiles()[6].calls == 0);
+}
+
+TEST_CASE("profiler writes powers") {
+    auto expr = ComplexPower(Power(Variable("x"), 3), Const(Complex(0.5)));
+    ExpressionProfiler profiler(expr);
+    const std::unordered_map<std::string, Complex> values = {{"x", Complex(1, 2)}};
+    const Complex ideal                                   = expr.eval(values);
+    REQUIRE(profiler.eval(values).real() == ideal.real());
+    REQUIRE(profiler.eval(values).imag() == ideal.imag());
+
+    const std::string annotated = std::regex_replace(profiler.annotated(), std::regex("\\[[^\\]]*\\]"), "");
+    REQUIRE_THAT(annotated, Catch::Matchers::Equals(expr.str()));
+
+    const std::string folded = std::regex_replace(profiler.folded_stacks(), std::regex(" [0-9]+\n"), "\n");
+    REQUIRE_THAT(folded, Catch::Matchers::Equals("ComplexPower\n"
+                                                 "ComplexPower;Power\n"
+                                                 "ComplexPower;Power;x\n"
+                                                 "ComplexPower;const\n"));
+}
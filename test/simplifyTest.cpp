@@ -0,0 +1,95 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+#include "expressions/expressions.hpp"
+#include "expressions/simplify.hpp"
+
+TEST_CASE("simplify folds constants") {
+    auto expr = Multiply(Add(Const(Complex(0.8)), Const(Complex(12593))),
+                         Divide(Subtract(Variable("x"), Variable("y")), Negate(Conjugate(Const(Complex(1, 2))))));
+
+    const SimplifyResult result = simplify(expr);
+
+    REQUIRE_THAT(result.expression->str(), Catch::Matchers::Equals("((12593.8; 0) * ((x - y) / (-1; 2)))"));
+    REQUIRE(result.removed_nodes == 4);
+
+    const std::unordered_map<std::string, Complex> values = {{"x", Complex(3, 4)}, {"y", Complex(-1, 0.5)}};
+    const Complex ideal                                   = expr.eval(values);
+    const Complex test                                    = result.expression->eval(values);
+    REQUIRE(test.real() == ideal.real());
+    REQUIRE(test.imag() == ideal.imag());
+}
+
+TEST_CASE("simplify folds and keeps elementary functions") {
+    const auto x = make_variable("x");
+    REQUIRE_THAT(simplify(*make_exp(make_exp(x))).expression->str(), Catch::Matchers::Equals("exp(exp(x))"));
+
+    const SimplifyResult folded = simplify(*make_add(x, make_sqrt(make_const(Complex(-4, 0)))));
+    REQUIRE_THAT(folded.expression->str(), Catch::Matchers::Equals("(x + (0; 2))"));
+    REQUIRE(folded.removed_nodes == 1);
+}
+
+TEST_CASE("simplify rewrites products of equal factors into powers") {
+    const auto x   = make_variable("x");
+    const auto sum = make_add(x, make_variable("y"));
+    // ((x + y) * (x + y)) * (((x + y) * (x + y)) * (x + y)) with separate copies of the sum.
+    const auto copy    = [] { return make_add(make_variable("x"), make_variable("y")); };
+    const auto square  = make_multiply(copy(), copy());
+    const auto product = make_multiply(square, make_multiply(make_multiply(copy(), copy()), sum));
+
+    REQUIRE_THAT(simplify(*product).expression->str(), Catch::Matchers::Equals(product->str()));
+
+    const SimplifyResult result = simplify(*product, {.min_power_factors = 4});
+    REQUIRE_THAT(result.expression->str(), Catch::Matchers::Equals("((x + y) ^ 5)"));
+    REQUIRE(result.removed_nodes == 15);
+
+    const SimplifyResult short_chain = simplify(*make_multiply(square, x), {.min_power_factors = 4});
+    REQUIRE_THAT(short_chain.expression->str(), Catch::Matchers::Equals("(((x + y) * (x + y)) * x)"));
+
+    const auto powers = make_multiply(make_power(x, 3), make_power(x, 2));
+    REQUIRE_THAT(simplify(*powers, {.min_power_factors = 4}).expression->str(), Catch::Matchers::Equals("(x ^ 5)"));
+
+    REQUIRE_THAT(simplify(*make_power(make_const(Complex(0, 1)), 2)).expression->str(),
+                 Catch::Matchers::Equals("(-1; 0)"));
+    REQUIRE_THAT(simplify(*make_power(x, 1)).expression->str(), Catch::Matchers::Equals("x"));
+}
+
+TEST_CASE("simplify removes exact identities") {
+    // Casts keep Negate(Negate(x)) from resolving to the copy constructor.
+    const Conjugate conjugated(Subtract(Variable("x"), Const(Complex(0, 0))));
+    const Negate negated(static_cast<const Expression&>(Conjugate(static_cast<const Expression&>(conjugated))));
+    const Negate expr(static_cast<const Expression&>(negated));
+
+    const SimplifyResult result = simplify(expr);
+
+    REQUIRE_THAT(result.expression->str(), Catch::Matchers::Equals("x"));
+    REQUIRE(result.removed_nodes == 6);
+
+    auto negative_zero = Add(Const(Complex(-0.0, -0.0)), Variable("x"));
+    REQUIRE_THAT(simplify(negative_zero).expression->str(), Catch::Matchers::Equals("x"));
+}
+
+TEST_CASE("simplify keeps identities that are inexact for non-finite values") {
+    auto expr = Divide(Multiply(Variable("x"), Const(Complex(1))), Const(Complex(1)));
+
+    SECTION("By default") {
+        const SimplifyResult result = simplify(expr);
+
+        REQUIRE_THAT(result.expression->str(), Catch::Matchers::Equals("((x * (1; 0)) / (1; 0))"));
+        REQUIRE(result.removed_nodes == 0);
+
+        const Complex infinite(std::numeric_limits<double>::infinity(), 0);
+        REQUIRE(std::isnan(result.expression->eval({{"x", infinite}}).imag()));
+    }
+
+    SECTION("Assuming finite values") {
+        const SimplifyResult result = simplify(Add(expr, Const(Complex(0))), {.assume_finite = true});
+
+        REQUIRE_THAT(result.expression->str(), Catch::Matchers::Equals("x"));
+        REQUIRE(result.removed_nodes == 6);
+    }
+}
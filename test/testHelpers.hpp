@@ -0,0 +1,58 @@
+#ifndef TEST_TEST_HELPERS_HPP
+#define TEST_TEST_HELPERS_HPP
+
+#include <bit>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "complex/complex.hpp"
+
+// Extended precision for reference results, errors are measured in units of the double
+// rounding UNIT_ROUNDOFF.
+using Reference = std::complex<long double>;
+
+inline constexpr long double UNIT_ROUNDOFF = 0x1p-53L;
+
+inline Reference reference(const Complex& number) {
+    return Reference(number.real(), number.imag());
+}
+
+// Requires the same bits in both parts, so signed zeros have to match as well. NaN parts
+// only require a NaN, whose payload is not specified.
+inline void check_identical(Complex test, Complex ideal) {
+    if (std::isnan(ideal.real()) || std::isnan(ideal.imag())) {
+        REQUIRE(std::isnan(test.real()) == std::isnan(ideal.real()));
+        REQUIRE(std::isnan(test.imag()) == std::isnan(ideal.imag()));
+        return;
+    }
+    REQUIRE(std::bit_cast<std::uint64_t>(test.real()) == std::bit_cast<std::uint64_t>(ideal.real()));
+    REQUIRE(std::bit_cast<std::uint64_t>(test.imag()) == std::bit_cast<std::uint64_t>(ideal.imag()));
+}
+
+// Uniformly distributed parts in [-real_bound, real_bound] and [-imag_bound, imag_bound].
+inline std::vector<Complex> random_values(std::size_t size, double real_bound, double imag_bound,
+                                          std::uint32_t seed) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> real(-real_bound, real_bound);
+    std::uniform_real_distribution<double> imag(-imag_bound, imag_bound);
+    std::vector<Complex> values;
+    for (std::size_t i = 0; i < size; ++i) {
+        values.emplace_back(real(generator), imag(generator));
+    }
+    return values;
+}
+
+inline std::vector<Complex> random_values(std::size_t size, double bound, std::uint32_t seed) {
+    return random_values(size, bound, bound, seed);
+}
+
+inline std::vector<Complex> random_values(std::size_t size, std::uint32_t seed) {
+    return random_values(size, 1, seed);
+}
+
+#endif  // TEST_TEST_HELPERS_HPP
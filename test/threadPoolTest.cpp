@@ -0,0 +1,56 @@
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <stdexcept>
+#include <vector>
+
+#include "complex/thread_pool.hpp"
+
+TEST_CASE("ThreadPool runs every task once") {
+    const std::size_t threads = GENERATE(1, 2, 7);
+    ThreadPool pool(threads);
+    REQUIRE(pool.size() == threads);
+
+    SECTION("Many tasks") {
+        std::vector<std::atomic<int>> runs(10007);
+        pool.parallel_for(runs.size(), [&](std::size_t i) { ++runs[i]; });
+        for (const auto& count : runs) {
+            REQUIRE(count == 1);
+        }
+    }
+
+    SECTION("Consecutive jobs") {
+        std::atomic<std::size_t> sum = 0;
+        for (std::size_t job = 0; job < 50; ++job) {
+            pool.parallel_for(job, [&](std::size_t i) { sum += i; });
+        }
+        std::size_t ideal = 0;
+        for (std::size_t job = 1; job < 50; ++job) {
+            ideal += job * (job - 1) / 2;
+        }
+        REQUIRE(sum == ideal);
+    }
+
+    SECTION("Nested jobs run inline") {
+        std::vector<std::atomic<int>> runs(20 * 30);
+        pool.parallel_for(20, [&](std::size_t outer) {
+            pool.parallel_for(30, [&](std::size_t inner) { ++runs[outer * 30 + inner]; });
+        });
+        for (const auto& count : runs) {
+            REQUIRE(count == 1);
+        }
+    }
+
+    SECTION("Exceptions reach the caller") {
+        REQUIRE_THROWS_AS(pool.parallel_for(100,
+                                            [](std::size_t i) {
+                                                if (i == 42) {
+                                                    throw std::runtime_error("task failed");
+                                                }
+                                            }),
+                          std::runtime_error);
+        std::atomic<int> runs = 0;
+        pool.parallel_for(10, [&](std::size_t) { ++runs; });
+        REQUIRE(runs == 10);
+    }
+}